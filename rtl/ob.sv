@@ -41,11 +41,25 @@ module ob (
   , output logic                                  cmd_full_r
 
   // ======================================================================== //
-  // Response Interface
+  // Response (Acknowledgement) Interface
   , input                                         rsp_accept
   //
-  , output logic                                  rsp_vld
-  , output ob_pkg::rsp_t                          rsp
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0]     rsp_vld
+  , output ob_pkg::rsp_t [cfg_pkg::RSP_LANES_N - 1:0] rsp
+
+  // ======================================================================== //
+  // Trade Interface
+  , input                                         trd_accept
+  //
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0]     trd_vld
+  , output ob_pkg::rsp_t [cfg_pkg::RSP_LANES_N - 1:0] trd
+
+  // ======================================================================== //
+  // Market Data (Top-of-Book) Interface
+  , input                                         md_accept
+  //
+  , output logic                                  md_vld_r
+  , output ob_pkg::md_t                           md_r
 
   // ======================================================================== //
   // Clk/Reset
@@ -53,15 +67,30 @@ module ob (
   , input                                         rst
 );
 
+  // Upper bound on the trades emitted by a single command; each trade consumes
+  // at least one table entry.
+  localparam int TRD_SWEEP_N = cfg_pkg::BID_TABLE_DEPTH_N +
+                               cfg_pkg::ASK_TABLE_DEPTH_N +
+                               cfg_pkg::MARKET_BID_DEPTH_N +
+                               cfg_pkg::MARKET_ASK_DEPTH_N;
+
   // ------------------------------------------------------------------------ //
   //
   logic                                 cmd_in_vld;
   ob_pkg::cmd_t                         cmd_in;
+  ob_pkg::ts_t                          cmd_in_ts;
   logic                                 cmd_in_pop;
+  logic                                 cmd_in_byp_rdy;
+  logic                                 ingress_byp;
   //
-  logic                                 rsp_out_full_r;
+  logic                                 ack_out_full_r;
+  logic                                 trd_out_full_r;
+  logic                                 trd_out_room_r;
   logic                                 rsp_out_vld_r;
   ob_pkg::rsp_t                         rsp_out_r;
+  logic                                 ack_push;
+  logic                                 trd_push;
+  logic                                 md_commit;
   //
   logic                                 lm_bid_table_vld_r;
   ob_pkg::table_t                       lm_bid_table_r;
@@ -77,12 +106,20 @@ module ob (
   ob_pkg::table_t                       lm_bid_cancel_hit_tbl_w;
   logic                                 lm_bid_cancel;
   ob_pkg::uid_t                         lm_bid_cancel_uid;
+  logic                                 lm_bid_amend;
+  ob_pkg::table_t                       lm_bid_amend_tbl;
+  logic                                 lm_bid_amend_hit_w;
+  logic                                 lm_bid_amend_inplace_w;
   logic                                 lm_bid_qry_rsp_vld_r;
   logic                                 lm_bid_qry_rsp_is_ge_r;
   ob_pkg::accum_quantity_t              lm_bid_qry_rsp_qty_r;
   logic                                 lm_bid_qry_vld;
   bcd_pkg::price_t                      lm_bid_qry_price;
   ob_pkg::quantity_t                    lm_bid_qry_quantity;
+  ob_pkg::table_idx_t                   lm_bid_rd_idx;
+  logic                                 lm_bid_rd_vld_w;
+  ob_pkg::table_t                       lm_bid_rd_tbl_w;
+  logic                                 lm_bid_full_r;
   //
   logic                                 lm_ask_table_vld_r;
   ob_pkg::table_t                       lm_ask_table_r;
@@ -98,12 +135,20 @@ module ob (
   ob_pkg::table_t                       lm_ask_cancel_hit_tbl_w;
   logic                                 lm_ask_cancel;
   ob_pkg::uid_t                         lm_ask_cancel_uid;
+  logic                                 lm_ask_amend;
+  ob_pkg::table_t                       lm_ask_amend_tbl;
+  logic                                 lm_ask_amend_hit_w;
+  logic                                 lm_ask_amend_inplace_w;
   logic                                 lm_ask_qry_rsp_vld_r;
   logic                                 lm_ask_qry_rsp_is_ge_r;
   ob_pkg::accum_quantity_t              lm_ask_qry_rsp_qty_r;
   logic                                 lm_ask_qry_vld;
   bcd_pkg::price_t                      lm_ask_qry_price;
   ob_pkg::quantity_t                    lm_ask_qry_quantity;
+  ob_pkg::table_idx_t                   lm_ask_rd_idx;
+  logic                                 lm_ask_rd_vld_w;
+  ob_pkg::table_t                       lm_ask_rd_tbl_w;
+  logic                                 lm_ask_full_r;
   //
   logic                                 mk_bid_head_pop;
   logic                                 mk_bid_head_push;
@@ -124,6 +169,9 @@ module ob (
   logic                                 mk_bid_qry_vld;
   logic                                 mk_bid_qry_rsp_vld_r;
   ob_pkg::accum_quantity_t              mk_bid_qry_rsp_qty_r;
+  ob_pkg::snap_idx_t                    mk_bid_rd_idx;
+  logic                                 mk_bid_rd_vld_w;
+  ob_pkg::table_t                       mk_bid_rd_tbl_w;
   //
   logic                                 mk_ask_head_pop;
   logic                                 mk_ask_head_push;
@@ -144,6 +192,9 @@ module ob (
   logic                                 mk_ask_qry_vld;
   logic                                 mk_ask_qry_rsp_vld_r;
   ob_pkg::accum_quantity_t              mk_ask_qry_rsp_qty_r;
+  ob_pkg::snap_idx_t                    mk_ask_rd_idx;
+  logic                                 mk_ask_rd_vld_w;
+  ob_pkg::table_t                       mk_ask_rd_tbl_w;
   //
   logic                                 cn_cmd_vld;
   ob_pkg::cmd_t                         cn_cmd_r;
@@ -153,7 +204,13 @@ module ob (
   ob_pkg::uid_t                         cn_cancel_uid;
   logic                                 cn_mtr_vld_r;
   ob_pkg::cmd_t                         cn_mtr_r;
-  logic                                 cn_full_r;
+  logic                                 cn_buy_full_r;
+  logic                                 cn_sell_full_r;
+  ob_pkg::snap_idx_t                    cn_rd_idx;
+  logic                                 cn_buy_rd_vld_w;
+  ob_pkg::cmd_t                         cn_buy_rd_cmd_w;
+  logic                                 cn_sell_rd_vld_w;
+  ob_pkg::cmd_t                         cn_sell_rd_cmd_w;
   //
   logic                                 cntrl_evt_texe_r;
   bcd_pkg::price_t                      cntrl_evt_texe_ask_r;
@@ -161,29 +218,53 @@ module ob (
 
   // ------------------------------------------------------------------------ //
   //
-  `LIBV_QUEUE_WIRES(ingress_queue_, ob_pkg::cmd_t);
+  `LIBV_REG_RST(ob_pkg::ts_t, ts, '0);
+
+  always_comb begin : ts_PROC
+
+    // Free-running cycle timestamp; held at zero when disabled.
+    ts_w = cfg_pkg::RSP_TIMESTAMP_EN ? (ts_r + 'b1) : '0;
+
+  end // block: ts_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  `LIBV_QUEUE_WIRES(ingress_queue_, ob_pkg::ingress_t);
   `LIBV_REG_RST_R(logic, ingress_queue_empty, 'b1);
   `LIBV_REG_RST_R(logic, ingress_queue_full, 'b0);
 
-  `LIBV_QUEUE_WIRES(egress_queue_, ob_pkg::rsp_t);
-  `LIBV_REG_RST_R(logic, egress_queue_empty, 'b0);
-  `LIBV_REG_RST_R(logic, egress_queue_full, 'b1);
-
   always_comb begin : in_PROC
 
+    // Bypass: when the ingress queue is empty and the controller is idle, the
+    // inbound command is forwarded directly to the controller's command latch
+    // and is not enqueued. The bypass qualification is derived solely from
+    // flopped state therefore the queue push (and thereby cmd_full_r) carries
+    // no combinational dependency upon the controller. Otherwise, the queue
+    // acts as a skid buffer for commands arriving whilst the controller is
+    // busy.
+    //
+    ingress_byp             =   cfg_pkg::INGRESS_BYPASS_EN
+                              & cmd_vld_r
+                              & ingress_queue_empty_r
+                              & cmd_in_byp_rdy;
+
     // -> OB interface
-    ingress_queue_push      = cmd_vld_r;
-    ingress_queue_push_data = cmd_r;
+    ingress_queue_push      = cmd_vld_r & (~ingress_byp);
+    ingress_queue_push_data     = '0;
+`ifdef OB_CFG_RSP_TIMESTAMP_EN
+    ingress_queue_push_data.ts  = ts_r;
+`endif
+    ingress_queue_push_data.cmd = cmd_r;
 
     ingress_queue_flush     = 'b0;
-    ingress_queue_commit    = cmd_in_pop;
+    ingress_queue_commit    = cmd_in_pop & (~ingress_byp);
     ingress_queue_replay    = 'b0;
 
     cmd_full_r              = ingress_queue_full_r;
 
   end // block: in_PROC
 
-  libv_queue #(.W($bits(ob_pkg::cmd_t)), .N(4)) u_ingress_queue (
+  libv_queue #(.W($bits(ob_pkg::ingress_t)), .N(4)) u_ingress_queue (
     //
       .push                   (ingress_queue_push      )
     , .push_data              (ingress_queue_push_data )
@@ -224,6 +305,12 @@ module ob (
     , .cancel_hit_w           (lm_bid_cancel_hit_w       )
     , .cancel_hit_tbl_w       (lm_bid_cancel_hit_tbl_w   )
     //
+    , .amend                  (lm_bid_amend              )
+    , .amend_tbl              (lm_bid_amend_tbl          )
+    //
+    , .amend_hit_w            (lm_bid_amend_hit_w        )
+    , .amend_inplace_w        (lm_bid_amend_inplace_w    )
+    //
     , .reject_pop             (lm_bid_reject_pop         )
     , .reject_vld_r           (lm_bid_reject_vld_r       )
     , .reject_r               (lm_bid_reject_r           )
@@ -236,6 +323,12 @@ module ob (
     , .qry_rsp_is_ge_r        (lm_bid_qry_rsp_is_ge_r    )
     , .qry_rsp_qty_r          (lm_bid_qry_rsp_qty_r      )
     //
+    , .rd_idx                 (lm_bid_rd_idx             )
+    , .rd_vld_w               (lm_bid_rd_vld_w           )
+    , .rd_tbl_w               (lm_bid_rd_tbl_w           )
+    //
+    , .full_r                 (lm_bid_full_r             )
+    //
     , .clk                    (clk                       )
     , .rst                    (rst                       )
   );
@@ -262,6 +355,12 @@ module ob (
     , .cancel_hit_w           (lm_ask_cancel_hit_w       )
     , .cancel_hit_tbl_w       (lm_ask_cancel_hit_tbl_w   )
     //
+    , .amend                  (lm_ask_amend              )
+    , .amend_tbl              (lm_ask_amend_tbl          )
+    //
+    , .amend_hit_w            (lm_ask_amend_hit_w        )
+    , .amend_inplace_w        (lm_ask_amend_inplace_w    )
+    //
     , .reject_pop             (lm_ask_reject_pop         )
     , .reject_vld_r           (lm_ask_reject_vld_r       )
     , .reject_r               (lm_ask_reject_r           )
@@ -274,20 +373,27 @@ module ob (
     , .qry_rsp_is_ge_r        (lm_ask_qry_rsp_is_ge_r    )
     , .qry_rsp_qty_r          (lm_ask_qry_rsp_qty_r      )
     //
+    , .rd_idx                 (lm_ask_rd_idx             )
+    , .rd_vld_w               (lm_ask_rd_vld_w           )
+    , .rd_tbl_w               (lm_ask_rd_tbl_w           )
+    //
+    , .full_r                 (lm_ask_full_r             )
+    //
     , .clk                    (clk                       )
     , .rst                    (rst                       )
   );
 
   always_comb begin : ob_cntrl_PROC
 
-    // Ingress Queue -> Ob. Cntrl.
-    cmd_in_vld             = (~ingress_queue_empty_r);
-    cmd_in                 = ingress_queue_pop_data;
-    ingress_queue_pop      = cmd_in_pop;
-
-    // Ob. Cntrl. -> Egress Queue
-    egress_queue_push      = rsp_out_vld_r;
-    egress_queue_push_data = rsp_out_r;
+    // Ingress Queue (or Bypass) -> Ob. Cntrl.
+    cmd_in_vld             = ingress_byp | (~ingress_queue_empty_r);
+    cmd_in                 = ingress_byp ? cmd_r : ingress_queue_pop_data.cmd;
+`ifdef OB_CFG_RSP_TIMESTAMP_EN
+    cmd_in_ts              = ingress_byp ? ts_r : ingress_queue_pop_data.ts;
+`else
+    cmd_in_ts              = '0;
+`endif
+    ingress_queue_pop      = cmd_in_pop & (~ingress_byp);
 
   end // block: ob_cntrl_PROC
 
@@ -297,9 +403,13 @@ module ob (
     //
       .cmd_in_vld                  (cmd_in_vld                   )
     , .cmd_in                      (cmd_in                       )
+    , .cmd_in_ts                   (cmd_in_ts                    )
     , .cmd_in_pop                  (cmd_in_pop                   )
+    , .cmd_in_byp_rdy              (cmd_in_byp_rdy               )
     //
-    , .rsp_out_full_r              (rsp_out_full_r               )
+    , .ack_out_full_r              (ack_out_full_r               )
+    , .trd_out_full_r              (trd_out_full_r               )
+    , .trd_out_room_r              (trd_out_room_r               )
     , .rsp_out_vld_r               (rsp_out_vld_r                )
     , .rsp_out_r                   (rsp_out_r                    )
     //
@@ -321,12 +431,20 @@ module ob (
     , .lm_bid_update               (lm_bid_update                )
     , .lm_bid_cancel               (lm_bid_cancel                )
     , .lm_bid_cancel_uid           (lm_bid_cancel_uid            )
+    , .lm_bid_amend_hit_w          (lm_bid_amend_hit_w           )
+    , .lm_bid_amend_inplace_w      (lm_bid_amend_inplace_w       )
+    , .lm_bid_amend                (lm_bid_amend                 )
+    , .lm_bid_amend_tbl            (lm_bid_amend_tbl             )
     , .lm_bid_qry_rsp_vld_r        (lm_bid_qry_rsp_vld_r         )
     , .lm_bid_qry_rsp_is_ge_r      (lm_bid_qry_rsp_is_ge_r       )
     , .lm_bid_qry_rsp_qty_r        (lm_bid_qry_rsp_qty_r         )
     , .lm_bid_qry_vld              (lm_bid_qry_vld               )
     , .lm_bid_qry_price            (lm_bid_qry_price             )
     , .lm_bid_qry_quantity         (lm_bid_qry_quantity          )
+    , .lm_bid_rd_idx               (lm_bid_rd_idx                )
+    , .lm_bid_rd_vld_w             (lm_bid_rd_vld_w              )
+    , .lm_bid_rd_tbl_w             (lm_bid_rd_tbl_w              )
+    , .lm_bid_full_r               (lm_bid_full_r                )
     //
     , .lm_ask_table_vld_r          (lm_ask_table_vld_r           )
     , .lm_ask_table_r              (lm_ask_table_r               )
@@ -342,12 +460,20 @@ module ob (
     , .lm_ask_update               (lm_ask_update                )
     , .lm_ask_cancel               (lm_ask_cancel                )
     , .lm_ask_cancel_uid           (lm_ask_cancel_uid            )
+    , .lm_ask_amend_hit_w          (lm_ask_amend_hit_w           )
+    , .lm_ask_amend_inplace_w      (lm_ask_amend_inplace_w       )
+    , .lm_ask_amend                (lm_ask_amend                 )
+    , .lm_ask_amend_tbl            (lm_ask_amend_tbl             )
     , .lm_ask_qry_rsp_vld_r        (lm_ask_qry_rsp_vld_r         )
     , .lm_ask_qry_rsp_is_ge_r      (lm_ask_qry_rsp_is_ge_r       )
     , .lm_ask_qry_rsp_qty_r        (lm_ask_qry_rsp_qty_r         )
     , .lm_ask_qry_vld              (lm_ask_qry_vld               )
     , .lm_ask_qry_price            (lm_ask_qry_price             )
     , .lm_ask_qry_quantity         (lm_ask_qry_quantity          )
+    , .lm_ask_rd_idx               (lm_ask_rd_idx                )
+    , .lm_ask_rd_vld_w             (lm_ask_rd_vld_w              )
+    , .lm_ask_rd_tbl_w             (lm_ask_rd_tbl_w              )
+    , .lm_ask_full_r               (lm_ask_full_r                )
     //
     , .mk_bid_head_pop             (mk_bid_head_pop              )
     , .mk_bid_head_push            (mk_bid_head_push             )
@@ -368,6 +494,9 @@ module ob (
     , .mk_bid_qry_vld              (mk_bid_qry_vld               )
     , .mk_bid_qry_rsp_vld_r        (mk_bid_qry_rsp_vld_r         )
     , .mk_bid_qry_rsp_qty_r        (mk_bid_qry_rsp_qty_r         )
+    , .mk_bid_rd_idx               (mk_bid_rd_idx                )
+    , .mk_bid_rd_vld_w             (mk_bid_rd_vld_w              )
+    , .mk_bid_rd_tbl_w             (mk_bid_rd_tbl_w              )
     //
     , .mk_ask_head_pop             (mk_ask_head_pop              )
     , .mk_ask_head_push            (mk_ask_head_push             )
@@ -388,6 +517,9 @@ module ob (
     , .mk_ask_qry_vld              (mk_ask_qry_vld               )
     , .mk_ask_qry_rsp_vld_r        (mk_ask_qry_rsp_vld_r         )
     , .mk_ask_qry_rsp_qty_r        (mk_ask_qry_rsp_qty_r         )
+    , .mk_ask_rd_idx               (mk_ask_rd_idx                )
+    , .mk_ask_rd_vld_w             (mk_ask_rd_vld_w              )
+    , .mk_ask_rd_tbl_w             (mk_ask_rd_tbl_w              )
     //
     , .cn_cmd_vld                  (cn_cmd_vld                   )
     , .cn_cmd_r                    (cn_cmd_r                     )
@@ -397,7 +529,17 @@ module ob (
     , .cn_cancel_uid               (cn_cancel_uid                )
     , .cn_mtr_vld_r                (cn_mtr_vld_r                 )
     , .cn_mtr_r                    (cn_mtr_r                     )
-    , .cn_full_r                   (cn_full_r                    )
+    , .cn_buy_full_r               (cn_buy_full_r                )
+    , .cn_sell_full_r              (cn_sell_full_r               )
+    , .cn_rd_idx                   (cn_rd_idx                    )
+    , .cn_buy_rd_vld_w             (cn_buy_rd_vld_w              )
+    , .cn_buy_rd_cmd_w             (cn_buy_rd_cmd_w              )
+    , .cn_sell_rd_vld_w            (cn_sell_rd_vld_w             )
+    , .cn_sell_rd_cmd_w            (cn_sell_rd_cmd_w             )
+    //
+    , .md_commit                   (md_commit                    )
+    //
+    , .ts_r                        (ts_r                         )
     //
     , .clk                         (clk                          )
     , .rst                         (rst                          )
@@ -434,6 +576,10 @@ module ob (
     , .qry_rsp_vld_r               (mk_bid_qry_rsp_vld_r         )
     , .qry_rsp_qty_r               (mk_bid_qry_rsp_qty_r         )
     //
+    , .rd_idx                      (mk_bid_rd_idx                )
+    , .rd_vld_w                    (mk_bid_rd_vld_w              )
+    , .rd_tbl_w                    (mk_bid_rd_tbl_w              )
+    //
     , .clk                         (clk                          )
     , .rst                         (rst                          )
   );
@@ -469,6 +615,10 @@ module ob (
     , .qry_rsp_vld_r               (mk_ask_qry_rsp_vld_r         )
     , .qry_rsp_qty_r               (mk_ask_qry_rsp_qty_r         )
     //
+    , .rd_idx                      (mk_ask_rd_idx                )
+    , .rd_vld_w                    (mk_ask_rd_vld_w              )
+    , .rd_tbl_w                    (mk_ask_rd_tbl_w              )
+    //
     , .clk                         (clk                          )
     , .rst                         (rst                          )
   );
@@ -492,7 +642,14 @@ module ob (
     , .cancel                      (cn_cancel                    )
     , .cancel_uid                  (cn_cancel_uid                )
     //
-    , .full_r                      (cn_full_r                    )
+    , .buy_full_r                  (cn_buy_full_r                )
+    , .sell_full_r                 (cn_sell_full_r               )
+    //
+    , .rd_idx                      (cn_rd_idx                    )
+    , .buy_rd_vld_w                (cn_buy_rd_vld_w              )
+    , .buy_rd_cmd_w                (cn_buy_rd_cmd_w              )
+    , .sell_rd_vld_w               (cn_sell_rd_vld_w             )
+    , .sell_rd_cmd_w               (cn_sell_rd_cmd_w             )
     //
     , .clk                         (clk                          )
     , .rst                         (rst                          )
@@ -500,37 +657,74 @@ module ob (
 
   // ------------------------------------------------------------------------ //
   //
-  always_comb begin : out_PROC
+  always_comb begin : egress_PROC
 
-    rsp_vld             = (~egress_queue_empty_r);
-    rsp                 = egress_queue_pop_data;
+    // Trades carry no originator ID and are routed to the trade channel;
+    // all other responses are acknowledgements of a command.
+    trd_push = rsp_out_vld_r & (rsp_out_r.uid == '1);
+    ack_push = rsp_out_vld_r & (rsp_out_r.uid != '1);
 
-    egress_queue_pop    = (rsp_vld & rsp_accept);
-    egress_queue_commit = egress_queue_pop;
-    egress_queue_flush  = 'b0;
-    egress_queue_replay = 'b0;
+  end // block: egress_PROC
 
-    rsp_out_full_r      = egress_queue_full_r;
+  // ------------------------------------------------------------------------ //
+  //
+  ob_egress #(
+      .N(cfg_pkg::ACK_EGRESS_DEPTH_N)
+    , .W(cfg_pkg::RSP_LANES_N)
+  ) u_ob_egress_ack (
+    //
+      .push                        (ack_push                     )
+    , .push_data                   (rsp_out_r                    )
+    , .full_r                      (ack_out_full_r               )
+    , .room_r                      (                             )
+    //
+    , .rsp_accept                  (rsp_accept                   )
+    , .rsp_vld                     (rsp_vld                      )
+    , .rsp                         (rsp                          )
+    //
+    , .clk                         (clk                          )
+    , .rst                         (rst                          )
+  );
 
-  end // block: out_PROC
+  // ------------------------------------------------------------------------ //
+  //
+  ob_egress #(
+      .N(cfg_pkg::TRD_EGRESS_DEPTH_N)
+    , .W(cfg_pkg::RSP_LANES_N)
+    , .R(TRD_SWEEP_N)
+  ) u_ob_egress_trd (
+    //
+      .push                        (trd_push                     )
+    , .push_data                   (rsp_out_r                    )
+    , .full_r                      (trd_out_full_r               )
+    , .room_r                      (trd_out_room_r               )
+    //
+    , .rsp_accept                  (trd_accept                   )
+    , .rsp_vld                     (trd_vld                      )
+    , .rsp                         (trd                          )
+    //
+    , .clk                         (clk                          )
+    , .rst                         (rst                          )
+  );
 
-  libv_queue #(.W($bits(ob_pkg::rsp_t)), .N(4)) u_egress_queue (
+  // ------------------------------------------------------------------------ //
+  //
+  ob_md u_ob_md (
     //
-      .push              (egress_queue_push       )
-    , .push_data         (egress_queue_push_data  )
+      .lm_bid_table_vld_r          (lm_bid_table_vld_r           )
+    , .lm_bid_table_r              (lm_bid_table_r               )
     //
-    , .pop               (egress_queue_pop        )
-    , .pop_data          (egress_queue_pop_data   )
+    , .lm_ask_table_vld_r          (lm_ask_table_vld_r           )
+    , .lm_ask_table_r              (lm_ask_table_r               )
     //
-    , .flush             (egress_queue_flush      )
-    , .commit            (egress_queue_commit     )
-    , .replay            (egress_queue_replay     )
+    , .commit                      (md_commit                    )
     //
-    , .empty_w           (egress_queue_empty_w    )
-    , .full_w            (egress_queue_full_w     )
+    , .md_accept                   (md_accept                    )
+    , .md_vld_r                    (md_vld_r                     )
+    , .md_r                        (md_r                         )
     //
-    , .clk               (clk                     )
-    , .rst               (rst                     )
+    , .clk                         (clk                          )
+    , .rst                         (rst                          )
   );
 
 endmodule // ob
@@ -0,0 +1,259 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+`default_nettype none
+`timescale 1ns/1ps
+
+`include "ob_pkg.vh"
+`include "bcd_pkg.vh"
+`include "macros_pkg.vh"
+
+module ob_cn_side_table #(parameter int N = 64, parameter bit is_buy = 'b1) (
+
+  // ======================================================================== //
+  // Head Status
+    input                                         head_pop
+  //
+  , output logic                                  head_vld_r
+  , output ob_pkg::cmd_t                          head_r
+
+  // ======================================================================== //
+  // Insert Interface
+  , input                                         insert
+  , input ob_pkg::cmd_t                           insert_cmd
+
+  // ======================================================================== //
+  // Cancel UID Interface
+  , input                                         cancel
+  , input ob_pkg::uid_t                           cancel_uid
+  //
+  , output logic                                  cancel_hit_w
+
+  // ======================================================================== //
+  // Status Interface
+  , output logic                                  full_r
+
+  // ======================================================================== //
+  // Read Interface
+  , input ob_pkg::snap_idx_t                      rd_idx
+  //
+  , output logic                                  rd_vld_w
+  , output ob_pkg::cmd_t                          rd_cmd_w
+
+  // ======================================================================== //
+  // Clk/Reset
+  , input                                         clk
+  , input                                         rst
+);
+
+  // ======================================================================== //
+  //                                                                          //
+  // Helper functions                                                         //
+  //                                                                          //
+  // ======================================================================== //
+
+  // Trigger price 'x' is nearer to maturity than trigger price 't'. Buy stops
+  // mature as the market falls to their trigger (greatest first), Sell stops
+  // as the market rises to their trigger (smallest first).
+  //
+  function automatic logic price_compare(bcd_pkg::price_t x,
+                                         bcd_pkg::price_t t); begin
+    return is_buy ? (x > t) : (x < t);
+  end endfunction
+
+  // Unary mask of all bits at, or below, the set bit(s) of 'x'.
+  function automatic logic [N - 1:0] mask_lsb(logic [N - 1:0] x); begin
+    logic mask_enable = 'b0;
+    mask_lsb = '0;
+    for (int i = N - 1; i >= 0; i--) begin
+      mask_enable |= x [i];
+      mask_lsb [i] = mask_enable;
+    end
+  end endfunction
+
+  // ======================================================================== //
+  //                                                                          //
+  // Table state                                                              //
+  //                                                                          //
+  // ======================================================================== //
+
+  // Table ordered by trigger price (price1) such that the entry nearest to
+  // maturity resides at the head ((N-1)-th entry). Entries of equal trigger
+  // price are retained in order of arrival. Valid entries are contiguous from
+  // the head.
+  ob_pkg::cmd_t [N - 1:0]               tbl_r;
+  ob_pkg::cmd_t [N - 1:0]               tbl_w;
+  logic [N - 1:0]                       tbl_en;
+  `LIBV_REG_RST(logic [N - 1:0], tbl_vld, '0);
+
+  // ------------------------------------------------------------------------ //
+  //
+  logic [N - 1:0]                       insert_match_d;
+  logic [N - 1:0]                       insert_install_d;
+
+  always_comb begin : insert_PROC
+
+    // Entries which are either unoccupied or further from maturity than the
+    // inserted command. As the table is ordered, the match vector is unary
+    // from the tail; the command is installed at its uppermost bit and the
+    // entries beneath are shifted towards the tail.
+    //
+    for (int i = 0; i < N; i++)
+      insert_match_d [i] =
+        insert & ((~tbl_vld_r [i]) | price_compare(insert_cmd.price1,
+                                                   tbl_r [i].price1));
+
+    insert_install_d = insert_match_d & (~(insert_match_d >> 1));
+
+  end // block: insert_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  logic [N - 1:0]                       cancel_match_d;
+
+  always_comb begin : cancel_PROC
+
+    // Form 1-hot vector of the entry matching the cancelled UID.
+    for (int i = 0; i < N; i++)
+      cancel_match_d [i] = tbl_vld_r [i] & (tbl_r [i].uid == cancel_uid);
+
+    cancel_hit_w = cancel & (cancel_match_d != '0);
+
+  end // block: cancel_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  logic [N - 1:0]                       tbl_shift_up_d;
+  logic [N - 1:0]                       tbl_shift_dn_d;
+
+  always_comb begin : t_op_PROC
+
+    // Entries shift towards the head on a pop of the head, or to close the
+    // entry vacated by a cancel.
+    //
+    case ({head_pop, cancel_hit_w}) inside
+      2'b1_?:  tbl_shift_up_d = '1;
+      2'b0_1:  tbl_shift_up_d = mask_lsb(cancel_match_d);
+      default: tbl_shift_up_d = '0;
+    endcase // case ({head_pop, cancel_hit_w})
+
+    // Entries shift towards the tail beneath an inserted entry.
+    //
+    tbl_shift_dn_d = insert_match_d & (~insert_install_d);
+
+  end // block: t_op_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : tbl_update_PROC
+
+    for (int i = N - 1; i >= 0; i--) begin
+
+      // Enable update when data moves into entry.
+      tbl_en [i]  =
+        (insert_install_d [i] | tbl_shift_up_d [i] | tbl_shift_dn_d [i]);
+
+      // Next state (unique, no priority)
+      unique case  ({// Install new entry at current location
+                     insert_install_d [i],
+                     // Shift entry up (towards head)
+                     tbl_shift_up_d [i],
+                     // Shift entry down (towards tail)
+                     tbl_shift_dn_d [i]
+                     }) inside
+        3'b1??: begin
+          tbl_w [i]     = insert_cmd;
+          tbl_vld_w [i] = 'b1;
+        end
+        3'b01?: begin
+          tbl_w [i]     = (i == 0) ? tbl_r [i] : tbl_r [i - 1];
+          tbl_vld_w [i] = (i == 0) ? 'b0 : tbl_vld_r [i - 1];
+        end
+        3'b001: begin
+          tbl_w [i]     = (i == N - 1) ? tbl_r [i] : tbl_r [i + 1];
+          tbl_vld_w [i] = (i == N - 1) ? 'b0 : tbl_vld_r [i + 1];
+        end
+        default: begin
+          tbl_w [i]     = tbl_r [i];
+          tbl_vld_w [i] = tbl_vld_r [i];
+        end
+      endcase
+
+    end // for (int i = N - 1; i >= 0; i--)
+
+  end // block: tbl_update_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  `LIBV_REG_RST_W(logic, head_vld, 'b0);
+  `LIBV_REG_EN_W(ob_pkg::cmd_t, head);
+  `LIBV_REG_RST_W(logic, full, 'b0);
+
+  always_comb begin : head_PROC
+
+    // Head of table; the entry nearest to maturity.
+    head_vld_w = tbl_vld_w [N - 1];
+    head_en    = tbl_en [N - 1];
+    head_w     = tbl_w [N - 1];
+
+    // Table is full whenever the tail entry is occupied.
+    full_w     = tbl_vld_w [0];
+
+  end // block: head_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : rd_PROC
+
+    // Read the 'rd_idx'-th entry from the head of the table (the entry
+    // nearest to maturity).
+    rd_vld_w = 'b0;
+    rd_cmd_w = '0;
+    for (int i = 0; i < N; i++) begin
+      if (rd_idx == ob_pkg::snap_idx_t'(i)) begin
+        rd_vld_w = tbl_vld_r [N - 1 - i];
+        rd_cmd_w = tbl_r [N - 1 - i];
+      end
+    end
+
+  end // block: rd_PROC
+
+  // ======================================================================== //
+  //                                                                          //
+  // Flops                                                                    //
+  //                                                                          //
+  // ======================================================================== //
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_ff @(posedge clk) begin : t_FLOP
+    for (int i = 0; i < N; i++)
+      if (tbl_en [i])
+        tbl_r [i] <= tbl_w [i];
+  end // block: t_FLOP
+
+endmodule // ob_cn_side_table
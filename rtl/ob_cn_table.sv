@@ -29,9 +29,10 @@
 `timescale 1ns/1ps
 
 `include "ob_pkg.vh"
-`include "libv_pkg.vh"
+`include "bcd_pkg.vh"
+`include "macros_pkg.vh"
 
-module ob_cn_table #(parameter int N = 4) (
+module ob_cn_table #(parameter int N = 64) (
 
   // ======================================================================== //
   // Issue interface
@@ -61,7 +62,17 @@ module ob_cn_table #(parameter int N = 4) (
 
   // ======================================================================== //
   // Status Interface
-  , output logic                                  full_r
+  , output logic                                  buy_full_r
+  , output logic                                  sell_full_r
+
+  // ======================================================================== //
+  // Read Interface
+  , input ob_pkg::snap_idx_t                      rd_idx
+  //
+  , output logic                                  buy_rd_vld_w
+  , output ob_pkg::cmd_t                          buy_rd_cmd_w
+  , output logic                                  sell_rd_vld_w
+  , output ob_pkg::cmd_t                          sell_rd_cmd_w
 
   // ======================================================================== //
   // Clk/Reset
@@ -74,114 +85,110 @@ module ob_cn_table #(parameter int N = 4) (
 
   // ------------------------------------------------------------------------ //
   //
-  logic [N - 1:0]                       rr_req;
-  logic                                 rr_ack;
-  logic [N - 1:0]                       rr_gnt;
-  logic [N - 1:0]                       cancel_hit_d;
-  logic [N - 1:0]                       al_vld;
-  logic [N - 1:0]                       dl_vld;
-  `LIBV_REG_RST(logic [N - 1:0], entry_busy, 'b0);
-  `LIBV_REG_RST(logic [N - 1:0], entry_mtr_vld, 'b0);
-  ob_pkg::cmd_t [N - 1:0]               entry_cmd_r;
-  ob_pkg::cmd_t                         entry_cmd_sel;
-  `LIBV_REG_RST_W(logic, full, 'b0);
+  // Conditional commands are retained in a pair of tables, one per trigger
+  // direction, each ordered by trigger price such that only the head entry
+  // of each table need be compared against the traded price. On a trade,
+  // a sweep is initiated on each table which matures the head entry for as
+  // long as the head continues to satisfy its trigger condition.
+  //
+  logic                                 buy_insert;
+  logic                                 buy_head_pop;
+  logic                                 buy_cancel_hit_w;
+  logic                                 buy_head_vld_r;
+  ob_pkg::cmd_t                         buy_head_r;
+  logic                                 buy_head_mtr;
+  `LIBV_REG_RST(logic, buy_sweep, 'b0);
+  //
+  logic                                 sell_insert;
+  logic                                 sell_head_pop;
+  logic                                 sell_cancel_hit_w;
+  logic                                 sell_head_vld_r;
+  ob_pkg::cmd_t                         sell_head_r;
+  logic                                 sell_head_mtr;
+  `LIBV_REG_RST(logic, sell_sweep, 'b0);
+  //
+  `LIBV_REG_RST(logic, sel_sell, 'b0);
   `LIBV_REG_RST_W(logic, mtr_vld, 'b0);
   `LIBV_REG_EN_W(ob_pkg::cmd_t, mtr);
-  logic                                 cntrl_has_matured;
+  logic                                 mtr_adv;
   logic                                 cancel_hit_mtr;
 
-  for (genvar g = 0; g < N; g++) begin
-
-    ob_cn_table_entry u_ob_cn_table_entry (
-      //
-        .al_vld                    (al_vld [g]              )
-      , .al_cmd_r                  (cmd_r                   )
-      //
-      , .dl_vld                    (dl_vld [g]              )
-      //
-      , .busy_w                    (entry_busy_w [g]        )
-      , .mtr_vld_w                 (entry_mtr_vld_w [g]     )
-      //
-      , .cmd_r                     (entry_cmd_r [g]         )
-      //
-      , .cntrl_evt_texe_r          (cntrl_evt_texe_r        )
-      , .cntrl_evt_texe_ask_r      (cntrl_evt_texe_ask_r    )
-      , .cntrl_evt_texe_bid_r      (cntrl_evt_texe_bid_r    )
-      //
-      , .cancel                    (cancel                  )
-      , .cancel_uid                (cancel_uid              )
-      , .cancel_hit                (cancel_hit_d [g]        )
-      //
-      , .clk                       (clk                     )
-      , .rst                       (rst                     )
-    );
-
-  end
-
-  // ------------------------------------------------------------------------ //
-  //
-  libv_rr #(.W(N)) u_libv_rr (
-    //
-      .req                    (rr_req                  )
-    , .ack                    (rr_ack                  )
-    , .gnt                    (rr_gnt                  )
-    , .gnt_enc                ()
-    //
-    , .clk                    (clk                     )
-    , .rst                    (rst                     )
-  );
-
   // ------------------------------------------------------------------------ //
   //
-  function automatic logic [N - 1:0] pri(logic [N - 1:0] x); begin
-    pri        = '0;
-    for (int i = 0; i < N; i++)
-      if (x [i] == 'b1)
-        pri = ('b1 << i);
-  end endfunction
-
-  function automatic ob_pkg::cmd_t mux(
-    ob_pkg::cmd_t [N - 1:0] x, logic [N - 1:0] sel); begin
-    mux        = '0;
-    for (int i = 0; i < N; i++)
-      if (sel [i])
-        mux |= x [i];
+  function automatic ob_pkg::cmd_t mature(ob_pkg::cmd_t cmd); begin
+    // As the command matures, it permutes from the "Stop" order to the
+    // corresponding Market/Limit Order
+    mature = cmd;
+    case (cmd.opcode)
+      ob_pkg::Op_BuyStopLoss:   mature.opcode = ob_pkg::Op_BuyMarket;
+      ob_pkg::Op_SellStopLoss:  mature.opcode = ob_pkg::Op_SellMarket;
+      ob_pkg::Op_BuyStopLimit:  mature.opcode = ob_pkg::Op_BuyLimit;
+      ob_pkg::Op_SellStopLimit: mature.opcode = ob_pkg::Op_SellLimit;
+      default: begin
+        // Otherwise, error: Unknown command is present in table.
+      end
+    endcase // case (cmd.opcode)
   end endfunction
 
   always_comb begin : cntrl_PROC
 
-    // Allocate to first non-busy entry.
-    al_vld            = cmd_vld ? pri(~entry_busy_r) : '0;
+    // Allocate to the table corresponding to the direction of the command.
+    case (cmd_r.opcode)
+      ob_pkg::Op_BuyStopLoss,
+      ob_pkg::Op_BuyStopLimit: begin
+        buy_insert  = cmd_vld;
+        sell_insert = 'b0;
+      end
+      default: begin
+        buy_insert  = 'b0;
+        sell_insert = cmd_vld;
+      end
+    endcase // case (cmd_r.opcode)
+
+    // BuyStop{Loss,Limit} matures whenever the asking price falls to, or
+    // below, the watch value.
+    buy_head_mtr   = buy_head_vld_r & (buy_head_r.price1 >= cntrl_evt_texe_ask_r);
+
+    // SellStop{Loss,Limit} matures whenever the bidding price rises to, or
+    // above, the watch value.
+    sell_head_mtr  = sell_head_vld_r & (sell_head_r.price1 <= cntrl_evt_texe_bid_r);
+
+    // Sweep initiated on trade, and continues until the head entry no longer
+    // satisfies its trigger condition.
+    buy_sweep_w    = (cntrl_evt_texe_r | buy_sweep_r) & buy_head_mtr;
+    sell_sweep_w   = (cntrl_evt_texe_r | sell_sweep_r) & sell_head_mtr;
+
+    // The maturity latch advances whenever it is empty or consumed. Maturity
+    // is deferred in the presence of an insert or cancel operation, to
+    // retain one modification per table per cycle.
+    mtr_adv        = ((~mtr_vld_r) | mtr_accept) & (~cmd_vld) & (~cancel);
+
+    // Arbitrate between matured heads; alternate on contention.
+    case ({buy_sweep_w, sell_sweep_w}) inside
+      2'b1_1: begin
+        buy_head_pop  = mtr_adv & (~sel_sell_r);
+        sell_head_pop = mtr_adv & sel_sell_r;
+      end
+      default: begin
+        buy_head_pop  = mtr_adv & buy_sweep_w;
+        sell_head_pop = mtr_adv & sell_sweep_w;
+      end
+    endcase // case ({buy_sweep_w, sell_sweep_w})
+
+    sel_sell_w     = (buy_head_pop | sell_head_pop) ? buy_head_pop : sel_sell_r;
+
+    // Latch new matured command on new valid.
+    mtr_en         = (buy_head_pop | sell_head_pop);
+    mtr_w          = mature(sell_head_pop ? sell_head_r : buy_head_r);
 
     // Cancel hits command sitting at the MTR latch.
-    cancel_hit_mtr    = cancel & mtr_vld_r & (mtr_r.uid == cancel_uid);
+    cancel_hit_mtr = cancel & mtr_vld_r & (mtr_r.uid == cancel_uid);
 
     // Set on hit.
-    cancel_hit_w      = cancel & ((cancel_hit_d != '0) | cancel_hit_mtr);
-
-    // All slots/entries in the conditional table are occupied.
-    full_w            = (entry_busy_w == '1);
-
-    // Matured engines are available.
-    cntrl_has_matured = (entry_mtr_vld_r != '0);
-
-    // From set of matured entries:
-    rr_req            = entry_mtr_vld_r;
-
-    // Advance arbiter state when currently nominated entry advances.
-    rr_ack            = cntrl_has_matured & ((~mtr_vld_r) | mtr_accept);
-
-    // Deallocate nominated matured entry on its transition to the 'mtr_' latch.
-    dl_vld            = rr_ack ? rr_gnt : '0;
-
-    // Latch new matured command on new valid.
-    mtr_en            = rr_ack;
-
-    // Latch nominated command from matured engine.
-    mtr_w             = mux(entry_cmd_r, rr_gnt);
+    cancel_hit_w   = cancel & (buy_cancel_hit_w | sell_cancel_hit_w | cancel_hit_mtr);
 
     // mtr vld set/reset.
-    case ({rr_ack, mtr_accept, cancel_hit_mtr}) inside
+    case ({mtr_en, mtr_accept, cancel_hit_mtr}) inside
       3'b1??:  mtr_vld_w = 'b1;
       3'b01?:  mtr_vld_w = 'b0;
       3'b001:  mtr_vld_w = 'b0;
@@ -190,4 +197,54 @@ module ob_cn_table #(parameter int N = 4) (
 
   end // block: cntrl_PROC
 
+  // ------------------------------------------------------------------------ //
+  //
+  ob_cn_side_table #(.N(N), .is_buy('b1)) u_cn_side_table_buy (
+    //
+      .head_pop               (buy_head_pop            )
+    , .head_vld_r             (buy_head_vld_r          )
+    , .head_r                 (buy_head_r              )
+    //
+    , .insert                 (buy_insert              )
+    , .insert_cmd             (cmd_r                   )
+    //
+    , .cancel                 (cancel                  )
+    , .cancel_uid             (cancel_uid              )
+    , .cancel_hit_w           (buy_cancel_hit_w        )
+    //
+    , .full_r                 (buy_full_r              )
+    //
+    , .rd_idx                 (rd_idx                  )
+    , .rd_vld_w               (buy_rd_vld_w            )
+    , .rd_cmd_w               (buy_rd_cmd_w            )
+    //
+    , .clk                    (clk                     )
+    , .rst                    (rst                     )
+  );
+
+  // ------------------------------------------------------------------------ //
+  //
+  ob_cn_side_table #(.N(N), .is_buy('b0)) u_cn_side_table_sell (
+    //
+      .head_pop               (sell_head_pop           )
+    , .head_vld_r             (sell_head_vld_r         )
+    , .head_r                 (sell_head_r             )
+    //
+    , .insert                 (sell_insert             )
+    , .insert_cmd             (cmd_r                   )
+    //
+    , .cancel                 (cancel                  )
+    , .cancel_uid             (cancel_uid              )
+    , .cancel_hit_w           (sell_cancel_hit_w       )
+    //
+    , .full_r                 (sell_full_r             )
+    //
+    , .rd_idx                 (rd_idx                  )
+    , .rd_vld_w               (sell_rd_vld_w           )
+    , .rd_cmd_w               (sell_rd_cmd_w           )
+    //
+    , .clk                    (clk                     )
+    , .rst                    (rst                     )
+  );
+
 endmodule // ob_cn_table
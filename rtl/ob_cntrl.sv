@@ -37,12 +37,22 @@ module ob_cntrl (
   // Command In Interface
     input                                         cmd_in_vld
   , input ob_pkg::cmd_t                           cmd_in
+  // Timestamp at which 'cmd_in' was accepted.
+  , input ob_pkg::ts_t                            cmd_in_ts
   //
   , output logic                                  cmd_in_pop
+  //
+  , output logic                                  cmd_in_byp_rdy
 
   // ======================================================================== //
   // Response Out Interface
-  , input                                         rsp_out_full_r
+  //
+  // Trades are emitted to the trade channel; all other responses to the ack
+  // channel. Each channel applies back-pressure independently.
+  , input                                         ack_out_full_r
+  , input                                         trd_out_full_r
+  // Trade channel has room for every trade a single command may emit.
+  , input                                         trd_out_room_r
   //
   , output logic                                  rsp_out_vld_r
   , output ob_pkg::rsp_t                          rsp_out_r
@@ -76,6 +86,12 @@ module ob_cntrl (
   //
   , output logic                                  lm_bid_cancel
   , output ob_pkg::uid_t                          lm_bid_cancel_uid
+  // Amend interface:
+  , input                                         lm_bid_amend_hit_w
+  , input                                         lm_bid_amend_inplace_w
+  //
+  , output logic                                  lm_bid_amend
+  , output ob_pkg::table_t                        lm_bid_amend_tbl
   // Qry interface:
   , input                                         lm_bid_qry_rsp_vld_r
   , input                                         lm_bid_qry_rsp_is_ge_r
@@ -84,6 +100,12 @@ module ob_cntrl (
   , output logic                                  lm_bid_qry_vld
   , output bcd_pkg::price_t                       lm_bid_qry_price
   , output ob_pkg::quantity_t                     lm_bid_qry_quantity
+  // Read interface:
+  , output ob_pkg::table_idx_t                    lm_bid_rd_idx
+  , input                                         lm_bid_rd_vld_w
+  , input ob_pkg::table_t                         lm_bid_rd_tbl_w
+  //
+  , input                                         lm_bid_full_r
 
   // ======================================================================== //
   // Ask Table Interface
@@ -108,6 +130,12 @@ module ob_cntrl (
   //
   , output logic                                  lm_ask_cancel
   , output ob_pkg::uid_t                          lm_ask_cancel_uid
+  // Amend interface:
+  , input                                         lm_ask_amend_hit_w
+  , input                                         lm_ask_amend_inplace_w
+  //
+  , output logic                                  lm_ask_amend
+  , output ob_pkg::table_t                        lm_ask_amend_tbl
   // Qry interface:
   , input                                         lm_ask_qry_rsp_vld_r
   , input                                         lm_ask_qry_rsp_is_ge_r
@@ -116,6 +144,12 @@ module ob_cntrl (
   , output logic                                  lm_ask_qry_vld
   , output bcd_pkg::price_t                       lm_ask_qry_price
   , output ob_pkg::quantity_t                     lm_ask_qry_quantity
+  // Read interface:
+  , output ob_pkg::table_idx_t                    lm_ask_rd_idx
+  , input                                         lm_ask_rd_vld_w
+  , input ob_pkg::table_t                         lm_ask_rd_tbl_w
+  //
+  , input                                         lm_ask_full_r
 
   // ======================================================================== //
   // Market Bid Interface
@@ -146,6 +180,10 @@ module ob_cntrl (
   , input ob_pkg::accum_quantity_t                mk_bid_qry_rsp_qty_r
   //
   , output logic                                  mk_bid_qry_vld
+  //
+  , output ob_pkg::snap_idx_t                     mk_bid_rd_idx
+  , input                                         mk_bid_rd_vld_w
+  , input ob_pkg::table_t                         mk_bid_rd_tbl_w
 
   // ======================================================================== //
   // Market Ask Interface
@@ -176,6 +214,10 @@ module ob_cntrl (
   , input ob_pkg::accum_quantity_t                mk_ask_qry_rsp_qty_r
   //
   , output logic                                  mk_ask_qry_vld
+  //
+  , output ob_pkg::snap_idx_t                     mk_ask_rd_idx
+  , input                                         mk_ask_rd_vld_w
+  , input ob_pkg::table_t                         mk_ask_rd_tbl_w
 
   // ======================================================================== //
   // Conditional command interface
@@ -192,7 +234,22 @@ module ob_cntrl (
   , input                                         cn_mtr_vld_r
   , input ob_pkg::cmd_t                           cn_mtr_r
   //
-  , input                                         cn_full_r
+  , input                                         cn_buy_full_r
+  , input                                         cn_sell_full_r
+  //
+  , output ob_pkg::snap_idx_t                     cn_rd_idx
+  , input                                         cn_buy_rd_vld_w
+  , input ob_pkg::cmd_t                           cn_buy_rd_cmd_w
+  , input                                         cn_sell_rd_vld_w
+  , input ob_pkg::cmd_t                           cn_sell_rd_cmd_w
+
+  // ======================================================================== //
+  // Market Data Interface
+  , output logic                                  md_commit
+
+  // ======================================================================== //
+  // Timestamp
+  , input ob_pkg::ts_t                            ts_r
 
   // ======================================================================== //
   // Clk/Reset
@@ -236,6 +293,12 @@ module ob_cntrl (
 
   `LIBV_REG_RST_R(logic, cn_cancel_hit, 'b0);
 
+  `LIBV_REG_RST_R(logic, lm_bid_amend_hit, 'b0);
+  `LIBV_REG_RST_R(logic, lm_bid_amend_inplace, 'b0);
+
+  `LIBV_REG_RST_R(logic, lm_ask_amend_hit, 'b0);
+  `LIBV_REG_RST_R(logic, lm_ask_amend_inplace, 'b0);
+
   `LIBV_REG_RST_R(logic, mk_bid_full, 'b0);
   `LIBV_REG_RST_R(logic, mk_bid_empty, 'b1);
 
@@ -246,10 +309,14 @@ module ob_cntrl (
   //
   `LIBV_REG_RST(logic, cmdl_vld, 'b0);
   `LIBV_REG_EN(ob_pkg::cmd_t, cmdl);
+  `LIBV_REG_EN(ob_pkg::ts_t, cmdl_ts);
   logic                                      cmdl_adv;
+  logic                                      cmdl_fetch;
   logic                                      cmdl_consume;
   logic                                      cmdl_cn_can_issue;
   logic                                      cmdl_cn_is_valid;
+  logic                                      cmdl_cn_full;
+  logic                                      cmdl_cn_is_buy;
 
   always_comb begin : cmdl_PROC
 
@@ -309,9 +376,18 @@ module ob_cntrl (
     // or if it currently invalid (sampling new state).
     cmdl_adv         = (~cmdl_vld_r) | cmdl_consume;
 
-    // Pop ingress command queue when commands are present. Defeat in the
-    // presence of a valid CN command.
-    cmd_in_pop       = cmd_in_vld & (~cmdl_cn_is_valid) & cmdl_adv;
+    // Fetch from the ingress command queue when commands are present. Defeat
+    // in the presence of a valid CN command.
+    cmdl_fetch       = cmd_in_vld & (~cmdl_cn_is_valid) & cmdl_adv;
+
+    // Pop ingress command queue on fetch.
+    cmd_in_pop       = cmdl_fetch;
+
+    // The controller is idle and is assured to accept the command presented
+    // on the ingress interface in the current cycle. Derived from state alone
+    // such that the bypass decision at the ingress queue does not sit
+    // behind the controller's command decode.
+    cmd_in_byp_rdy   = (~cmdl_vld_r) & (~cn_mtr_vld_r);
 
     // Accept matured CN command when present and when the command latch
     // advances.
@@ -332,24 +408,361 @@ module ob_cntrl (
     // otherwise the ingress command queue.
     cmdl_w        = cn_mtr_accept ? cn_mtr_r : cmd_in;
 
+    // Conditional commands are considered accepted upon maturity.
+    cmdl_ts_en    = cmdl_adv;
+    cmdl_ts_w     = cn_mtr_accept ? ts_r : cmd_in_ts;
+
+    // Capacity of the conditional table corresponding to the direction of the
+    // conditional command at cmdl.
+    case (cmdl_r.opcode)
+      ob_pkg::Op_BuyStopLoss,
+      ob_pkg::Op_BuyStopLimit: cmdl_cn_is_buy = 'b1;
+      default:                 cmdl_cn_is_buy = 'b0;
+    endcase // case (cmdl_r.opcode)
+
+    cmdl_cn_full  = cmdl_cn_is_buy ? cn_buy_full_r : cn_sell_full_r;
+
   end // block: cmdl_PROC
 
   // ------------------------------------------------------------------------ //
   //
-  typedef enum logic [4:0] { // Default idle state
-                             FSM_CNTRL_IDLE            = 5'b00001,
+  logic                                      cmdl_tif_kill;
+  logic                                      cmdl_tif_fill;
+  logic                                      cmdl_tif_qry;
+  logic                                      tif_qry_rsp_vld;
+  logic                                      tif_qry_attained;
+
+  always_comb begin : tif_PROC
+
+    // Time-In-Force (TIF) is honored on Limit and Market orders only. Any
+    // order other than GUC is retained at cmdl after installation so that its
+    // unexecuted remainder may be killed once matching has completed. FOK
+    // orders (and AON orders, which are presently treated as FOK as resting
+    // all-or-none orders are not supported by the tables) are additionally
+    // qualified against the opposing side before installation, such that they
+    // are installed only when they are assured to execute in their entirety.
+    //
+    case (cmdl_r.opcode)
+      ob_pkg::Op_BuyLimit,
+      ob_pkg::Op_SellLimit,
+      ob_pkg::Op_BuyMarket,
+      ob_pkg::Op_SellMarket: begin
+        cmdl_tif_kill = (cmdl_r.tif != ob_pkg::Tif_GoodUntilCancelled);
+        cmdl_tif_fill = (cmdl_r.tif == ob_pkg::Tif_FillOrKill) |
+                        (cmdl_r.tif == ob_pkg::Tif_AllOrNone);
+      end
+      default: begin
+        cmdl_tif_kill = 'b0;
+        cmdl_tif_fill = 'b0;
+      end
+    endcase // case (cmdl_r.opcode)
+
+    // Qualification query is required on the first visit of the command.
+    cmdl_tif_qry = cmdl_tif_fill & (~tif_fill_r);
+
+    // Qualification completes once both the limit and market counts on the
+    // opposing side have been computed. The order is qualified if either the
+    // limit table alone attains the quantity (which remains correct in the
+    // presence of early termination), or if the combined count attains it.
+    case (cmdl_r.opcode)
+      ob_pkg::Op_BuyLimit,
+      ob_pkg::Op_BuyMarket: begin
+        tif_qry_rsp_vld  = lm_ask_qry_rsp_vld_r & mk_ask_qry_rsp_vld_r;
+        tif_qry_attained =
+          lm_ask_qry_rsp_is_ge_r |
+          ((lm_ask_qry_rsp_qty_r + mk_ask_qry_rsp_qty_r) >=
+           ob_pkg::accum_quantity_t'(cmdl_r.quantity));
+      end
+      default: begin
+        tif_qry_rsp_vld  = lm_bid_qry_rsp_vld_r & mk_bid_qry_rsp_vld_r;
+        tif_qry_attained =
+          lm_bid_qry_rsp_is_ge_r |
+          ((lm_bid_qry_rsp_qty_r + mk_bid_qry_rsp_qty_r) >=
+           ob_pkg::accum_quantity_t'(cmdl_r.quantity));
+      end
+    endcase // case (cmdl_r.opcode)
+
+  end // block: tif_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  logic                                      cmdl_trd_stall;
+
+  always_comb begin : trd_PROC
+
+    // Commands which may trade are admitted only once the trade channel has
+    // room for every trade that matching could emit. Matching therefore runs
+    // to completion without stalling on a back-pressured trade channel, and
+    // the command retires (and the acknowledgements of those which follow
+    // are emitted) whilst its trades drain.
+    //
+    case (cmdl_r.opcode)
+      ob_pkg::Op_BuyLimit,
+      ob_pkg::Op_SellLimit,
+      ob_pkg::Op_BuyMarket,
+      ob_pkg::Op_SellMarket,
+      ob_pkg::Op_Replace: cmdl_trd_stall = (~trd_out_room_r);
+      default:            cmdl_trd_stall = 'b0;
+    endcase // case (cmdl_r.opcode)
+
+  end // block: trd_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  `LIBV_REG_EN(ob_pkg::snap_idx_t, depth_idx);
+  `LIBV_REG_EN(ob_pkg::quantity_t, depth_lvl);
+  `LIBV_REG_EN(logic, depth_open);
+  `LIBV_REG_EN(bcd_pkg::price_t, depth_price);
+  `LIBV_REG_EN(ob_pkg::accum_quantity_t, depth_accum);
+  logic                                      depth_head_vld;
+  logic                                      depth_rd_vld;
+  ob_pkg::table_t                            depth_rd_tbl;
+  logic                                      depth_rd_same;
+  logic                                      depth_last;
+
+  always_comb begin : depth_PROC
+
+    // Depth snapshot: the nominated limit table is walked from the head, one
+    // entry per cycle, with the quantities of consecutive entries at the
+    // same price aggregated into a level. As the table is sorted, each
+    // level is complete upon reaching the first entry at a differing price
+    // (or the extent of the table).
+    //
+    lm_bid_rd_idx   = ob_pkg::table_idx_t'(depth_idx_r);
+    lm_ask_rd_idx   = ob_pkg::table_idx_t'(depth_idx_r);
+
+    case (cmdl_r.opcode)
+      ob_pkg::Op_QryDepthAsk: begin
+        depth_head_vld = lm_ask_table_vld_r;
+        depth_rd_vld   = lm_ask_rd_vld_w;
+        depth_rd_tbl   = lm_ask_rd_tbl_w;
+      end
+      default: begin
+        depth_head_vld = lm_bid_table_vld_r;
+        depth_rd_vld   = lm_bid_rd_vld_w;
+        depth_rd_tbl   = lm_bid_rd_tbl_w;
+      end
+    endcase // case (cmdl_r.opcode)
+
+    // Current entry belongs to the current (or opens a new) level.
+    depth_rd_same   =
+      depth_rd_vld & ((~depth_open_r) | (depth_rd_tbl.price == depth_price_r));
+
+    // Current level is the final level emitted; either the table has been
+    // exhausted or K levels have been emitted (K == 0 denotes all levels).
+    depth_last      = (~depth_rd_vld) |
+                      ((cmdl_r.quantity != '0) &
+                       ((depth_lvl_r + 'b1) == cmdl_r.quantity));
+
+  end // block: depth_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  typedef enum logic [2:0] { MC_LM_BID = 3'b000,
+                             MC_MK_BID = 3'b001,
+                             MC_LM_ASK = 3'b010,
+                             MC_MK_ASK = 3'b011,
+                             MC_DONE   = 3'b100
+                             } mc_phase_t;
+
+  `LIBV_REG_EN(mc_phase_t, mc_phase);
+  `LIBV_REG_EN(ob_pkg::accum_quantity_t, mc_n);
+  ob_pkg::mcancel_t                          mc_ctrl;
+  logic                                      mc_sel;
+  logic                                      mc_rd_vld;
+  ob_pkg::table_t                            mc_rd_tbl;
+  logic                                      mc_match;
+  logic                                      mc_beyond;
+  logic                                      mc_phase_done;
+
+  always_comb begin : mc_PROC
+
+    // Mass cancel: the Bid limit, Bid market, Ask limit and Ask market tables
+    // are visited in turn. Limit tables are walked from the head (sharing the
+    // read index of the depth snapshot, as the operations are exclusive);
+    // matching entries are cancelled in place, such that the index advances
+    // only on a miss. Market tables are drained from their head.
+    //
+    mc_ctrl  = ob_pkg::mcancel_t'(cmdl_r.quantity);
+
+    case (mc_phase_r)
+      MC_LM_BID: begin
+        mc_sel    = mc_ctrl.bid;
+        mc_rd_vld = lm_bid_rd_vld_w;
+        mc_rd_tbl = lm_bid_rd_tbl_w;
+      end
+      MC_MK_BID: begin
+        mc_sel    = mc_ctrl.bid & (mc_ctrl.range == ob_pkg::Mc_All);
+        mc_rd_vld = mk_bid_head_vld_r;
+        mc_rd_tbl = mk_bid_head_r;
+      end
+      MC_LM_ASK: begin
+        mc_sel    = mc_ctrl.ask;
+        mc_rd_vld = lm_ask_rd_vld_w;
+        mc_rd_tbl = lm_ask_rd_tbl_w;
+      end
+      MC_MK_ASK: begin
+        mc_sel    = mc_ctrl.ask & (mc_ctrl.range == ob_pkg::Mc_All);
+        mc_rd_vld = mk_ask_head_vld_r;
+        mc_rd_tbl = mk_ask_head_r;
+      end
+      default: begin
+        mc_sel    = 'b0;
+        mc_rd_vld = 'b0;
+        mc_rd_tbl = '0;
+      end
+    endcase // case (mc_phase_r)
+
+    // Entry lies within the nominated price range.
+    case (mc_ctrl.range)
+      ob_pkg::Mc_Ge: mc_match = (mc_rd_tbl.price >= cmdl_r.price);
+      ob_pkg::Mc_Le: mc_match = (mc_rd_tbl.price <= cmdl_r.price);
+      default:       mc_match = 'b1;
+    endcase // case (mc_ctrl.range)
+
+    // As the limit tables are sorted, the walk terminates early on the first
+    // entry beyond the range when the range is anchored at the head.
+    case (mc_phase_r)
+      MC_LM_BID: mc_beyond = (mc_ctrl.range == ob_pkg::Mc_Ge) & (~mc_match);
+      MC_LM_ASK: mc_beyond = (mc_ctrl.range == ob_pkg::Mc_Le) & (~mc_match);
+      default:   mc_beyond = 'b0;
+    endcase // case (mc_phase_r)
+
+    // Current table has been exhausted (or was not nominated).
+    mc_phase_done = (~mc_sel) | (~mc_rd_vld) | mc_beyond;
+
+  end // block: mc_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  typedef enum logic [2:0] { SNAP_LM_BID  = 3'b000,
+                             SNAP_LM_ASK  = 3'b001,
+                             SNAP_MK_BID  = 3'b010,
+                             SNAP_MK_ASK  = 3'b011,
+                             SNAP_CN_BUY  = 3'b100,
+                             SNAP_CN_SELL = 3'b101,
+                             SNAP_DONE    = 3'b110
+                             } snap_phase_t;
+
+  `LIBV_REG_EN(snap_phase_t, snap_phase);
+  `LIBV_REG_EN(logic, snap_ext);
+  logic                                      snap_rd_vld;
+  logic                                      snap_is_cn;
+  ob_pkg::cmd_t                              snap_rd_cmd;
+  ob_pkg::result_snapshot_t                  snap_entry;
+
+  always_comb begin : snap_PROC
+
+    // Book snapshot: the limit, market and conditional tables are visited in
+    // turn (in the order of snap_table_t) and walked from the head, one entry
+    // per response. Each table exposes a read port indexed by the read index
+    // of the depth snapshot, as the operations are exclusive. Conditional
+    // entries carry two responses; the second (ext) carries the trigger
+    // price and opcode of the entry.
+    //
+    mk_bid_rd_idx = depth_idx_r;
+    mk_ask_rd_idx = depth_idx_r;
+    cn_rd_idx     = depth_idx_r;
+
+    snap_rd_cmd   = '0;
+    case (snap_phase_r)
+      SNAP_LM_BID: begin
+        snap_rd_vld          = lm_bid_rd_vld_w;
+        snap_rd_cmd.uid      = lm_bid_rd_tbl_w.uid;
+        snap_rd_cmd.quantity = lm_bid_rd_tbl_w.quantity;
+        snap_rd_cmd.price    = lm_bid_rd_tbl_w.price;
+      end
+      SNAP_LM_ASK: begin
+        snap_rd_vld          = lm_ask_rd_vld_w;
+        snap_rd_cmd.uid      = lm_ask_rd_tbl_w.uid;
+        snap_rd_cmd.quantity = lm_ask_rd_tbl_w.quantity;
+        snap_rd_cmd.price    = lm_ask_rd_tbl_w.price;
+      end
+      SNAP_MK_BID: begin
+        snap_rd_vld          = mk_bid_rd_vld_w;
+        snap_rd_cmd.uid      = mk_bid_rd_tbl_w.uid;
+        snap_rd_cmd.quantity = mk_bid_rd_tbl_w.quantity;
+        snap_rd_cmd.price    = mk_bid_rd_tbl_w.price;
+      end
+      SNAP_MK_ASK: begin
+        snap_rd_vld          = mk_ask_rd_vld_w;
+        snap_rd_cmd.uid      = mk_ask_rd_tbl_w.uid;
+        snap_rd_cmd.quantity = mk_ask_rd_tbl_w.quantity;
+        snap_rd_cmd.price    = mk_ask_rd_tbl_w.price;
+      end
+      SNAP_CN_BUY: begin
+        snap_rd_vld          = cn_buy_rd_vld_w;
+        snap_rd_cmd          = cn_buy_rd_cmd_w;
+      end
+      SNAP_CN_SELL: begin
+        snap_rd_vld          = cn_sell_rd_vld_w;
+        snap_rd_cmd          = cn_sell_rd_cmd_w;
+      end
+      default: begin
+        snap_rd_vld          = 'b0;
+      end
+    endcase // case (snap_phase_r)
+
+    snap_is_cn    = (snap_phase_r == SNAP_CN_BUY) |
+                    (snap_phase_r == SNAP_CN_SELL);
+
+    // Form entry; the extension carries the conditional trigger price and
+    // the opcode/TIF of the entry (quantity[4:0] and quantity[7:5]).
+    snap_entry          = '0;
+    snap_entry.tbl      = ob_pkg::snap_table_t'(snap_phase_r);
+    snap_entry.ext      = snap_ext_r;
+    snap_entry.uid      = snap_rd_cmd.uid;
+    case (snap_ext_r)
+      1'b1: begin
+        snap_entry.price    = snap_rd_cmd.price1;
+        snap_entry.quantity =
+          ob_pkg::quantity_t'({snap_rd_cmd.tif, snap_rd_cmd.opcode});
+      end
+      default: begin
+        snap_entry.price    = snap_rd_cmd.price;
+        snap_entry.quantity = snap_rd_cmd.quantity;
+      end
+    endcase // case (snap_ext_r)
+
+  end // block: snap_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  typedef enum logic [12:0] { // Default idle state
+                             FSM_CNTRL_IDLE            = 13'b0_0000_0000_0001,
                              // Issue table query on current
-                             FSM_CNTRL_TABLE_ISSUE_QRY = 5'b00010,
+                             FSM_CNTRL_TABLE_ISSUE_QRY = 13'b0_0000_0000_0010,
                              // Execute query response
-                             FSM_CNTRL_TABLE_EXECUTE   = 5'b00100,
+                             FSM_CNTRL_TABLE_EXECUTE   = 13'b0_0000_0000_0100,
                              // Receive cancel notification
-                             FSM_CNTRL_CANCEL_RESP     = 5'b01000,
+                             FSM_CNTRL_CANCEL_RESP     = 13'b0_0000_0000_1000,
                              // Perform 'count' lookup on the nominated table.
-                             FSM_CNTRL_QRY_TBL         = 5'b10000
+                             FSM_CNTRL_QRY_TBL         = 13'b0_0000_0001_0000,
+                             // Await FOK/AON qualification on opposing side.
+                             FSM_CNTRL_TIF_QRY         = 13'b0_0000_0010_0000,
+                             // Cancel unexecuted remainder of IOC/FOK order.
+                             FSM_CNTRL_TIF_CANCEL      = 13'b0_0000_0100_0000,
+                             // Emit kill notification for IOC/FOK order.
+                             FSM_CNTRL_TIF_RESP        = 13'b0_0000_1000_0000,
+                             // Walk limit table emitting aggregated levels.
+                             FSM_CNTRL_QRY_DEPTH       = 13'b0_0001_0000_0000,
+                             // Walk tables cancelling nominated entries.
+                             FSM_CNTRL_MCANCEL         = 13'b0_0010_0000_0000,
+                             // Receive amend notification
+                             FSM_CNTRL_REPLACE_RESP    = 13'b0_0100_0000_0000,
+                             // Stream performance counters.
+                             FSM_CNTRL_QRY_STATS       = 13'b0_1000_0000_0000,
+                             // Stream table entries (book snapshot).
+                             FSM_CNTRL_SNAPSHOT        = 13'b1_0000_0000_0000
                              } fsm_state_t;
 
   // State flop
   `LIBV_REG_EN_RST(fsm_state_t, fsm_state, FSM_CNTRL_IDLE);
+  // Order at cmdl has been installed and is retained until matching has
+  // completed, at which point any unexecuted remainder is killed (IOC/FOK).
+  `LIBV_REG_EN_RST(logic, tif_kill, 'b0);
+  // Order at cmdl has qualified against the opposing side (FOK/AON).
+  `LIBV_REG_EN_RST(logic, tif_fill, 'b0);
   logic                                 trade_qry;
   logic                                 mk_trade_vld_r;
   ob_pkg::search_result_t               mk_trade_r;
@@ -361,6 +774,17 @@ module ob_cntrl (
   `LIBV_REG_EN_W(bcd_pkg::price_t, evt_texe_bid);
   `LIBV_REG_RST_W(logic, rsp_out_vld, 'b0);
   `LIBV_REG_EN_W(ob_pkg::rsp_t, rsp_out);
+  // Performance counter streamed by Op_QryStats.
+  `LIBV_REG_EN(ob_pkg::stats_id_t, stats_id);
+  ob_pkg::stats_cnt_t                   stats_rd_cnt;
+  logic                                 stats_trade;
+  logic                                 stats_reject_mk_bid;
+  logic                                 stats_reject_mk_ask;
+  logic                                 stats_reject_cn_buy;
+  logic                                 stats_reject_cn_sell;
+  logic                                 stats_cancel_hit;
+  logic                                 stats_cancel_miss;
+  logic                                 stats_egress_stall;
 
   always_comb begin : cntrl_PROC
 
@@ -376,6 +800,10 @@ module ob_cntrl (
     // Command In:
     cmd_in_pop           = 'b0;
 
+    // Market Data: the book is at a committed state (no command part way
+    // through execution) only whilst the controller is idle.
+    md_commit            = (fsm_state_r == FSM_CNTRL_IDLE);
+
     // Response Out:
     rsp_out_vld_w        = 'b0;
     rsp_out_w            = '0;
@@ -384,9 +812,51 @@ module ob_cntrl (
     fsm_state_w          = fsm_state_r;
     fsm_state_en         = 'b0;
 
+    // TIF state:
+    tif_kill_w           = 'b0;
+    tif_kill_en          = 'b0;
+    tif_fill_w           = 'b0;
+    tif_fill_en          = 'b0;
+
     // Command latch:
     cmdl_consume         = 'b0;
 
+    // Depth snapshot:
+    depth_idx_en         = 'b0;
+    depth_idx_w          = depth_idx_r;
+    depth_lvl_en         = 'b0;
+    depth_lvl_w          = depth_lvl_r;
+    depth_open_en        = 'b0;
+    depth_open_w         = depth_open_r;
+    depth_price_en       = 'b0;
+    depth_price_w        = depth_price_r;
+    depth_accum_en       = 'b0;
+    depth_accum_w        = depth_accum_r;
+
+    // Mass cancel:
+    mc_phase_en          = 'b0;
+    mc_phase_w           = mc_phase_r;
+    mc_n_en              = 'b0;
+    mc_n_w               = mc_n_r;
+
+    // Book snapshot:
+    snap_phase_en        = 'b0;
+    snap_phase_w         = snap_phase_r;
+    snap_ext_en          = 'b0;
+    snap_ext_w           = snap_ext_r;
+
+    // Performance counters:
+    stats_id_en          = 'b0;
+    stats_id_w           = stats_id_r;
+    stats_trade          = 'b0;
+    stats_reject_mk_bid  = 'b0;
+    stats_reject_mk_ask  = 'b0;
+    stats_reject_cn_buy  = 'b0;
+    stats_reject_cn_sell = 'b0;
+    stats_cancel_hit     = 'b0;
+    stats_cancel_miss    = 'b0;
+    stats_egress_stall   = (ack_out_full_r | trd_out_full_r);
+
     // Bid Table:
     lm_bid_insert        = 'b0;
     lm_bid_insert_tbl    = '0;
@@ -399,6 +869,9 @@ module ob_cntrl (
     lm_bid_cancel        = 'b0;
     lm_bid_cancel_uid    = '0;
 
+    lm_bid_amend         = 'b0;
+    lm_bid_amend_tbl     = '0;
+
     lm_bid_reject_pop    = 'b0;
 
     // Bid query
@@ -418,6 +891,9 @@ module ob_cntrl (
     lm_ask_cancel        = 'b0;
     lm_ask_cancel_uid    = '0;
 
+    lm_ask_amend         = 'b0;
+    lm_ask_amend_tbl     = '0;
+
     lm_ask_reject_pop    = 'b0;
 
     // Ask query
@@ -471,7 +947,8 @@ module ob_cntrl (
 
       FSM_CNTRL_IDLE: begin
 
-        case ({cmdl_vld_r, rsp_out_vld_r})
+        case ({cmdl_vld_r,
+               (rsp_out_vld_r | ack_out_full_r | cmdl_trd_stall)})
           2'b1_0: begin
 
             // Command decode)
@@ -510,55 +987,96 @@ module ob_cntrl (
               ob_pkg::Op_BuyLimit: begin
                 ob_pkg::table_t lm_bid_table;
 
-                cmdl_consume          = 'b1;
+                case (cmdl_tif_qry)
+                  1'b1: begin
+                    // FOK/AON: qualify quantity available on the ask side
+                    // prior to installation; command is retained.
+                    lm_ask_qry_vld      = 'b1;
+                    lm_ask_qry_price    = cmdl_r.price;
+                    lm_ask_qry_quantity = cmdl_r.quantity;
 
-                lm_bid_table          = '0;
-                lm_bid_table.uid      = cmdl_r.uid;
-                lm_bid_table.quantity = cmdl_r.quantity;
-                lm_bid_table.price    = cmdl_r.price;
+                    mk_ask_qry_vld      = 'b1;
 
-                // Insert in Bid Table.
-                lm_bid_insert         = 'b1;
-                lm_bid_insert_tbl     = lm_bid_table;
+                    fsm_state_en        = 'b1;
+                    fsm_state_w         = FSM_CNTRL_TIF_QRY;
+                  end
+                  default: begin
+                    // GUC orders are consumed on installation, otherwise
+                    // retain command until its remainder has been killed.
+                    cmdl_consume          = (~cmdl_tif_kill);
 
-                // Emit out:
-                rsp_out_vld_w         = 'b1;
+                    tif_kill_en           = cmdl_tif_kill;
+                    tif_kill_w            = 'b1;
 
-                // From response:
-                rsp_out_w             = '0;
-                rsp_out_w.uid         = cmdl_r.uid;
-                rsp_out_w.status      = ob_pkg::S_Okay;
+                    lm_bid_table          = '0;
+                    lm_bid_table.uid      = cmdl_r.uid;
+                    lm_bid_table.quantity = cmdl_r.quantity;
+                    lm_bid_table.price    = cmdl_r.price;
 
-                // Next, query update table.
-                fsm_state_en          = 'b1;
-                fsm_state_w           = FSM_CNTRL_TABLE_ISSUE_QRY;
+                    // Insert in Bid Table.
+                    lm_bid_insert         = 'b1;
+                    lm_bid_insert_tbl     = lm_bid_table;
+
+                    // Emit out:
+                    rsp_out_vld_w         = 'b1;
+
+                    // From response:
+                    rsp_out_w             = '0;
+                    rsp_out_w.uid         = cmdl_r.uid;
+                    rsp_out_w.status      = ob_pkg::S_Okay;
+
+                    // Next, query update table.
+                    fsm_state_en          = 'b1;
+                    fsm_state_w           = FSM_CNTRL_TABLE_ISSUE_QRY;
+                  end
+                endcase // case (cmdl_tif_qry)
               end // case: ob_pkg::Op_BuyLimit
               ob_pkg::Op_SellLimit: begin
                 ob_pkg::table_t lm_ask_table;
 
-                cmdl_consume          = 'b1;
+                case (cmdl_tif_qry)
+                  1'b1: begin
+                    // FOK/AON: qualify quantity available on the bid side
+                    // prior to installation; command is retained.
+                    lm_bid_qry_vld      = 'b1;
+                    lm_bid_qry_price    = cmdl_r.price;
+                    lm_bid_qry_quantity = cmdl_r.quantity;
 
-                // Await result of install operation.
-                lm_ask_table          = '0;
-                lm_ask_table.uid      = cmdl_r.uid;
-                lm_ask_table.quantity = cmdl_r.quantity;
-                lm_ask_table.price    = cmdl_r.price;
+                    mk_bid_qry_vld      = 'b1;
 
-                // Insert in Ask Table.
-                lm_ask_insert         = 'b1;
-                lm_ask_insert_tbl     = lm_ask_table;
+                    fsm_state_en        = 'b1;
+                    fsm_state_w         = FSM_CNTRL_TIF_QRY;
+                  end
+                  default: begin
+                    // GUC orders are consumed on installation, otherwise
+                    // retain command until its remainder has been killed.
+                    cmdl_consume          = (~cmdl_tif_kill);
 
-                // Emit out:
-                rsp_out_vld_w         = 'b1;
+                    tif_kill_en           = cmdl_tif_kill;
+                    tif_kill_w            = 'b1;
 
-                // From response:
-                rsp_out_w             = '0;
-                rsp_out_w.uid         = cmdl_r.uid;
-                rsp_out_w.status      = ob_pkg::S_Okay;
+                    lm_ask_table          = '0;
+                    lm_ask_table.uid      = cmdl_r.uid;
+                    lm_ask_table.quantity = cmdl_r.quantity;
+                    lm_ask_table.price    = cmdl_r.price;
 
-                // Next, query update table.
-                fsm_state_en          = 'b1;
-                fsm_state_w           = FSM_CNTRL_TABLE_ISSUE_QRY;
+                    // Insert in Ask Table.
+                    lm_ask_insert         = 'b1;
+                    lm_ask_insert_tbl     = lm_ask_table;
+
+                    // Emit out:
+                    rsp_out_vld_w         = 'b1;
+
+                    // From response:
+                    rsp_out_w             = '0;
+                    rsp_out_w.uid         = cmdl_r.uid;
+                    rsp_out_w.status      = ob_pkg::S_Okay;
+
+                    // Next, query update table.
+                    fsm_state_en          = 'b1;
+                    fsm_state_w           = FSM_CNTRL_TABLE_ISSUE_QRY;
+                  end
+                endcase // case (cmdl_tif_qry)
               end // case: ob_pkg::Op_SellLimit
               ob_pkg::Op_PopTopBid: begin
                 // Consume command
@@ -626,17 +1144,40 @@ module ob_cntrl (
               end // case: ob_pkg::Op_Cancel
               ob_pkg::Op_BuyMarket: begin
                 // Market Buy command:
-                cmdl_consume = 'b1;
 
-                case ({mk_bid_full_r})
-                  1'b1: begin
+                case ({mk_bid_full_r, cmdl_tif_qry}) inside
+                  2'b1_?: begin
                     // Market sell buffer is full, command is rejected
-                    rsp_out_vld_w    = 'b1;
-                    rsp_out_w.uid    = cmdl_r.uid;
-                    rsp_out_w.status = ob_pkg::S_Reject;
-                    rsp_out_w.result = '0;
+                    cmdl_consume        = 'b1;
+
+                    rsp_out_vld_w       = 'b1;
+                    rsp_out_w.uid       = cmdl_r.uid;
+                    rsp_out_w.status    = ob_pkg::S_Reject;
+                    rsp_out_w.result    = '0;
+
+                    stats_reject_mk_bid = 'b1;
+                  end
+                  2'b0_1: begin
+                    // FOK/AON: qualify quantity available on the ask side
+                    // prior to installation; command is retained. Market
+                    // orders trade against all ask limit entries.
+                    lm_ask_qry_vld             = 'b1;
+                    lm_ask_qry_price           = bcd_pkg::PRICE_MAX;
+                    lm_ask_qry_quantity        = cmdl_r.quantity;
+
+                    mk_ask_qry_vld             = 'b1;
+
+                    fsm_state_en               = 'b1;
+                    fsm_state_w                = FSM_CNTRL_TIF_QRY;
                   end
                   default: begin
+                    // GUC orders are consumed on installation, otherwise
+                    // retain command until its remainder has been killed.
+                    cmdl_consume               = (~cmdl_tif_kill);
+
+                    tif_kill_en                = cmdl_tif_kill;
+                    tif_kill_w                 = 'b1;
+
                     // Insert into table.
                     mk_bid_insert              = 'b1;
                     mk_bid_insert_tbl          = '0;
@@ -654,21 +1195,44 @@ module ob_cntrl (
                     fsm_state_en               = 1'b1;
                     fsm_state_w                = FSM_CNTRL_TABLE_ISSUE_QRY;
                   end
-                endcase // case ({mk_bid_full_r})
+                endcase // case ({mk_bid_full_r, cmdl_tif_qry})
               end // case: ob_pkg::Op_BuyMarket
               ob_pkg::Op_SellMarket: begin
                 // Market Sell command:
-                cmdl_consume = 'b1;
 
-                case ({mk_ask_full_r})
-                  1'b1: begin
+                case ({mk_ask_full_r, cmdl_tif_qry}) inside
+                  2'b1_?: begin
                     // Market sell buffer is full, command is rejected
-                    rsp_out_vld_w    = 'b1;
-                    rsp_out_w.uid    = cmdl_r.uid;
-                    rsp_out_w.status = ob_pkg::S_Reject;
-                    rsp_out_w.result = '0;
+                    cmdl_consume        = 'b1;
+
+                    rsp_out_vld_w       = 'b1;
+                    rsp_out_w.uid       = cmdl_r.uid;
+                    rsp_out_w.status    = ob_pkg::S_Reject;
+                    rsp_out_w.result    = '0;
+
+                    stats_reject_mk_ask = 'b1;
+                  end
+                  2'b0_1: begin
+                    // FOK/AON: qualify quantity available on the bid side
+                    // prior to installation; command is retained. Market
+                    // orders trade against all bid limit entries.
+                    lm_bid_qry_vld             = 'b1;
+                    lm_bid_qry_price           = bcd_pkg::PRICE_MIN;
+                    lm_bid_qry_quantity        = cmdl_r.quantity;
+
+                    mk_bid_qry_vld             = 'b1;
+
+                    fsm_state_en               = 'b1;
+                    fsm_state_w                = FSM_CNTRL_TIF_QRY;
                   end
                   default: begin
+                    // GUC orders are consumed on installation, otherwise
+                    // retain command until its remainder has been killed.
+                    cmdl_consume               = (~cmdl_tif_kill);
+
+                    tif_kill_en                = cmdl_tif_kill;
+                    tif_kill_w                 = 'b1;
+
                     // Insert into table.
                     mk_ask_insert              = 'b1;
                     mk_ask_insert_tbl          = '0;
@@ -686,7 +1250,7 @@ module ob_cntrl (
                     fsm_state_en               = 1'b1;
                     fsm_state_w                = FSM_CNTRL_TABLE_ISSUE_QRY;
                   end
-                endcase // case ({mk_ask_full_r})
+                endcase // case ({mk_ask_full_r, cmdl_tif_qry})
               end // case: ob_pkg::Op_SellMarket
               ob_pkg::Op_QryTblAskLe: begin
                 // Retain command at cmdl.
@@ -728,7 +1292,7 @@ module ob_cntrl (
                 rsp_out_w     = '0;
                 rsp_out_w.uid = cmdl_r.uid;
 
-                case ({cn_full_r}) inside
+                case ({cmdl_cn_full}) inside
                   1'b0: begin
 
                     // Consume command: is issued to CN unit.
@@ -748,12 +1312,139 @@ module ob_cntrl (
                     // Reject command.
                     rsp_out_vld_w    = 'b1;
                     rsp_out_w.status = ob_pkg::S_Reject;
+
+                    stats_reject_cn_buy  = cmdl_cn_is_buy;
+                    stats_reject_cn_sell = (~cmdl_cn_is_buy);
                   end
                   default: begin
                     // Stall current command awaiting output buffer entry.
                   end
                 endcase
               end // case: ob_pkg::Op_BuyStopLoss,...
+              ob_pkg::Op_QryDepthBid,
+              ob_pkg::Op_QryDepthAsk: begin
+
+                case (depth_head_vld)
+                  1'b1: begin
+                    // Retain command at cmdl; walk table from the head.
+                    depth_idx_en     = 'b1;
+                    depth_idx_w      = '0;
+                    depth_lvl_en     = 'b1;
+                    depth_lvl_w      = '0;
+                    depth_open_en    = 'b1;
+                    depth_open_w     = 'b0;
+
+                    fsm_state_en     = 'b1;
+                    fsm_state_w      = FSM_CNTRL_QRY_DEPTH;
+                  end
+                  default: begin
+                    // Table is empty, command cannot complete.
+                    cmdl_consume     = 'b1;
+
+                    rsp_out_vld_w    = 'b1;
+                    rsp_out_w        = '0;
+                    rsp_out_w.uid    = cmdl_r.uid;
+                    rsp_out_w.status = ob_pkg::S_Bad;
+                  end
+                endcase // case (depth_head_vld)
+              end // case: ob_pkg::Op_QryDepthBid,...
+              ob_pkg::Op_MassCancel: begin
+                // Retain command at cmdl; walk the tables from the Bid limit
+                // table onwards.
+                depth_idx_en     = 'b1;
+                depth_idx_w      = '0;
+                mc_phase_en      = 'b1;
+                mc_phase_w       = MC_LM_BID;
+                mc_n_en          = 'b1;
+                mc_n_w           = '0;
+
+                fsm_state_en     = 'b1;
+                fsm_state_w      = FSM_CNTRL_MCANCEL;
+              end // case: ob_pkg::Op_MassCancel
+              ob_pkg::Op_Replace: begin
+                ob_pkg::table_t amend_tbl;
+
+                amend_tbl          = '0;
+                amend_tbl.uid      = cmdl_r.uid1;
+                amend_tbl.quantity = cmdl_r.quantity;
+                amend_tbl.price    = cmdl_r.price;
+
+                // Issue amend op. to Bid table.
+                lm_bid_amend       = 'b1;
+                lm_bid_amend_tbl   = amend_tbl;
+
+                // Issue amend op. to Ask table.
+                lm_ask_amend       = 'b1;
+                lm_ask_amend_tbl   = amend_tbl;
+
+                // Retain command; await amend response.
+                fsm_state_en       = 'b1;
+                fsm_state_w        = FSM_CNTRL_REPLACE_RESP;
+              end // case: ob_pkg::Op_Replace
+              ob_pkg::Op_QryStats: begin
+                // Retain command at cmdl; stream counters from the first.
+                stats_id_en        = 'b1;
+                stats_id_w         = '0;
+
+                fsm_state_en       = 'b1;
+                fsm_state_w        = FSM_CNTRL_QRY_STATS;
+              end // case: ob_pkg::Op_QryStats
+              ob_pkg::Op_QrySnapshot: begin
+                // Retain command at cmdl; walk the tables from the head of
+                // the Bid limit table onwards.
+                depth_idx_en       = 'b1;
+                depth_idx_w        = '0;
+                snap_phase_en      = 'b1;
+                snap_phase_w       = SNAP_LM_BID;
+                snap_ext_en        = 'b1;
+                snap_ext_w         = 'b0;
+
+                fsm_state_en       = 'b1;
+                fsm_state_w        = FSM_CNTRL_SNAPSHOT;
+              end // case: ob_pkg::Op_QrySnapshot
+              ob_pkg::Op_LoadBid,
+              ob_pkg::Op_LoadAsk: begin
+                ob_pkg::table_t load_tbl;
+                logic           load_is_ask;
+                logic           load_full;
+
+                // Bulk load: install the entry directly into the nominated
+                // limit table, bypassing matching. Entries are presented in
+                // priority order by the host, therefore each is appended
+                // behind those of equal price. A full table rejects the
+                // entry rather than displacing its tail.
+                load_is_ask        = (cmdl_r.opcode == ob_pkg::Op_LoadAsk);
+                load_full          = load_is_ask ? lm_ask_full_r : lm_bid_full_r;
+
+                load_tbl           = '0;
+                load_tbl.uid       = cmdl_r.uid;
+                load_tbl.quantity  = cmdl_r.quantity;
+                load_tbl.price     = cmdl_r.price;
+
+                // Consume command
+                cmdl_consume       = 'b1;
+
+                rsp_out_vld_w      = 'b1;
+                rsp_out_w          = '0;
+                rsp_out_w.uid      = cmdl_r.uid;
+
+                case ({load_is_ask, load_full}) inside
+                  2'b0_0: begin
+                    lm_bid_insert     = 'b1;
+                    lm_bid_insert_tbl = load_tbl;
+                    rsp_out_w.status  = ob_pkg::S_Okay;
+                  end
+                  2'b1_0: begin
+                    lm_ask_insert     = 'b1;
+                    lm_ask_insert_tbl = load_tbl;
+                    rsp_out_w.status  = ob_pkg::S_Okay;
+                  end
+                  default: begin
+                    // Table is full; entry cannot be installed.
+                    rsp_out_w.status  = ob_pkg::S_Reject;
+                  end
+                endcase // case ({load_is_ask, load_full})
+              end // case: ob_pkg::Op_LoadBid,...
               default: begin
                 // Invalid op:
               end
@@ -762,12 +1453,12 @@ module ob_cntrl (
           default: begin
             // Otherwise, blocked awaiting resources.
           end
-        endcase // case (cmdl_vld_r, rsp_out_vld_r)
+        endcase // case (cmdl_vld_r, ...)
 
       end // case: FSM_CNTRL_IDLE
 
       FSM_CNTRL_CANCEL_RESP: begin
-        if (!rsp_out_full_r) begin
+        if (!ack_out_full_r) begin
         // In this state, the response to the prior cancel request has
         // been collated and is known. From this, form the final response
         // for the command to the egress queue and consume the command.
@@ -817,6 +1508,9 @@ module ob_cntrl (
           end
         endcase // case ({...
 
+        stats_cancel_hit  = (rsp_out_w.status == ob_pkg::S_CancelHit);
+        stats_cancel_miss = (rsp_out_w.status == ob_pkg::S_CancelMiss);
+
         // Advance to next state.
           fsm_state_en = 'b1;
           fsm_state_w  = FSM_CNTRL_IDLE;
@@ -824,6 +1518,69 @@ module ob_cntrl (
 
       end // case: FSM_CNTRL_CANCEL_RESP
 
+      FSM_CNTRL_REPLACE_RESP: begin
+        if (!ack_out_full_r) begin
+        // In this state, the outcome of the prior amend operation is
+        // known. An entry amended in place is complete; an entry which has
+        // been removed is reinserted at its new price (losing its priority)
+        // and the book is then re-examined for trades.
+        //
+        ob_pkg::table_t replace_tbl;
+
+        replace_tbl          = '0;
+        replace_tbl.uid      = cmdl_r.uid1;
+        replace_tbl.quantity = cmdl_r.quantity;
+        replace_tbl.price    = cmdl_r.price;
+
+        // Consume command.
+        cmdl_consume     = 'b1;
+
+        rsp_out_vld_w    = 'b1;
+        rsp_out_w        = '0;
+        rsp_out_w.uid    = cmdl_r.uid;
+        rsp_out_w.status = ob_pkg::S_Okay;
+
+        fsm_state_en     = 'b1;
+        fsm_state_w      = FSM_CNTRL_IDLE;
+
+        case ({// Bid limit table hits amend
+               lm_bid_amend_hit_r,
+               // Ask limit table hits amend
+               lm_ask_amend_hit_r,
+               // Amended in place
+               (lm_bid_amend_inplace_r | lm_ask_amend_inplace_r),
+               // Amended quantity is non-zero
+               (cmdl_r.quantity != '0)
+               }) inside
+          4'b??_1_?: begin
+            // Amended in place; priority retained.
+          end
+          4'b1?_0_1: begin
+            // Reinsert in Bid table.
+            lm_bid_insert     = 'b1;
+            lm_bid_insert_tbl = replace_tbl;
+
+            fsm_state_w       = FSM_CNTRL_TABLE_ISSUE_QRY;
+          end
+          4'b01_0_1: begin
+            // Reinsert in Ask table.
+            lm_ask_insert     = 'b1;
+            lm_ask_insert_tbl = replace_tbl;
+
+            fsm_state_w       = FSM_CNTRL_TABLE_ISSUE_QRY;
+          end
+          4'b1?_0_0, 4'b01_0_0: begin
+            // Amended to zero quantity; order is cancelled.
+          end
+          default: begin
+            // Miss, UID not found
+            rsp_out_w.status = ob_pkg::S_CancelMiss;
+          end
+        endcase // case ({...
+        end
+
+      end // case: FSM_CNTRL_REPLACE_RESP
+
       FSM_CNTRL_TABLE_ISSUE_QRY: begin
         // In this state, the state of the table has been updated with
         // a prior Bid/Ask installation. Now, query the state of the
@@ -849,18 +1606,26 @@ module ob_cntrl (
         // presence of successfully trades, the rejected entries may
         // transition back to the unrejected state.
         //
-        case  ({// Output response queue is not full
-                rsp_out_full_r,
+        // Rejects are deferred whilst the remainder of a non-GUC order is
+        // pending its kill. The cancel issued in TIF_CANCEL shifts any entry
+        // displaced by the remainder back into the table, or removes the
+        // remainder itself from the reject slot, such that a resting order
+        // is never rejected in favour of an order which is not to rest.
+        //
+        case  ({// Trade channel is full
+                trd_out_full_r,
+                // Ack channel is full
+                ack_out_full_r,
                 // Limit controller hits possible trade
                 lm_trade_vld_r,
                 // Market controller hits possible trade
                 mk_trade_vld_r,
                 // The Bid table has a reject entry.
-                lm_bid_reject_vld_r,
+                lm_bid_reject_vld_r & ~tif_kill_r,
                 // The Ask table has a reject entry.
-                lm_ask_reject_vld_r
+                lm_ask_reject_vld_r & ~tif_kill_r
                 }) inside
-          5'b01???, 5'b001??: begin
+          6'b0?_1???, 6'b0?_01??: begin
             ob_pkg::search_result_t sr;
             // Select matching controller, prefer limit.
             sr         = lm_trade_vld_r ? lm_trade_r : mk_trade_r;
@@ -1036,11 +1801,18 @@ module ob_cntrl (
             rsp_out_w.result.trade.ask_uid  = sr.ask_uid;
             rsp_out_w.result.trade.quantity = sr.quantity;
 
+            stats_trade                     = 'b1;
+
             // Return to query state to attempt further trades.
             fsm_state_en                    = 'b1;
             fsm_state_w                     = FSM_CNTRL_TABLE_ISSUE_QRY;
           end // case: inside...
-          5'b0001?: begin
+          6'b1?_1???, 6'b1?_01??: begin
+            // Stalled on trade channel. Unreachable where the trade egress
+            // queue holds a full sweep, as commands which may trade are
+            // admitted only once it has room (see trd_PROC).
+          end
+          6'b?0_001?: begin
             // Execute bid reject
             lm_bid_reject_pop = 'b1;
 
@@ -1053,7 +1825,7 @@ module ob_cntrl (
             rsp_out_w.status  = ob_pkg::S_Reject;
             rsp_out_w.result  = '0;
           end
-          5'b00001: begin
+          6'b?0_0001: begin
             // Execute ask reject
             lm_ask_reject_pop = 'b1;
 
@@ -1066,22 +1838,23 @@ module ob_cntrl (
             rsp_out_w.status  = ob_pkg::S_Reject;
             rsp_out_w.result  = '0;
           end
-          5'b1????: begin
-              // Stalled on output resources.
+          6'b?1_001?, 6'b?1_0001: begin
+            // Stalled on ack channel.
           end
           default: begin
             // Consume command
 
-            // Otherwise, no further work. Return to IDLE state.
+            // Otherwise, no further work. Return to IDLE state, or kill the
+            // remainder of the order at cmdl if it is not GUC.
             fsm_state_en = 'b1;
-            fsm_state_w  = FSM_CNTRL_IDLE;
+            fsm_state_w  = tif_kill_r ? FSM_CNTRL_TIF_CANCEL : FSM_CNTRL_IDLE;
           end
         endcase // case ({...
 
       end // case: FSM_CNTRL_TABLE_EXECUTE
 
       FSM_CNTRL_QRY_TBL: begin
-        if (!rsp_out_full_r) begin
+        if (!ack_out_full_r) begin
 
         // Response defaults:
         rsp_out_w        = '0;
@@ -1141,13 +1914,354 @@ module ob_cntrl (
 
       end // case: FSM_CNTRL_QRY_TBL
 
+      FSM_CNTRL_TIF_QRY: begin
+        // In this state, await the count of the quantity available on the
+        // side opposing the FOK/AON order at cmdl. If the order can execute
+        // in its entirety, return to IDLE where it is now installed as an
+        // ordinary IOC order. Otherwise, kill the order without execution.
+        //
+        if (!ack_out_full_r) begin
+
+        case ({tif_qry_rsp_vld, tif_qry_attained}) inside
+          2'b1_1: begin
+            // Order qualifies; retain command and install.
+            tif_fill_en      = 'b1;
+            tif_fill_w       = 'b1;
+
+            fsm_state_en     = 'b1;
+            fsm_state_w      = FSM_CNTRL_IDLE;
+          end
+          2'b1_0: begin
+            // Order does not qualify, consume command.
+            cmdl_consume     = 'b1;
+
+            // Emit response:
+            rsp_out_vld_w    = 'b1;
+            rsp_out_w        = '0;
+            rsp_out_w.uid    = cmdl_r.uid;
+            rsp_out_w.status = ob_pkg::S_Killed;
+
+            fsm_state_en     = 'b1;
+            fsm_state_w      = FSM_CNTRL_IDLE;
+          end
+          default: begin
+            // Otherwise, continue to await completion of counter
+            // operations.
+          end
+        endcase // case ({tif_qry_rsp_vld, tif_qry_attained})
+
+        end
+
+      end // case: FSM_CNTRL_TIF_QRY
+
+      FSM_CNTRL_TIF_CANCEL: begin
+        // In this state, matching on the IOC/FOK order at cmdl has completed.
+        // Cancel whatever remains of the order from the tables. Issue only
+        // when the egress queue is non-full, as the response state does not
+        // support back-pressure.
+        //
+        if (!ack_out_full_r) begin
+
+        // Issue cancel op. to Bid/Ask tables.
+        lm_bid_cancel     = 'b1;
+        lm_bid_cancel_uid = cmdl_r.uid;
+
+        lm_ask_cancel     = 'b1;
+        lm_ask_cancel_uid = cmdl_r.uid;
+
+        // Issue cancel op. to Bid/Ask tables (market).
+        mk_bid_cancel     = 'b1;
+        mk_bid_cancel_uid = cmdl_r.uid;
+
+        mk_ask_cancel     = 'b1;
+        mk_ask_cancel_uid = cmdl_r.uid;
+
+        fsm_state_en      = 'b1;
+        fsm_state_w       = FSM_CNTRL_TIF_RESP;
+
+        end
+
+      end // case: FSM_CNTRL_TIF_CANCEL
+
+      FSM_CNTRL_TIF_RESP: begin
+        // In this state, the outcome of the prior cancel is known. Should
+        // some remainder of the order have been present, it is now killed;
+        // otherwise the order executed in its entirety and no further
+        // response is emitted. Any reject deferred in TABLE_EXECUTE has
+        // been resolved by the cancel.
+        //
+
+        // Consume command.
+        cmdl_consume     = 'b1;
+
+        tif_kill_en      = 'b1;
+        tif_kill_w       = 'b0;
+
+        rsp_out_vld_w    = (lm_bid_cancel_hit_r | lm_ask_cancel_hit_r |
+                            mk_bid_cancel_hit_r | mk_ask_cancel_hit_r);
+        rsp_out_w        = '0;
+        rsp_out_w.uid    = cmdl_r.uid;
+        rsp_out_w.status = ob_pkg::S_Killed;
+
+        fsm_state_en     = 'b1;
+        fsm_state_w      = FSM_CNTRL_IDLE;
+      end // case: FSM_CNTRL_TIF_RESP
+
+      FSM_CNTRL_QRY_DEPTH: begin
+        // In this state, walk the limit table nominated by the command at
+        // cmdl (see depth_PROC). Entries are accumulated regardless of the
+        // state of the egress queue, whereas completed levels are emitted
+        // only when the egress queue is non-full and no response was emitted
+        // in the prior cycle.
+        //
+        case ({// Entry contributes to the current level
+               depth_rd_same,
+               // Stalled on output resources.
+               (ack_out_full_r | rsp_out_vld_r)
+               }) inside
+          2'b1_?: begin
+            // Accumulate entry into level; advance to next entry.
+            depth_idx_en     = 'b1;
+            depth_idx_w      = depth_idx_r + 'b1;
+
+            depth_open_en    = 'b1;
+            depth_open_w     = 'b1;
+
+            depth_price_en   = 'b1;
+            depth_price_w    = depth_rd_tbl.price;
+
+            depth_accum_en   = 'b1;
+            depth_accum_w    = (depth_open_r ? depth_accum_r : '0) +
+                               ob_pkg::accum_quantity_t'(depth_rd_tbl.quantity);
+          end
+          2'b0_0: begin
+            // Emit completed level.
+            rsp_out_vld_w                = 'b1;
+            rsp_out_w                    = '0;
+            rsp_out_w.uid                = cmdl_r.uid;
+            rsp_out_w.status             = ob_pkg::S_Okay;
+            rsp_out_w.result.depth.last  = depth_last;
+            rsp_out_w.result.depth.level = depth_lvl_r;
+            rsp_out_w.result.depth.price = depth_price_r;
+            rsp_out_w.result.depth.accum = depth_accum_r;
+
+            // Open next level on the current entry.
+            depth_lvl_en     = 'b1;
+            depth_lvl_w      = depth_lvl_r + 'b1;
+
+            depth_open_en    = 'b1;
+            depth_open_w     = 'b0;
+
+            if (depth_last) begin
+              // Snapshot complete; consume command.
+              cmdl_consume   = 'b1;
+
+              fsm_state_en   = 'b1;
+              fsm_state_w    = FSM_CNTRL_IDLE;
+            end
+          end
+          default: begin
+            // Stalled on output resources.
+          end
+        endcase // case ({depth_rd_same, ...
+
+      end // case: FSM_CNTRL_QRY_DEPTH
+
+      FSM_CNTRL_MCANCEL: begin
+        // In this state, walk the tables nominated by the mass cancel command
+        // at cmdl (see mc_PROC); one entry per cycle. Cancelled entries are
+        // streamed to the egress queue, therefore the walk advances only
+        // when the egress queue is non-full and no response was emitted in
+        // the prior cycle.
+        //
+        case ({// Stalled on output resources.
+               (ack_out_full_r | rsp_out_vld_r),
+               // All tables have been visited.
+               (mc_phase_r == MC_DONE),
+               // Current table has been exhausted.
+               mc_phase_done,
+               // Current entry is to be cancelled.
+               mc_match
+               }) inside
+          4'b0_1_??: begin
+            // Emit final response, denoting the number of cancelled
+            // entries, and consume command.
+            rsp_out_vld_w                = 'b1;
+            rsp_out_w                    = '0;
+            rsp_out_w.uid                = cmdl_r.uid;
+            rsp_out_w.status             = ob_pkg::S_Okay;
+            rsp_out_w.result.qry.accum   = mc_n_r;
+
+            cmdl_consume                 = 'b1;
+
+            fsm_state_en                 = 'b1;
+            fsm_state_w                  = FSM_CNTRL_IDLE;
+          end
+          4'b0_0_1_?: begin
+            // Advance to the next table.
+            depth_idx_en                 = 'b1;
+            depth_idx_w                  = '0;
+            mc_phase_en                  = 'b1;
+            mc_phase_w                   = mc_phase_t'(mc_phase_r + 'b1);
+          end
+          4'b0_0_0_1: begin
+            // Cancel current entry and emit it.
+            case (mc_phase_r)
+              MC_LM_BID: begin
+                lm_bid_cancel            = 'b1;
+                lm_bid_cancel_uid        = mc_rd_tbl.uid;
+              end
+              MC_MK_BID: begin
+                mk_bid_cancel            = 'b1;
+                mk_bid_cancel_uid        = mc_rd_tbl.uid;
+              end
+              MC_LM_ASK: begin
+                lm_ask_cancel            = 'b1;
+                lm_ask_cancel_uid        = mc_rd_tbl.uid;
+              end
+              MC_MK_ASK: begin
+                mk_ask_cancel            = 'b1;
+                mk_ask_cancel_uid        = mc_rd_tbl.uid;
+              end
+              default: ;
+            endcase // case (mc_phase_r)
+
+            rsp_out_vld_w                    = 'b1;
+            rsp_out_w                        = '0;
+            rsp_out_w.uid                    = cmdl_r.uid;
+            rsp_out_w.status                 = ob_pkg::S_CancelHit;
+            rsp_out_w.result.poptop.price    = mc_rd_tbl.price;
+            rsp_out_w.result.poptop.quantity = mc_rd_tbl.quantity;
+            rsp_out_w.result.poptop.uid      = mc_rd_tbl.uid;
+
+            mc_n_en                          = 'b1;
+            mc_n_w                           = mc_n_r + 'b1;
+          end
+          4'b0_0_0_0: begin
+            // Entry is outside of the nominated range; advance to next.
+            depth_idx_en                 = 'b1;
+            depth_idx_w                  = depth_idx_r + 'b1;
+          end
+          default: begin
+            // Stalled on output resources.
+          end
+        endcase // case ({...
+
+      end // case: FSM_CNTRL_MCANCEL
+
+      FSM_CNTRL_QRY_STATS: begin
+        // In this state, stream the performance counters, one per cycle, in
+        // ascending order of identifier. A counter is emitted only when the
+        // egress queue is non-full and no response was emitted in the prior
+        // cycle. Counters continue to advance during the stream, therefore
+        // each response is a snapshot of its counter at the point of
+        // emission.
+        //
+        if (!(ack_out_full_r | rsp_out_vld_r)) begin
+          rsp_out_vld_w                = 'b1;
+          rsp_out_w                    = '0;
+          rsp_out_w.uid                = cmdl_r.uid;
+          rsp_out_w.status             = ob_pkg::S_Okay;
+          rsp_out_w.result.stats.last  =
+            (stats_id_r == ob_pkg::stats_id_t'(ob_pkg::STATS_N - 1));
+          rsp_out_w.result.stats.id    = stats_id_r;
+          rsp_out_w.result.stats.value = stats_rd_cnt;
+
+          stats_id_en                  = 'b1;
+          stats_id_w                   = stats_id_r + 'b1;
+
+          if (rsp_out_w.result.stats.last) begin
+            // Stream complete; consume command.
+            cmdl_consume               = 'b1;
+
+            fsm_state_en               = 'b1;
+            fsm_state_w                = FSM_CNTRL_IDLE;
+          end
+        end
+
+      end // case: FSM_CNTRL_QRY_STATS
+
+      FSM_CNTRL_SNAPSHOT: begin
+        // In this state, walk the tables in turn (see snap_PROC), emitting
+        // one response per entry. Entries are emitted only when the egress
+        // queue is non-full and no response was emitted in the prior cycle,
+        // whereas exhausted tables are skipped regardless. The tables are
+        // modified only by the controller and are therefore stable for the
+        // duration of the walk (a conditional command which has matured to
+        // the maturity latch, but has yet to issue, is not reflected). On
+        // completion, a final response (last) is emitted and the command is
+        // consumed.
+        //
+        case ({// All tables have been visited.
+               (snap_phase_r == SNAP_DONE),
+               // Current table has been exhausted.
+               (~snap_rd_vld),
+               // Stalled on output resources.
+               (ack_out_full_r | rsp_out_vld_r)
+               }) inside
+          3'b1_?_0: begin
+            // Emit final response and consume command.
+            rsp_out_vld_w                  = 'b1;
+            rsp_out_w                      = '0;
+            rsp_out_w.uid                  = cmdl_r.uid;
+            rsp_out_w.status               = ob_pkg::S_Okay;
+            rsp_out_w.result.snapshot.last = 'b1;
+
+            cmdl_consume                   = 'b1;
+
+            fsm_state_en                   = 'b1;
+            fsm_state_w                    = FSM_CNTRL_IDLE;
+          end
+          3'b0_1_?: begin
+            // Advance to the next table.
+            depth_idx_en                 = 'b1;
+            depth_idx_w                  = '0;
+            snap_phase_en                = 'b1;
+            snap_phase_w                 = snap_phase_t'(snap_phase_r + 'b1);
+          end
+          3'b0_0_0: begin
+            // Emit current entry.
+            rsp_out_vld_w                = 'b1;
+            rsp_out_w                    = '0;
+            rsp_out_w.uid                = cmdl_r.uid;
+            rsp_out_w.status             = ob_pkg::S_Okay;
+            rsp_out_w.result.snapshot    = snap_entry;
+
+            // Conditional entries are followed by their extension before
+            // advancing to the next entry.
+            snap_ext_en                  = 'b1;
+            snap_ext_w                   = snap_is_cn & (~snap_ext_r);
+
+            depth_idx_en                 = ~(snap_is_cn & (~snap_ext_r));
+            depth_idx_w                  = depth_idx_r + 'b1;
+          end
+          default: begin
+            // Stalled on output resources.
+          end
+        endcase // case ({...
+
+      end // case: FSM_CNTRL_SNAPSHOT
+
       default:;
 
     endcase // case (fsm_state_r)
 
+    // Stamp response with the acceptance time of the command at cmdl (being
+    // the command by which it was produced) and the current time.
+`ifdef OB_CFG_RSP_TIMESTAMP_EN
+    rsp_out_w.ts_accept = cmdl_ts_r;
+    rsp_out_w.ts_emit   = ts_r;
+`endif
+
     // Latch output on becoming valid.
     rsp_out_en = rsp_out_vld_w;
 
+    // FOK/AON qualification is discarded once the command is consumed.
+    if (cmdl_consume) begin
+      tif_fill_en = 'b1;
+      tif_fill_w  = 'b0;
+    end
+
   end // block: cntrl_PROC
 
   // ------------------------------------------------------------------------ //
@@ -1192,6 +2306,38 @@ module ob_cntrl (
     , .rst                         (rst                     )
   );
 
+  // ------------------------------------------------------------------------ //
+  //
+  ob_stats u_ob_stats (
+    //
+      .cmd_vld                     (cmdl_fetch              )
+    , .cmd_opcode                  (cmd_in.opcode           )
+    //
+    , .trade                       (stats_trade             )
+    //
+    , .reject_lm_bid               (lm_bid_reject_pop       )
+    , .reject_lm_ask               (lm_ask_reject_pop       )
+    , .reject_mk_bid               (stats_reject_mk_bid     )
+    , .reject_mk_ask               (stats_reject_mk_ask     )
+    , .reject_cn_buy               (stats_reject_cn_buy     )
+    , .reject_cn_sell              (stats_reject_cn_sell    )
+    //
+    , .cancel_hit                  (stats_cancel_hit        )
+    , .cancel_miss                 (stats_cancel_miss       )
+    //
+    , .cn_mtr                      (cn_mtr_accept           )
+    //
+    , .egress_stall                (stats_egress_stall      )
+    //
+    , .fsm_state_r                 (fsm_state_r             )
+    //
+    , .rd_id                       (stats_id_r              )
+    , .rd_cnt                      (stats_rd_cnt            )
+    //
+    , .clk                         (clk                     )
+    , .rst                         (rst                     )
+  );
+
   // ------------------------------------------------------------------------ //
   //
   ob_cntrl_mk u_ob_cntrl_mk (
@@ -0,0 +1,204 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+`default_nettype none
+`timescale 1ns/1ps
+
+`include "ob_pkg.vh"
+`include "macros_pkg.vh"
+
+// Egress response buffer. Responses emitted by the controller are striped,
+// in order, across W lane queues such that upto W responses may be presented
+// on the response interface per beat. Valid lanes are contiguous from lane 0
+// (the oldest response) and all valid lanes are consumed on accept.
+//
+// A single response is pushed per cycle, as the controller emits no more than
+// one per cycle; lanes do not raise the peak response rate. Rather, they allow
+// a consumer accepting once every W cycles to keep pace with the controller,
+// and a backlog accumulated under backpressure to drain W per beat.
+//
+// 'room_r' denotes that R further responses may be pushed without the buffer
+// becoming full (or, where R exceeds the capacity of the buffer, that the
+// buffer is empty).
+//
+module ob_egress #(
+    parameter int N = 4
+  , parameter int W = 1
+  , parameter int R = 1
+) (
+
+  // ======================================================================== //
+  // Controller Interface
+    input                                         push
+  , input ob_pkg::rsp_t                           push_data
+  //
+  , output logic                                  full_r
+  , output logic                                  room_r
+
+  // ======================================================================== //
+  // Response Interface
+  , input                                         rsp_accept
+  //
+  , output logic [W - 1:0]                        rsp_vld
+  , output ob_pkg::rsp_t [W - 1:0]                rsp
+
+  // ======================================================================== //
+  // Clk/Reset
+  , input                                         clk
+  , input                                         rst
+);
+
+  // ======================================================================== //
+  //                                                                          //
+  // Helper functions                                                         //
+  //                                                                          //
+  // ======================================================================== //
+
+  typedef logic [$clog2(W):0]           ptr_t;
+  typedef logic [$clog2(N * W + 1) - 1:0] cnt_t;
+
+  // Free entries required for 'room_r'.
+  localparam int ROOM_N = (R < (N * W)) ? R : (N * W);
+
+  // Lane index at offset 'i' from pointer 'p'.
+  function automatic ptr_t lane(ptr_t p, int i); begin
+    lane  = ptr_t'((int'(p) + i) % W);
+  end endfunction
+
+  // ======================================================================== //
+  //                                                                          //
+  // Wires                                                                    //
+  //                                                                          //
+  // ======================================================================== //
+
+  logic [W - 1:0]                       lane_push;
+  logic [W - 1:0]                       lane_pop;
+  ob_pkg::rsp_t [W - 1:0]               lane_pop_data;
+  logic [W - 1:0]                       lane_empty_w;
+  logic [W - 1:0]                       lane_full_w;
+  logic                                 lane_vld;
+
+  `LIBV_REG_RST_R(logic [W - 1:0], lane_empty, '1);
+  `LIBV_REG_RST_R(logic [W - 1:0], lane_full, '0);
+  `LIBV_REG_EN_RST(ptr_t, wr_ptr, '0);
+  `LIBV_REG_EN_RST(ptr_t, rd_ptr, '0);
+  `LIBV_REG_EN_RST(cnt_t, occ, '0);
+  `LIBV_REG_RST_W(logic, room, 'b1);
+
+  // ======================================================================== //
+  //                                                                          //
+  // Combinatorial Logic                                                      //
+  //                                                                          //
+  // ======================================================================== //
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : in_PROC
+
+    // Responses are written to lanes in round-robin order.
+    lane_push            = '0;
+    lane_push [wr_ptr_r] = push;
+
+    wr_ptr_en            = push;
+    wr_ptr_w             = lane(wr_ptr_r, 1);
+
+    // Conservatively full when any lane is full.
+    full_r               = (lane_full_r != '0);
+
+  end // block: in_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : out_PROC
+
+    rsp       = '0;
+    rsp_vld   = '0;
+    lane_pop  = '0;
+    lane_vld  = 'b1;
+
+    // Lane 'i' of the beat is sourced from lane queue 'rd_ptr + i' and is
+    // valid only if all older responses are also present.
+    for (int i = 0; i < W; i++) begin
+      lane_vld                     &= (~lane_empty_r [lane(rd_ptr_r, i)]);
+      rsp_vld [i]                   = lane_vld;
+      rsp [i]                       = lane_pop_data [lane(rd_ptr_r, i)];
+      lane_pop [lane(rd_ptr_r, i)]  = (lane_vld & rsp_accept);
+    end
+
+    rd_ptr_en  = (rsp_vld [0] & rsp_accept);
+    rd_ptr_w   = lane(rd_ptr_r, $countones(rsp_vld));
+
+  end // block: out_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : room_PROC
+
+    // Occupancy; one response is pushed, and upto W are popped, per cycle.
+    // Lanes are written in round-robin order, therefore remain balanced, and
+    // total occupancy alone determines the room available.
+    occ_en   = (push | rd_ptr_en);
+    occ_w    =   occ_r
+               + cnt_t'(push)
+               - (rd_ptr_en ? cnt_t'($countones(rsp_vld)) : '0);
+
+    room_w   = (occ_w <= cnt_t'((N * W) - ROOM_N));
+
+  end // block: room_PROC
+
+  // ======================================================================== //
+  //                                                                          //
+  // Instances                                                                //
+  //                                                                          //
+  // ======================================================================== //
+
+  // ------------------------------------------------------------------------ //
+  //
+  for (genvar g = 0; g < W; g++) begin : lane_GEN
+
+    libv_queue #(.W($bits(ob_pkg::rsp_t)), .N(N)) u_lane_queue (
+      //
+        .push              (lane_push [g]           )
+      , .push_data         (push_data               )
+      //
+      , .pop               (lane_pop [g]            )
+      , .pop_data          (lane_pop_data [g]       )
+      //
+      , .flush             ('b0                     )
+      , .commit            (lane_pop [g]            )
+      , .replay            ('b0                     )
+      //
+      , .empty_w           (lane_empty_w [g]        )
+      , .full_w            (lane_full_w [g]         )
+      //
+      , .clk               (clk                     )
+      , .rst               (rst                     )
+    );
+
+  end // block: lane_GEN
+
+endmodule // ob_egress
@@ -58,6 +58,14 @@ module ob_lm_table #(parameter int N = 16, parameter bit is_ask = 'b1) (
   , output logic                                  cancel_hit_w
   , output ob_pkg::table_t                        cancel_hit_tbl_w
 
+  // ======================================================================== //
+  // Amend Interface
+  , input                                         amend
+  , input ob_pkg::table_t                         amend_tbl
+  //
+  , output logic                                  amend_hit_w
+  , output logic                                  amend_inplace_w
+
   // ======================================================================== //
   // Reject Interface
   , input                                         reject_pop
@@ -65,6 +73,10 @@ module ob_lm_table #(parameter int N = 16, parameter bit is_ask = 'b1) (
   , output logic                                  reject_vld_r
   , output ob_pkg::table_t                        reject_r
 
+  // ======================================================================== //
+  // Status Interface
+  , output logic                                  full_r
+
   // ======================================================================== //
   // Query Interface
   , input                                         qry_vld
@@ -75,6 +87,13 @@ module ob_lm_table #(parameter int N = 16, parameter bit is_ask = 'b1) (
   , output logic                                  qry_rsp_is_ge_r
   , output ob_pkg::accum_quantity_t               qry_rsp_qty_r
 
+  // ======================================================================== //
+  // Read Interface
+  , input ob_pkg::table_idx_t                     rd_idx
+  //
+  , output logic                                  rd_vld_w
+  , output ob_pkg::table_t                        rd_tbl_w
+
   // ======================================================================== //
   // Clk/Reset
   , input                                         clk
@@ -202,6 +221,42 @@ module ob_lm_table #(parameter int N = 16, parameter bit is_ask = 'b1) (
   end // block: insert_PROC
 
 
+  // ------------------------------------------------------------------------ //
+  //
+  logic [N:0]                           amend_match_d;
+  ob_pkg::table_t                       amend_hit_tbl_d;
+  logic [N:0]                           amend_remove_d;
+  logic [N:0]                           amend_upt_d;
+
+  always_comb begin : amend_PROC
+
+    // Locate the entry nominated by the amend operation (by UID) within
+    // the table, excluding the reject slot.
+    //
+    amend_match_d      = '0;
+    for (int i = 1; i < N + 1; i++) begin
+      amend_match_d [i]  =
+        amend & tbl_vld_r [i] & (amend_tbl.uid == tbl_r [i].uid);
+    end
+
+    amend_hit_tbl_d    = mux(amend_match_d, tbl_r);
+
+    // Amend operation has hit an entry in the table.
+    amend_hit_w        = (amend_match_d != '0);
+
+    // A reduction in quantity at the same price is updated in place, such that
+    // the entry retains its priority. Otherwise, the entry is removed (to be
+    // reinserted by the controller).
+    amend_inplace_w    =   amend_hit_w
+                         & (amend_tbl.price == amend_hit_tbl_d.price)
+                         & (amend_tbl.quantity < amend_hit_tbl_d.quantity)
+                         & (amend_tbl.quantity != '0);
+
+    amend_remove_d     = amend_inplace_w ? '0 : amend_match_d;
+    amend_upt_d        = amend_inplace_w ? amend_match_d : '0;
+
+  end // block: amend_PROC
+
   // ------------------------------------------------------------------------ //
   //
   logic [N:0]                           cancel_match_uid_d;
@@ -225,9 +280,18 @@ module ob_lm_table #(parameter int N = 16, parameter bit is_ask = 'b1) (
     cancel_hit_tbl_w        = cancel ? mux(cancel_match_uid_d, tbl_r) : '0;
 
     // Form mask such that table entries preceeding current hit vector
-    // are shifted up, to account for the canceld entry.
-    cancel_match_uid_mask_d =
-      cancel ?  mask(cancel_match_uid_d, .inclusive('b1), .lsb('b1)) : '0;
+    // are shifted up, to account for the canceld entry (or the entry
+    // removed by an amend operation).
+    case ({cancel, (amend_remove_d != '0)}) inside
+      2'b1_?:
+        cancel_match_uid_mask_d =
+          mask(cancel_match_uid_d, .inclusive('b1), .lsb('b1));
+      2'b0_1:
+        cancel_match_uid_mask_d =
+          mask(amend_remove_d, .inclusive('b1), .lsb('b1));
+      default:
+        cancel_match_uid_mask_d = '0;
+    endcase // case ({cancel, (amend_remove_d != '0)})
 
   end // block: cancel_PROC
 
@@ -285,7 +349,8 @@ module ob_lm_table #(parameter int N = 16, parameter bit is_ask = 'b1) (
     //
 
     // Enable head update on install or shift into operation.
-    tbl_en [N]     = (tbl_install_d [N] |  tbl_shift_up_d [N - 1] | head_upt);
+    tbl_en [N]     = (tbl_install_d [N] |  tbl_shift_up_d [N - 1] | head_upt |
+                      amend_upt_d [N]);
 
     // Head value update (unique, no priority)
     unique case  ({// Controller writes the head.
@@ -293,11 +358,17 @@ module ob_lm_table #(parameter int N = 16, parameter bit is_ask = 'b1) (
                    // New entry is installed in the head.
                    tbl_install_d [N],
                    // Prior table entry becomes head.
-                   tbl_shift_up_d [N]
+                   tbl_shift_up_d [N],
+                   // Head quantity is amended in place.
+                   amend_upt_d [N]
                    }) inside
-      3'b1??:  tbl_w [N]  = head_upt_tbl;
-      3'b01?:  tbl_w [N]  = insert_tbl;
-      3'b001:  tbl_w [N]  = tbl_r [N - 1];
+      4'b1???: tbl_w [N]  = head_upt_tbl;
+      4'b01??: tbl_w [N]  = insert_tbl;
+      4'b001?: tbl_w [N]  = tbl_r [N - 1];
+      4'b0001: begin
+        tbl_w [N]           = tbl_r [N];
+        tbl_w [N].quantity  = amend_tbl.quantity;
+      end
       default: tbl_w [N]  = tbl_r [N];
     endcase
 
@@ -310,7 +381,8 @@ module ob_lm_table #(parameter int N = 16, parameter bit is_ask = 'b1) (
 
       // Enable update when data moves into entry.
       tbl_en [i]  =
-        (tbl_install_d [i] | tbl_shift_up_d [i] | tbl_shift_dn_d [i]);
+        (tbl_install_d [i] | tbl_shift_up_d [i] | tbl_shift_dn_d [i] |
+         amend_upt_d [i]);
 
       // Next state (unique, no priority)
       unique case  ({// Install new entry at current location
@@ -318,20 +390,27 @@ module ob_lm_table #(parameter int N = 16, parameter bit is_ask = 'b1) (
                      // Shift entry up
                      tbl_shift_up_d [i],
                      // Shift entry down
-                     tbl_shift_dn_d [i]
+                     tbl_shift_dn_d [i],
+                     // Amend quantity in place
+                     amend_upt_d [i]
                      }) inside
-        3'b1??: begin
+        4'b1???: begin
           // Install new state
           tbl_w [i]  = insert_tbl;
         end
-        3'b01?: begin
+        4'b01??: begin
           // Next is value below current.
           tbl_w [i]  = tbl_r [i - 1];
         end
-        3'b001: begin
+        4'b001?: begin
           // Next is value above current.
           tbl_w [i]  = tbl_r [i + 1];
         end
+        4'b0001: begin
+          // Retain entry with amended quantity.
+          tbl_w [i]           = tbl_r [i];
+          tbl_w [i].quantity  = amend_tbl.quantity;
+        end
         default: begin
           // Retain prior
           tbl_w [i]  = tbl_r [i];
@@ -426,6 +505,33 @@ module ob_lm_table #(parameter int N = 16, parameter bit is_ask = 'b1) (
 
   end // block: reject_PROC
 
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : status_PROC
+
+    // Table is full whenever its final (tail) entry is occupied; a subsequent
+    // insert would displace an entry into the reject slot.
+    full_r = tbl_vld_r [1];
+
+  end // block: status_PROC
+
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : rd_PROC
+
+    // Read the 'rd_idx'-th entry from the head of the table; entries beyond
+    // the extent of the table are invalid.
+    rd_vld_w   = 'b0;
+    rd_tbl_w   = '0;
+    for (int i = 0; i < N; i++) begin
+      if (rd_idx == ob_pkg::table_idx_t'(i)) begin
+        rd_vld_w = tbl_vld_r [N - i];
+        rd_tbl_w = tbl_r [N - i];
+      end
+    end
+
+  end // block: rd_PROC
+
   // ------------------------------------------------------------------------ //
   //
   logic                                 cnt_cmd_vld;
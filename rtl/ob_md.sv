@@ -0,0 +1,101 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+`default_nettype none
+`timescale 1ns/1ps
+
+`include "ob_pkg.vh"
+`include "macros_pkg.vh"
+
+// Top-of-book market data feed. A record is published whenever the price or
+// quantity at the head of either limit table changes, sampled only at
+// committed states of the book ('commit', the controller is idle) such that
+// transient states part way through a command are never observed. Under
+// backpressure, the pending record is conflated such that the consumer always
+// observes the most recent state of the book once it accepts.
+//
+module ob_md (
+
+  // ======================================================================== //
+  // Limit Table Heads
+    input                                         lm_bid_table_vld_r
+  , input ob_pkg::table_t                         lm_bid_table_r
+  //
+  , input                                         lm_ask_table_vld_r
+  , input ob_pkg::table_t                         lm_ask_table_r
+
+  // ======================================================================== //
+  // Controller Status
+  , input                                         commit
+
+  // ======================================================================== //
+  // Market Data Interface
+  , input                                         md_accept
+  //
+  , output logic                                  md_vld_r
+  , output ob_pkg::md_t                           md_r
+
+  // ======================================================================== //
+  // Clk/Reset
+  , input                                         clk
+  , input                                         rst
+);
+
+  // ------------------------------------------------------------------------ //
+  //
+  ob_pkg::md_t                          md_snap;
+  `LIBV_REG_RST_W(logic, md_vld, 'b0);
+  `LIBV_REG_EN_RST_W(ob_pkg::md_t, md, '0);
+
+  always_comb begin : md_PROC
+
+    // Current top-of-book.
+    md_snap               = '0;
+
+    md_snap.bid_vld       = lm_bid_table_vld_r;
+    if (lm_bid_table_vld_r) begin
+      md_snap.bid_price    = lm_bid_table_r.price;
+      md_snap.bid_quantity = lm_bid_table_r.quantity;
+    end
+
+    md_snap.ask_vld       = lm_ask_table_vld_r;
+    if (lm_ask_table_vld_r) begin
+      md_snap.ask_price    = lm_ask_table_r.price;
+      md_snap.ask_quantity = lm_ask_table_r.quantity;
+    end
+
+    // Capture on change at a committed state; an unaccepted record is
+    // overwritten by the update (conflation).
+    md_en                 = commit & (md_snap != md_r);
+    md_w                  = md_snap;
+
+    // Record remains pending until accepted, or is re-armed by an update.
+    md_vld_w              = md_en | (md_vld_r & ~md_accept);
+
+  end // block: md_PROC
+
+endmodule // ob_md
@@ -72,6 +72,13 @@ module ob_mk_table #(parameter int N = 16) (
   , output logic                                  qry_rsp_vld_r
   , output ob_pkg::accum_quantity_t               qry_rsp_qty_r
 
+  // ======================================================================== //
+  // Read Interface
+  , input ob_pkg::snap_idx_t                      rd_idx
+  //
+  , output logic                                  rd_vld_w
+  , output ob_pkg::table_t                        rd_tbl_w
+
   // ======================================================================== //
   // Clk/Reset
   , input                                         clk
@@ -265,6 +272,23 @@ module ob_mk_table #(parameter int N = 16) (
 
   end // block: cancel_PROC
 
+  // ------------------------------------------------------------------------ //
+  //
+  always_comb begin : rd_PROC
+
+    // Read the 'rd_idx'-th entry from the head of the table; as entries are
+    // contiguous from the head, entries beyond the occupancy are invalid.
+    rd_vld_w   = 'b0;
+    rd_tbl_w   = '0;
+    for (int i = 0; i < N; i++) begin
+      if (rd_idx == ob_pkg::snap_idx_t'(i)) begin
+        rd_vld_w = tbl_vld_r [N - 1 - i];
+        rd_tbl_w = tbl_r [N - 1 - i];
+      end
+    end
+
+  end // block: rd_PROC
+
   // ------------------------------------------------------------------------ //
   //
   logic                                 cnt_cmd_vld;
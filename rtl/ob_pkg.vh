@@ -56,6 +56,21 @@ package ob_pkg;
   // Arithmetic type for quantity operations.
   typedef logic signed [16:0] quantity_arith_t;
 
+  // Index of an entry in the BID/ASK tables, relative to the head.
+  typedef logic [$clog2(libv_pkg::max(cfg_pkg::BID_TABLE_DEPTH_N,
+                                      cfg_pkg::ASK_TABLE_DEPTH_N) + 1) - 1:0]
+    table_idx_t;
+
+  // Index of an entry in any table (limit, market or conditional), relative
+  // to the head.
+  typedef logic [$clog2(libv_pkg::max(
+                  libv_pkg::max(cfg_pkg::BID_TABLE_DEPTH_N,
+                                cfg_pkg::ASK_TABLE_DEPTH_N),
+                  libv_pkg::max(libv_pkg::max(cfg_pkg::MARKET_BID_DEPTH_N,
+                                              cfg_pkg::MARKET_ASK_DEPTH_N),
+                                cfg_pkg::CN_DEPTH_N)) + 1) - 1:0]
+    snap_idx_t;
+
   // Commands supported by the matching engine.
   typedef enum logic [4:0] {// No operation; NOP.
                             Op_Nop        = 5'b00000,
@@ -96,7 +111,38 @@ package ob_pkg;
                             Op_BuyStopLimit = 5'b01110,
                             // As Op_Buy_SellStopLoss command but becomes limit
                             // order instead of market.
-                            Op_SellStopLimit = 5'b01111
+                            Op_SellStopLimit = 5'b01111,
+                            // Stream the top-K (quantity oprand; zero denotes
+                            // all) aggregated price levels of the Bid limit
+                            // table.
+                            Op_QryDepthBid = 5'b10000,
+                            // As Op_QryDepthBid for the Ask limit table.
+                            Op_QryDepthAsk = 5'b10001,
+                            // Cancel all resting orders on the nominated
+                            // side(s) within the nominated price range
+                            // (quantity oprand, see mcancel_t), streaming the
+                            // cancelled orders; at most one every two cycles.
+                            Op_MassCancel = 5'b10010,
+                            // Amend the resting limit order nominated by uid1
+                            // to the price/quantity oprands. A reduction in
+                            // quantity at the same price is updated in place
+                            // (retaining priority); otherwise, the order is
+                            // cancelled and reinserted.
+                            Op_Replace = 5'b10011,
+                            // Stream the performance counters (see
+                            // stats_id_t), one counter per response.
+                            Op_QryStats = 5'b10100,
+                            // Stream every valid entry of the limit, market
+                            // and conditional tables (see
+                            // result_snapshot_t), terminated by a final
+                            // response.
+                            Op_QrySnapshot = 5'b10101,
+                            // Install an entry (uid, quantity, price) into
+                            // the Bid limit table without matching; entries
+                            // are presented in priority order (bulk load).
+                            Op_LoadBid = 5'b10110,
+                            // As Op_LoadBid for the Ask limit table.
+                            Op_LoadAsk = 5'b10111
                             } opcode_t;
 
   // Time-In-Force (TIF) types
@@ -110,6 +156,62 @@ package ob_pkg;
                              Tif_AllOrNone          = 3'b011
                             } tif_t;
 
+  // Free-running cycle timestamp; wraps on overflow.
+  typedef logic [31:0] ts_t;
+
+  // Performance counter; saturates at its maximum value.
+  typedef logic [31:0] stats_cnt_t;
+
+  // Performance counter identifier. Counters are streamed by Op_QryStats in
+  // ascending order of identifier.
+  typedef logic [15:0] stats_id_t;
+
+  // Commands accepted from the ingress interface, indexed by opcode.
+  localparam int STATS_CMD = 0;
+  localparam int STATS_CMD_N = (1 << $bits(opcode_t));
+  // Trades executed.
+  localparam int STATS_TRADE = STATS_CMD + STATS_CMD_N;
+  // Rejects, by originating table.
+  localparam int STATS_REJECT_LM_BID = STATS_TRADE + 1;
+  localparam int STATS_REJECT_LM_ASK = STATS_TRADE + 2;
+  localparam int STATS_REJECT_MK_BID = STATS_TRADE + 3;
+  localparam int STATS_REJECT_MK_ASK = STATS_TRADE + 4;
+  localparam int STATS_REJECT_CN_BUY = STATS_TRADE + 5;
+  localparam int STATS_REJECT_CN_SELL = STATS_TRADE + 6;
+  // Cancel (Op_Cancel) outcomes.
+  localparam int STATS_CANCEL_HIT = STATS_TRADE + 7;
+  localparam int STATS_CANCEL_MISS = STATS_TRADE + 8;
+  // Conditional commands matured.
+  localparam int STATS_CN_MTR = STATS_TRADE + 9;
+  // Cycles for which the egress queue was full.
+  localparam int STATS_EGRESS_STALL = STATS_TRADE + 10;
+  // Cycles resident in each controller state, indexed by the bit position
+  // of the (one-hot) state encoding.
+  localparam int STATS_FSM = STATS_TRADE + 11;
+  localparam int STATS_FSM_N = 13;
+  // Total number of counters.
+  localparam int STATS_N = STATS_FSM + STATS_FSM_N;
+
+  // Mass cancel price range; relative to the price oprand.
+  typedef enum logic [1:0] { // All orders (market orders included).
+                             Mc_All = 2'b00,
+                             // Limit orders at, or above, price.
+                             Mc_Ge  = 2'b01,
+                             // Limit orders at, or below, price.
+                             Mc_Le  = 2'b10
+                           } mcancel_range_t;
+
+  // Mass cancel control; carried in the quantity oprand.
+  typedef struct packed { // 16b
+    logic [11:0]         padding;
+    // Price range
+    mcancel_range_t      range;
+    // Cancel orders on the Ask (sell) side.
+    logic                ask;
+    // Cancel orders on the Bid (buy) side.
+    logic                bid;
+  } mcancel_t;
+
   //
   typedef struct packed {
     // Unique command identifier.
@@ -140,7 +242,9 @@ package ob_pkg;
                               // Prior command could not complete
                               S_Bad = 3'b100,
                               // Attempt to pop from empty table.
-                              S_BadPop = 3'b101
+                              S_BadPop = 3'b101,
+                              // IOC/FOK order (or its remainder) was killed.
+                              S_Killed = 3'b110
                               } status_t;
 
   typedef struct packed { // 80b
@@ -177,6 +281,57 @@ package ob_pkg;
     accum_quantity_t accum;
   } result_qry_t;
 
+  typedef struct packed { // 80b
+    // Padding for union sizing.
+    logic [79:37 + $bits(accum_quantity_t)] padding;
+    // Final level of the depth snapshot.
+    logic                last; // 1b
+    // Level index (relative to the head).
+    quantity_t           level; // 16b
+    // Level price.
+    bcd_pkg::price_t     price; // 20b
+    // Aggregated quantity at level.
+    accum_quantity_t     accum;
+  } result_depth_t;
+
+  typedef struct packed { // 80b
+    // Padding for union sizing.
+    logic [79:49]        padding;
+    // Final counter of the stream.
+    logic                last; // 1b
+    // Counter identifier.
+    stats_id_t           id; // 16b
+    // Counter value.
+    stats_cnt_t          value; // 32b
+  } result_stats_t;
+
+  // Table from which a snapshot entry originates.
+  typedef enum logic [2:0] { Snap_LmBid  = 3'b000,
+                             Snap_LmAsk  = 3'b001,
+                             Snap_MkBid  = 3'b010,
+                             Snap_MkAsk  = 3'b011,
+                             Snap_CnBuy  = 3'b100,
+                             Snap_CnSell = 3'b101
+                           } snap_table_t;
+
+  typedef struct packed { // 80b
+    // Padding for union sizing.
+    logic [79:73]        padding;
+    // Final response of the snapshot (carries no entry).
+    logic                last; // 1b
+    // Originating table.
+    snap_table_t         tbl; // 3b
+    // Extension of the preceding conditional entry: price carries its
+    // trigger price (price1) and quantity its opcode.
+    logic                ext; // 1b
+    // Entry price
+    bcd_pkg::price_t     price; // 20b
+    // Entry quantity
+    quantity_t           quantity; // 16b
+    // Entry UID
+    uid_t                uid; // 32b
+  } result_snapshot_t;
+
   typedef union packed {
     // Query Bid/Ask spread
     result_qrybidask_t qrybidask;
@@ -186,10 +341,36 @@ package ob_pkg;
     result_trade_t trade;
     // Accumulated Qry
     result_qry_t qry;
+    // Depth snapshot level
+    result_depth_t depth;
+    // Performance counter
+    result_stats_t stats;
+    // Snapshot entry
+    result_snapshot_t snapshot;
   } result_t;
 
+  // Ingress queue entry; command and the timestamp at which it was accepted.
+  typedef struct packed {
+`ifdef OB_CFG_RSP_TIMESTAMP_EN
+    // Timestamp of acceptance at the command interface.
+    ts_t                 ts;
+`endif
+    // Command
+    cmd_t                cmd;
+  } ingress_t;
+
   //
   typedef struct packed {
+`ifdef OB_CFG_RSP_TIMESTAMP_EN
+    // Timestamp at which the originating command was accepted (omitted when
+    // RSP_TIMESTAMP_EN is clear).
+    ts_t            ts_accept;
+
+    // Timestamp at which the response was emitted by the controller
+    // (omitted when RSP_TIMESTAMP_EN is clear).
+    ts_t            ts_emit;
+`endif
+
     // Unique command identifier.
     uid_t           uid;
 
@@ -210,6 +391,20 @@ package ob_pkg;
     bcd_pkg::price_t     price;
   } table_t;
 
+  // Top-of-book market data record.
+  typedef struct packed {
+    // Bid side non-empty.
+    logic                bid_vld;
+    // Best Bid price/quantity (zero when empty).
+    bcd_pkg::price_t     bid_price;
+    quantity_t           bid_quantity;
+    // Ask side non-empty.
+    logic                ask_vld;
+    // Best Ask price/quantity (zero when empty).
+    bcd_pkg::price_t     ask_price;
+    quantity_t           ask_quantity;
+  } md_t;
+
   typedef struct packed {
     // Trade on Limit Ask (Sell) <-> Limit Bid (Buy)
     logic                     lm_ask_lm_bid;
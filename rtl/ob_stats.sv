@@ -0,0 +1,118 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+`default_nettype none
+`timescale 1ns/1ps
+
+`include "ob_pkg.vh"
+`include "macros_pkg.vh"
+
+// Performance counters. Each counter increments by at most one per cycle and
+// saturates at its maximum value (such that a saturated counter denotes
+// overflow rather than silently wrapping). Counters are read, one per cycle,
+// through the read interface (see Op_QryStats) and are cleared only on reset.
+//
+module ob_stats (
+
+  // ======================================================================== //
+  // Command Interface
+    input                                         cmd_vld
+  , input ob_pkg::opcode_t                        cmd_opcode
+
+  // ======================================================================== //
+  // Event Interface
+  , input                                         trade
+  //
+  , input                                         reject_lm_bid
+  , input                                         reject_lm_ask
+  , input                                         reject_mk_bid
+  , input                                         reject_mk_ask
+  , input                                         reject_cn_buy
+  , input                                         reject_cn_sell
+  //
+  , input                                         cancel_hit
+  , input                                         cancel_miss
+  //
+  , input                                         cn_mtr
+  //
+  , input                                         egress_stall
+  //
+  , input [ob_pkg::STATS_FSM_N - 1:0]             fsm_state_r
+
+  // ======================================================================== //
+  // Read Interface
+  , input ob_pkg::stats_id_t                      rd_id
+  , output ob_pkg::stats_cnt_t                    rd_cnt
+
+  // ======================================================================== //
+  // Clk/Reset
+  , input                                         clk
+  , input                                         rst
+);
+
+  // ------------------------------------------------------------------------ //
+  //
+  logic [ob_pkg::STATS_N - 1:0]         cnt_inc;
+  `LIBV_REG_EN_RST_N(ob_pkg::stats_cnt_t, cnt, ob_pkg::STATS_N, '0);
+
+  always_comb begin : cnt_PROC
+
+    cnt_inc                                       = '0;
+
+    // Commands, by opcode.
+    cnt_inc [ob_pkg::STATS_CMD + cmd_opcode]      = cmd_vld;
+
+    cnt_inc [ob_pkg::STATS_TRADE]                 = trade;
+
+    cnt_inc [ob_pkg::STATS_REJECT_LM_BID]         = reject_lm_bid;
+    cnt_inc [ob_pkg::STATS_REJECT_LM_ASK]         = reject_lm_ask;
+    cnt_inc [ob_pkg::STATS_REJECT_MK_BID]         = reject_mk_bid;
+    cnt_inc [ob_pkg::STATS_REJECT_MK_ASK]         = reject_mk_ask;
+    cnt_inc [ob_pkg::STATS_REJECT_CN_BUY]         = reject_cn_buy;
+    cnt_inc [ob_pkg::STATS_REJECT_CN_SELL]        = reject_cn_sell;
+
+    cnt_inc [ob_pkg::STATS_CANCEL_HIT]            = cancel_hit;
+    cnt_inc [ob_pkg::STATS_CANCEL_MISS]           = cancel_miss;
+
+    cnt_inc [ob_pkg::STATS_CN_MTR]                = cn_mtr;
+
+    cnt_inc [ob_pkg::STATS_EGRESS_STALL]          = egress_stall;
+
+    // Residency, by (one-hot) FSM state.
+    cnt_inc [ob_pkg::STATS_FSM +: ob_pkg::STATS_FSM_N] = fsm_state_r;
+
+    // Saturate on all ones.
+    for (int i = 0; i < ob_pkg::STATS_N; i++) begin
+      cnt_en [i] = cnt_inc [i] & (cnt_r [i] != '1);
+      cnt_w [i]  = cnt_r [i] + 'b1;
+    end
+
+    // Read
+    rd_cnt = (rd_id < ob_pkg::stats_id_t'(ob_pkg::STATS_N)) ? cnt_r [rd_id] : '0;
+
+  end // block: cnt_PROC
+
+endmodule // ob_stats
@@ -0,0 +1,151 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_BCD_H
+#define M_TB_BCD_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Packed BCD price codec (the bcd_pkg::price_t representation: three dollar
+// digits followed by two cent digits, one per nibble, least significant
+// digit in the least significant nibble). All conversions are branch-light,
+// allocation free and constexpr such that they may be used both by stimulus
+// generation and by host-side encoding of commands.
+//
+namespace tb::bcd {
+
+// Number of digits in a packed price.
+constexpr std::size_t DIGITS_N = 5;
+
+// Largest representable price in cents (999.99).
+constexpr std::uint32_t CENTS_MAX = 99999;
+
+// Largest representable packed price (999.99).
+constexpr std::uint32_t PACKED_MAX = 0x99999;
+
+// Smallest representable packed price (000.00).
+constexpr std::uint32_t PACKED_MIN = 0x00000;
+
+// Convert integer cents (<= CENTS_MAX) to packed BCD.
+//
+// Digits are extracted in parallel (SWAR) within a 64b word: the value is
+// split into two 32b lanes (divide by 10^4), then four 16b lanes (divide by
+// 10^2), then eight 8b lanes (divide by 10), each step replacing division
+// by a reciprocal multiply-shift which is exact over the lane range. The
+// byte lanes are finally compressed into nibbles.
+constexpr std::uint32_t from_cents(std::uint32_t cents) {
+  std::uint64_t x = (static_cast<std::uint64_t>(cents / 10000) << 32) |
+                    (cents % 10000);
+
+  // 32b lanes (< 10^4) -> 16b lanes (< 10^2); q = v / 100
+  std::uint64_t q = ((x * 5243) >> 19) & 0x0000007F0000007FULL;
+  x = (q << 16) | (x - q * 100);
+
+  // 16b lanes (< 10^2) -> 8b lanes (< 10); q = v / 10
+  q = ((x * 103) >> 10) & 0x000F000F000F000FULL;
+  x = (q << 8) | (x - q * 10);
+
+  // Compress byte lanes to nibbles.
+  x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+  return static_cast<std::uint32_t>(x);
+}
+
+// Convert packed BCD to integer cents.
+//
+// Adjacent digits are combined in parallel (SWAR): nibble pairs to bytes
+// (x10), byte pairs to 16b (x100) and 16b pairs to 32b (x10^4).
+constexpr std::uint32_t to_cents(std::uint32_t packed) {
+  std::uint32_t x = packed;
+  x = (x & 0x0F0F0F0F) + ((x >> 4) & 0x0F0F0F0F) * 10;
+  x = (x & 0x00FF00FF) + ((x >> 8) & 0x00FF00FF) * 100;
+  x = (x & 0x0000FFFF) + (x >> 16) * 10000;
+  return x;
+}
+
+// Convert a price (in dollars) to packed BCD, rounded to the nearest cent
+// and saturated to the representable range.
+constexpr std::uint32_t from_double(double d) {
+  const double cents = (d * 100.0) + 0.5;
+  if (!(cents > 0.0)) return PACKED_MIN;
+  if (cents >= static_cast<double>(CENTS_MAX)) return PACKED_MAX;
+  return from_cents(static_cast<std::uint32_t>(cents));
+}
+
+// Packed BCD is valid, each digit is in range [0, 9].
+constexpr bool is_valid(std::uint32_t packed) {
+  // A digit is invalid if it exceeds 9; adding 6 to such a digit carries
+  // into bit 4 of the nibble.
+  const std::uint32_t x = packed & 0xFFFFF;
+  return (packed == x) && ((((x + 0x66666) ^ x ^ 0x66666) & 0x111110) == 0);
+}
+
+// Parse ASCII price (like ddd.cc; at most three dollar and two cent digits)
+// of length n to packed BCD.
+constexpr std::uint32_t from_ascii(const char* s, std::size_t n) {
+  std::uint32_t packed = 0;
+  std::size_t cents_n = 0;
+  bool in_cents = false;
+  for (std::size_t i = 0; i < n; i++) {
+    if (s[i] == '.') {
+      in_cents = true;
+      continue;
+    }
+    packed = (packed << 4) | static_cast<std::uint32_t>(s[i] - '0');
+    if (in_cents) ++cents_n;
+  }
+  // Scale by any omitted cent digits.
+  for (; cents_n < 2; cents_n++) packed <<= 4;
+  return packed;
+}
+
+// Maximum length of a rendered price ("ddd.cc").
+constexpr std::size_t ASCII_MAX_N = 6;
+
+// Render packed BCD to ASCII (like ddd.cc) at s, with leading zero dollar
+// digits suppressed; returns the number of characters written (at most
+// ASCII_MAX_N, not NUL terminated).
+constexpr std::size_t to_ascii(std::uint32_t packed, char* s) {
+  std::size_t n = 0;
+  bool lead = true;
+  for (int i = 4; i >= 2; i--) {
+    const char d = static_cast<char>((packed >> (4 * i)) & 0xF);
+    if (lead && (d == 0)) continue;
+    lead = false;
+    s[n++] = static_cast<char>('0' + d);
+  }
+  s[n++] = '.';
+  s[n++] = static_cast<char>('0' + ((packed >> 4) & 0xF));
+  s[n++] = static_cast<char>('0' + ((packed >> 0) & 0xF));
+  return n;
+}
+
+} // namespace tb::bcd
+
+#endif
@@ -0,0 +1,129 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "bcd.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Microbenchmark: packed BCD price conversion by way of the string
+// round-trip (as formerly used by stimulus generation), against the
+// direct codec.
+
+namespace {
+
+// Legacy path: double -> "ddd.cc" -> digits -> packed.
+std::uint32_t legacy_from_double(double d) {
+  static char c[128];
+  std::snprintf(c, 128, "%.2f", d);
+  const std::string s{c};
+
+  std::uint8_t dollars[3] = {0, 0, 0};
+  std::uint8_t cents[2] = {0, 0};
+  const std::string::size_type i = s.find('.');
+  std::string dollar{s.substr(0, i)};
+  for (std::size_t j = 0; !dollar.empty(); j++) {
+    dollars[j] = dollar.back() - '0';
+    dollar.pop_back();
+  }
+  std::string cent{s.substr(i + 1)};
+  std::reverse(cent.begin(), cent.end());
+  for (std::size_t j = 0; j < cent.size(); j++) {
+    cents[j] = cent[j] - '0';
+  }
+  return (dollars[2] << 16) | (dollars[1] << 12) | (dollars[0] << 8) |
+         (cents[1] << 4) | cents[0];
+}
+
+// Legacy path: packed -> string.
+std::string legacy_to_string(std::uint32_t p) {
+  std::string s;
+  for (int i = 4; i >= 2; i--) {
+    const char d = (p >> (4 * i)) & 0xF;
+    if (!s.empty() || (d != 0)) s += ('0' + d);
+  }
+  s += '.';
+  s += ('0' + ((p >> 4) & 0xF));
+  s += ('0' + (p & 0xF));
+  return s;
+}
+
+template<typename FN>
+double time_ns(std::size_t n, FN&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / n;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t n = (argc > 1) ? std::stoul(argv[1]) : (1 << 22);
+
+  std::mt19937 mt{1};
+  std::normal_distribution<double> nd{100.0, 10.0};
+  std::vector<double> prices(n);
+  for (double& d : prices) d = nd(mt);
+
+  // Accumulate results such that the conversions are not elided.
+  std::uint64_t sink = 0;
+
+  const double legacy_enc = time_ns(n, [&]() {
+    for (double d : prices) sink += legacy_from_double(d);
+  });
+  const double codec_enc = time_ns(n, [&]() {
+    for (double d : prices) sink += tb::bcd::from_double(d);
+  });
+
+  std::vector<std::uint32_t> packed(n);
+  for (std::size_t i = 0; i < n; i++) {
+    packed[i] = tb::bcd::from_double(prices[i]);
+  }
+
+  const double legacy_dec = time_ns(n, [&]() {
+    for (std::uint32_t p : packed) sink += legacy_to_string(p).size();
+  });
+  const double codec_dec = time_ns(n, [&]() {
+    char s[tb::bcd::ASCII_MAX_N];
+    for (std::uint32_t p : packed) sink += tb::bcd::to_ascii(p, s) + s[0];
+  });
+  const double codec_cents = time_ns(n, [&]() {
+    for (std::uint32_t p : packed) sink += tb::bcd::to_cents(p);
+  });
+
+  std::cout << "n=" << n << " (ns/op)\n"
+            << "encode: legacy=" << legacy_enc << " codec=" << codec_enc
+            << "\n"
+            << "decode: legacy=" << legacy_dec << " codec=" << codec_dec
+            << " cents=" << codec_cents << "\n"
+            << "(sink=" << sink << ")\n";
+  return 0;
+}
@@ -0,0 +1,101 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_CMD_H
+#define M_TB_CMD_H
+
+#include "tb.h"
+
+namespace tb {
+
+// Command factories for directed tests.
+
+// Command without oprands.
+inline Command make_cmd(vluint8_t opcode, vluint32_t uid) {
+  Command cmd;
+  cmd.valid = true;
+  cmd.opcode = opcode;
+  cmd.uid = uid;
+  return cmd;
+}
+
+inline Command make_nop(vluint32_t uid) {
+  return make_cmd(Opcode::Nop, uid);
+}
+
+// Invalid command; the command interface remains idle for a cycle.
+inline Command make_bubble() {
+  return Command{};
+}
+
+inline Command make_limit(vluint8_t opcode, vluint32_t uid, const char* price,
+                          vluint16_t quantity,
+                          vluint8_t tif = Tif::GoodUntilCancelled) {
+  Command cmd = make_cmd(opcode, uid);
+  cmd.tif = tif;
+  cmd.quantity = quantity;
+  cmd.price = Bcd::from_string(price).pack();
+  return cmd;
+}
+
+inline Command make_market(vluint8_t opcode, vluint32_t uid,
+                           vluint16_t quantity) {
+  Command cmd = make_cmd(opcode, uid);
+  cmd.quantity = quantity;
+  return cmd;
+}
+
+// Conditional command; 'price1' is the trigger price.
+inline Command make_stop(vluint8_t opcode, vluint32_t uid, const char* price,
+                         const char* price1, vluint16_t quantity) {
+  Command cmd = make_limit(opcode, uid, price, quantity);
+  cmd.price1 = Bcd::from_string(price1).pack();
+  return cmd;
+}
+
+inline Command make_cancel(vluint32_t uid, vluint32_t uid1) {
+  Command cmd = make_cmd(Opcode::Cancel, uid);
+  cmd.uid1 = uid1;
+  return cmd;
+}
+
+inline Command make_replace(vluint32_t uid, vluint32_t uid1,
+                            const char* price, vluint16_t quantity) {
+  Command cmd = make_limit(Opcode::Replace, uid, price, quantity);
+  cmd.uid1 = uid1;
+  return cmd;
+}
+
+// Mass cancel; 'ctrl' combines mass_cancel::Control bits.
+inline Command make_mass_cancel(vluint32_t uid, vluint16_t ctrl,
+                                const char* price = "0.00") {
+  return make_limit(Opcode::MassCancel, uid, price, ctrl);
+}
+
+} // namespace tb
+
+#endif
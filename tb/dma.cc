@@ -0,0 +1,406 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "dma.h"
+#include "utility.h"
+#include "vobj/Vtb_ob.h"
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <new>
+#include <thread>
+
+namespace tb::dma {
+
+namespace {
+
+// Futex operations; the region is shared between processes therefore the
+// (non-private) shared variants are used.
+long futex(std::atomic<std::uint32_t>* addr, int op, std::uint32_t val,
+           const struct timespec* timeout = nullptr) {
+  return ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), op, val,
+                   timeout, nullptr, 0);
+}
+
+struct timespec to_timespec(std::chrono::microseconds us) {
+  struct timespec ts;
+  ts.tv_sec = static_cast<time_t>(us.count() / 1000000);
+  ts.tv_nsec = static_cast<long>((us.count() % 1000000) * 1000);
+  return ts;
+}
+
+bool is_pow2(std::size_t n) { return (n != 0) && ((n & (n - 1)) == 0); }
+
+} // namespace
+
+void Doorbell::ring() {
+  seq.fetch_add(1, std::memory_order_seq_cst);
+  if (waiters.load(std::memory_order_seq_cst) != 0) {
+    futex(&seq, FUTEX_WAKE, std::numeric_limits<int>::max());
+  }
+}
+
+void Doorbell::wait(std::uint32_t s, std::chrono::microseconds timeout) {
+  const struct timespec ts = to_timespec(timeout);
+  waiters.fetch_add(1, std::memory_order_seq_cst);
+  // Returns immediately should the doorbell have been rung since 's' was
+  // sampled.
+  futex(&seq, FUTEX_WAIT, s, &ts);
+  waiters.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+std::size_t DmaRegion::bytes(std::size_t cmd_n, std::size_t rsp_n) {
+  return sizeof(DmaRegion) + cmd_n * wire::Cmd::BYTES +
+         rsp_n * wire::Rsp::BYTES;
+}
+
+Shm Shm::create(const std::string& name, std::size_t cmd_n,
+                std::size_t rsp_n) {
+  Shm s;
+  if (!is_pow2(cmd_n) || !is_pow2(rsp_n)) return s;
+
+  ::shm_unlink(name.c_str());
+  const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) return s;
+
+  const std::size_t bytes = DmaRegion::bytes(cmd_n, rsp_n);
+  void* p = MAP_FAILED;
+  if (::ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+    p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  ::close(fd);
+  if (p == MAP_FAILED) return s;
+
+  DmaRegion* r = new (p) DmaRegion;
+  r->cmd_n = static_cast<std::uint32_t>(cmd_n);
+  r->rsp_n = static_cast<std::uint32_t>(rsp_n);
+  r->running.store(0);
+  r->stop.store(0);
+  // Publish initialized region.
+  r->magic.store(DmaRegion::MAGIC, std::memory_order_release);
+
+  s.r_ = r;
+  s.bytes_ = bytes;
+  return s;
+}
+
+Shm Shm::open(const std::string& name, std::chrono::milliseconds timeout) {
+  Shm s;
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  auto expired = [&]() { return std::chrono::steady_clock::now() > deadline; };
+  auto backoff = []() {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  };
+
+  // Await creation of the region by the server.
+  int fd;
+  while ((fd = ::shm_open(name.c_str(), O_RDWR, 0600)) < 0) {
+    if (expired()) return s;
+    backoff();
+  }
+  struct stat st;
+  while ((::fstat(fd, &st) != 0) ||
+         (static_cast<std::size_t>(st.st_size) < sizeof(DmaRegion))) {
+    if (expired()) { ::close(fd); return s; }
+    backoff();
+  }
+  const std::size_t bytes = static_cast<std::size_t>(st.st_size);
+  void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) return s;
+
+  // Await initialization.
+  DmaRegion* r = static_cast<DmaRegion*>(p);
+  while (r->magic.load(std::memory_order_acquire) != DmaRegion::MAGIC) {
+    if (expired()) { ::munmap(p, bytes); return s; }
+    backoff();
+  }
+  if (DmaRegion::bytes(r->cmd_n, r->rsp_n) != bytes) {
+    ::munmap(p, bytes);
+    return s;
+  }
+
+  s.r_ = r;
+  s.bytes_ = bytes;
+  return s;
+}
+
+Shm::Shm(Shm&& s) noexcept : r_(s.r_), bytes_(s.bytes_) {
+  s.r_ = nullptr;
+  s.bytes_ = 0;
+}
+
+Shm& Shm::operator=(Shm&& s) noexcept {
+  std::swap(r_, s.r_);
+  std::swap(bytes_, s.bytes_);
+  return *this;
+}
+
+Shm::~Shm() {
+  if (r_) ::munmap(r_, bytes_);
+}
+
+void Shm::unlink(const std::string& name) {
+  ::shm_unlink(name.c_str());
+}
+
+std::string ServerStats::to_string() const {
+  utility::KVListRenderer r;
+  r.add_field("cycles", std::to_string(cycles));
+  r.add_field("cmd_n", std::to_string(cmd_n));
+  r.add_field("rsp_n", std::to_string(rsp_n));
+  r.add_field("fetches", std::to_string(fetches));
+  r.add_field("posts", std::to_string(posts));
+  r.add_field("sleeps", std::to_string(sleeps));
+  r.add_field("cmd_fill_mean", std::to_string(cmd_fill_mean()));
+  r.add_field("cmd_fill_max", std::to_string(cmd_fill_max));
+  r.add_field("prefetch_max", std::to_string(prefetch_max));
+  r.add_field("rsp_full_cycles", std::to_string(rsp_full_cycles));
+  return r.to_string();
+}
+
+Server::Server(const ServerOptions& opts)
+    : opts_(opts),
+      shm_(Shm::create(opts.name, opts.cmd_n, opts.rsp_n)),
+      r_(shm_.region()) {
+  if (!r_) return;
+  u_ = new Vtb_ob;
+  vs_ = VSignals::bind(u_);
+}
+
+Server::~Server() {
+  delete u_;
+  Shm::unlink(opts_.name);
+}
+
+void Server::step() {
+  vs_.set_clk(false);
+  u_->eval();
+  vs_.set_clk(true);
+  u_->eval();
+  ++cycle_;
+  ++stats_.cycles;
+}
+
+void Server::fetch() {
+  const vluint64_t wr = r_->cmd.wr.load(std::memory_order_acquire);
+  const std::size_t fill = static_cast<std::size_t>(wr - cmd_rd_);
+  stats_.cmd_fill_sum += fill;
+  stats_.cmd_fill_max = std::max(stats_.cmd_fill_max, fill);
+
+  const std::size_t n = std::min({fill, opts_.fetch_n,
+                                  opts_.prefetch_n - prefetch_.size()});
+  if (n == 0) return;
+
+  const std::size_t mask = r_->cmd_n - 1;
+  for (std::size_t i = 0; i < n; i++, cmd_rd_++) {
+    Fetched f;
+    f.ready = cycle_ + opts_.fetch_latency;
+    wire::decode(r_->cmd_ring() + (cmd_rd_ & mask) * wire::Cmd::BYTES, f.cmd);
+    prefetch_.push_back(f);
+  }
+  // Descriptors are consumed; return ring space to the host.
+  r_->cmd.rd.store(cmd_rd_, std::memory_order_release);
+  ++stats_.fetches;
+  stats_.prefetch_max = std::max(stats_.prefetch_max, prefetch_.size());
+}
+
+bool Server::reap() {
+  // Responses are accepted only when the ring may absorb a full beat of
+  // both the response and trade interfaces.
+  const vluint64_t rd = r_->rsp.rd.load(std::memory_order_acquire);
+  const bool accept = (r_->rsp_n - (rsp_wr_ - rd)) >= (2 * RSP_LANES_N);
+  vs_.set_rsp_accept(accept);
+  vs_.set_trd_accept(accept);
+
+  bool active = false;
+  const std::size_t mask = r_->rsp_n - 1;
+  auto push = [&](const Response& rsp) {
+    wire::encode(rsp, r_->rsp_ring() + (rsp_wr_++ & mask) * wire::Rsp::BYTES);
+    ++stats_.rsp_n;
+  };
+  for (std::size_t lane = 0; lane < RSP_LANES_N; lane++) {
+    Response rsp;
+    vs_.get(rsp, lane);
+    if (!rsp.valid) break;
+    active = true;
+    if (accept) push(rsp);
+  }
+  for (std::size_t lane = 0; lane < RSP_LANES_N; lane++) {
+    Response rsp;
+    vs_.get_trade(rsp, lane);
+    if (!rsp.valid) break;
+    active = true;
+    if (accept) push(rsp);
+  }
+  if (active && !accept) ++stats_.rsp_full_cycles;
+  return active;
+}
+
+void Server::post() {
+  if (rsp_posted_ == rsp_wr_) return;
+  r_->rsp.wr.store(rsp_wr_, std::memory_order_release);
+  r_->rsp.db.ring();
+  rsp_posted_ = rsp_wr_;
+  ++stats_.posts;
+}
+
+void Server::run() {
+  if (!r_) return;
+
+  // Reset
+  Command cmd;
+  vs_.set(cmd);
+  vs_.set_rsp_accept(false);
+  vs_.set_trd_accept(false);
+  vs_.set_md_accept(true);
+  for (std::size_t i = 0; i < 20; i++) {
+    vs_.set_rst((i > 5) && (i < 15));
+    step();
+  }
+  vs_.set_rst(false);
+  r_->running.store(1, std::memory_order_release);
+
+  std::size_t idle = 0;
+  for (;;) {
+    bool active = false;
+
+    // Descriptor fetch
+    fetch();
+
+    // Issue command
+    cmd.valid = false;
+    if (!vs_.get_cmd_full_r() && !prefetch_.empty() &&
+        (prefetch_.front().ready <= cycle_)) {
+      cmd = prefetch_.front().cmd;
+      prefetch_.pop_front();
+      ++stats_.cmd_n;
+      active = true;
+    }
+    vs_.set(cmd);
+
+    // Response write-back
+    active |= reap();
+    step();
+
+    idle = active ? 0 : (idle + 1);
+    if (((rsp_wr_ - rsp_posted_) >= opts_.post_n) ||
+        (idle >= opts_.post_idle)) {
+      post();
+    }
+
+    const bool drained =
+        prefetch_.empty() &&
+        (r_->cmd.wr.load(std::memory_order_acquire) == cmd_rd_) &&
+        (rsp_posted_ == rsp_wr_) && (idle >= opts_.idle_n);
+    if (!drained) continue;
+
+    if (r_->stop.load(std::memory_order_acquire)) break;
+
+    if (opts_.wait == Wait::Interrupt) {
+      // Quiescent; sleep until the host rings the command doorbell.
+      const std::uint32_t s = r_->cmd.db.seq.load(std::memory_order_acquire);
+      if ((r_->cmd.wr.load(std::memory_order_acquire) == cmd_rd_) &&
+          !r_->stop.load(std::memory_order_acquire)) {
+        ++stats_.sleeps;
+        r_->cmd.db.wait(s, std::chrono::microseconds{10000});
+      }
+    }
+  }
+  r_->running.store(0, std::memory_order_release);
+  // Wake any client awaiting responses.
+  r_->rsp.db.ring();
+}
+
+Client::Client(const std::string& name)
+    : shm_(Shm::open(name)), r_(shm_.region()) {}
+
+std::size_t Client::submit(const Command* first, std::size_t n) {
+  if (!connected()) return 0;
+
+  const vluint64_t wr = r_->cmd.wr.load(std::memory_order_relaxed);
+  const vluint64_t rd = r_->cmd.rd.load(std::memory_order_acquire);
+  n = std::min<std::size_t>(n, r_->cmd_n - (wr - rd));
+  if (n == 0) return 0;
+
+  const std::size_t mask = r_->cmd_n - 1;
+  for (std::size_t i = 0; i < n; i++) {
+    wire::encode(first[i],
+                 r_->cmd_ring() + ((wr + i) & mask) * wire::Cmd::BYTES);
+  }
+  r_->cmd.wr.store(wr + n, std::memory_order_release);
+  r_->cmd.db.ring();
+  return n;
+}
+
+std::size_t Client::poll(Response* out, std::size_t n) {
+  if (!connected()) return 0;
+
+  const vluint64_t rd = r_->rsp.rd.load(std::memory_order_relaxed);
+  const vluint64_t wr = r_->rsp.wr.load(std::memory_order_acquire);
+  n = std::min<std::size_t>(n, wr - rd);
+  if (n == 0) return 0;
+
+  const std::size_t mask = r_->rsp_n - 1;
+  for (std::size_t i = 0; i < n; i++) {
+    wire::decode(r_->rsp_ring() + ((rd + i) & mask) * wire::Rsp::BYTES,
+                 out[i]);
+  }
+  r_->rsp.rd.store(rd + n, std::memory_order_release);
+  return n;
+}
+
+std::size_t Client::wait(Response* out, std::size_t n, Wait w,
+                         std::chrono::microseconds timeout) {
+  if (!connected()) return 0;
+
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  for (;;) {
+    const std::uint32_t s = r_->rsp.db.seq.load(std::memory_order_acquire);
+    if (const std::size_t m = poll(out, n); m != 0) return m;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) return 0;
+    if (w == Wait::Interrupt) {
+      r_->rsp.db.wait(s, std::chrono::duration_cast<std::chrono::microseconds>(
+                             deadline - now));
+    }
+  }
+}
+
+void Client::stop() {
+  if (!connected()) return;
+
+  r_->stop.store(1, std::memory_order_release);
+  r_->cmd.db.ring();
+}
+
+} // namespace tb::dma
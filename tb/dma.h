@@ -0,0 +1,286 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_DMA_H
+#define M_TB_DMA_H
+
+#include "tb.h"
+#include "wire.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Host interface stand-in: a pair of descriptor rings in POSIX shared
+// memory, commands (host to engine) and responses (engine to host), each
+// with a doorbell. A server process owns the Verilated engine and services
+// the rings; clients in other processes submit commands and reap responses
+// through the same region. Descriptors are wire format records (wire.h).
+//
+// Region layout:
+//
+//   DmaRegion header | command ring (cmd_n x Cmd::BYTES) |
+//                      response ring (rsp_n x Rsp::BYTES)
+//
+// Ring indices are free-running; an index is masked by the (power of two)
+// ring size on access. Each ring has a single producer and a single consumer.
+//
+namespace tb::dma {
+
+// Doorbell; a futex word incremented by the producer each time descriptors
+// are posted. Consumers may poll the ring indices directly, or sleep on the
+// doorbell (interrupt-style) whilst the ring is empty.
+struct Doorbell {
+  // Ring count; the futex word.
+  std::atomic<std::uint32_t> seq{0};
+  // Count of consumers sleeping on the doorbell; the producer issues a wake
+  // only when non-zero.
+  std::atomic<std::uint32_t> waiters{0};
+
+  // Ring doorbell.
+  void ring();
+
+  // Sleep whilst the doorbell count remains 'seq', or until 'timeout' has
+  // elapsed.
+  void wait(std::uint32_t seq, std::chrono::microseconds timeout);
+};
+
+// Control state of a descriptor ring. Producer and consumer indices reside
+// on separate cache lines.
+struct RingCtl {
+  alignas(64) std::atomic<std::uint64_t> wr{0};
+  alignas(64) std::atomic<std::uint64_t> rd{0};
+  alignas(64) Doorbell db;
+};
+
+// Shared region header.
+struct DmaRegion {
+  static constexpr std::uint32_t MAGIC = 0x4F42444D; // "OBDM"
+
+  // Set, once the region has been initialized, to MAGIC.
+  std::atomic<std::uint32_t> magic;
+  // Ring sizes (in descriptors; power of two).
+  std::uint32_t cmd_n;
+  std::uint32_t rsp_n;
+  // Server state.
+  std::atomic<std::uint32_t> running;
+  // Stop requested by a client; the server drains and exits.
+  std::atomic<std::uint32_t> stop;
+
+  // Host -> Engine
+  RingCtl cmd;
+  // Engine -> Host
+  RingCtl rsp;
+
+  // Total region size for the given ring sizes.
+  static std::size_t bytes(std::size_t cmd_n, std::size_t rsp_n);
+
+  std::byte* cmd_ring() {
+    return reinterpret_cast<std::byte*>(this) + sizeof(DmaRegion);
+  }
+  std::byte* rsp_ring() { return cmd_ring() + cmd_n * wire::Cmd::BYTES; }
+};
+
+// Shared memory mapping of a DmaRegion.
+class Shm {
+ public:
+  // Create (and initialize) region 'name', replacing any prior region.
+  static Shm create(const std::string& name, std::size_t cmd_n,
+                    std::size_t rsp_n);
+
+  // Attach to existing region 'name'; awaits its creation and
+  // initialization for up to 'timeout'.
+  static Shm open(const std::string& name,
+                  std::chrono::milliseconds timeout =
+                      std::chrono::milliseconds{5000});
+
+  Shm() = default;
+  Shm(Shm&& s) noexcept;
+  Shm& operator=(Shm&& s) noexcept;
+  ~Shm();
+
+  // Mapped region, or nullptr on failure to create/attach.
+  DmaRegion* region() const { return r_; }
+
+  // Remove region 'name' from the namespace (existing mappings persist).
+  static void unlink(const std::string& name);
+
+ private:
+  DmaRegion* r_ = nullptr;
+  std::size_t bytes_ = 0;
+};
+
+// Client (and server) waiting discipline.
+enum class Wait {
+  // Spin on the ring indices.
+  Poll,
+  // Sleep on the doorbell whilst the ring is empty.
+  Interrupt
+};
+
+struct ServerOptions {
+  // Shared memory region name.
+  std::string name = "/ob_dma";
+
+  // Ring sizes (descriptors; power of two).
+  std::size_t cmd_n = 4096;
+  std::size_t rsp_n = 4096;
+
+  // Descriptor fetch model: descriptors are fetched from the command ring in
+  // bursts of up to 'fetch_n' into a prefetch buffer of 'prefetch_n'
+  // entries, and become visible to the engine 'fetch_latency' cycles later.
+  std::size_t fetch_n = 8;
+  std::size_t prefetch_n = 32;
+  std::size_t fetch_latency = 16;
+
+  // Response write-back: responses are posted (and the doorbell rung) once
+  // 'post_n' have accumulated or the engine has been idle for
+  // 'post_idle' cycles.
+  std::size_t post_n = 8;
+  std::size_t post_idle = 4;
+
+  // Engine cycles without activity after which the server sleeps on the
+  // command doorbell (Wait::Interrupt), or continues to clock the engine
+  // (Wait::Poll).
+  std::size_t idle_n = 64;
+  Wait wait = Wait::Interrupt;
+};
+
+// Server statistics.
+struct ServerStats {
+  std::string to_string() const;
+
+  // Mean command ring fill level (descriptors awaiting fetch), sampled on
+  // each engine cycle.
+  double cmd_fill_mean() const {
+    return cycles ? static_cast<double>(cmd_fill_sum) / cycles : 0.0;
+  }
+
+  vluint64_t cycles = 0;
+  std::size_t cmd_n = 0;
+  std::size_t rsp_n = 0;
+  std::size_t fetches = 0;
+  std::size_t posts = 0;
+  std::size_t sleeps = 0;
+  // Command ring fill level.
+  vluint64_t cmd_fill_sum = 0;
+  std::size_t cmd_fill_max = 0;
+  // Prefetch buffer high-water mark.
+  std::size_t prefetch_max = 0;
+  // Cycles for which response accept was withheld as the response ring
+  // was full.
+  vluint64_t rsp_full_cycles = 0;
+};
+
+// Engine server; owns the Verilated engine and services the rings of a
+// shared region until a client requests stop.
+class Server {
+ public:
+  explicit Server(const ServerOptions& opts = ServerOptions{});
+  ~Server();
+
+  // Region has been created.
+  bool ok() const { return r_ != nullptr; }
+
+  // Service the rings until stopped.
+  void run();
+
+  const ServerStats& stats() const { return stats_; }
+
+ private:
+  struct Fetched {
+    vluint64_t ready;
+    Command cmd;
+  };
+
+  // Advance the engine by a cycle.
+  void step();
+
+  // Fetch descriptors from the command ring.
+  void fetch();
+
+  // Sample response interfaces; returns true on activity.
+  bool reap();
+
+  // Post accumulated responses to the host.
+  void post();
+
+  ServerOptions opts_;
+  Shm shm_;
+  DmaRegion* r_ = nullptr;
+
+  Vtb_ob* u_ = nullptr;
+  VSignals vs_;
+
+  vluint64_t cycle_ = 0;
+
+  // Descriptors fetched but not yet issued to the engine.
+  std::deque<Fetched> prefetch_;
+  // Cached host-side indices.
+  vluint64_t cmd_rd_ = 0;
+  vluint64_t rsp_wr_ = 0;
+  vluint64_t rsp_posted_ = 0;
+
+  ServerStats stats_;
+};
+
+// Client library; attaches to the region of a running server.
+class Client {
+ public:
+  explicit Client(const std::string& name = "/ob_dma");
+
+  // Attached to the region of a server. Otherwise, the methods below are
+  // no-ops (returning zero).
+  bool connected() const { return r_ != nullptr; }
+
+  // Submit commands [first, first + n); descriptors are encoded directly
+  // into the command ring and the doorbell rung once for the batch. Returns
+  // the number submitted (fewer than 'n' should the ring become full).
+  std::size_t submit(const Command* first, std::size_t n);
+
+  // Reap up to 'n' responses into 'out' without blocking; returns the
+  // number reaped.
+  std::size_t poll(Response* out, std::size_t n);
+
+  // Reap up to 'n' responses into 'out'; blocks, according to 'w', until at
+  // least one response is available or 'timeout' elapses.
+  std::size_t wait(Response* out, std::size_t n, Wait w,
+                   std::chrono::microseconds timeout =
+                       std::chrono::microseconds{1000000});
+
+  // Request that the server stop (once the command ring has drained).
+  void stop();
+
+ private:
+  Shm shm_;
+  DmaRegion* r_ = nullptr;
+};
+
+} // namespace tb::dma
+
+#endif
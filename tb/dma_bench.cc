@@ -0,0 +1,168 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "dma.h"
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Host interface benchmark: end-to-end latency (submission of a command to
+// the receipt of its first response) and throughput through the shared
+// memory rings, for a given submission batch size and waiting discipline.
+// The engine server is forked unless 'connect' is given, in which case an
+// ob_dma_server must already be running.
+//
+// Usage: dma_bench [n] [batch] [poll|irq] [connect]
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double percentile(std::vector<double>& v, double p) {
+  if (v.empty()) return 0.0;
+  const std::size_t i = static_cast<std::size_t>(p * (v.size() - 1));
+  std::nth_element(v.begin(), v.begin() + i, v.end());
+  return v[i];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t n = (argc > 1) ? std::stoul(argv[1]) : (1 << 16);
+  const std::size_t batch = (argc > 2) ? std::stoul(argv[2]) : 16;
+  const tb::dma::Wait w = ((argc > 3) && (std::strcmp(argv[3], "poll") == 0))
+                              ? tb::dma::Wait::Poll
+                              : tb::dma::Wait::Interrupt;
+  const bool connect = (argc > 4) && (std::strcmp(argv[4], "connect") == 0);
+
+  tb::dma::ServerOptions opts;
+  opts.name = "/ob_dma_bench." + std::to_string(::getpid());
+  if (connect) opts.name = "/ob_dma";
+  opts.wait = w;
+
+  pid_t pid = 0;
+  if (!connect) {
+    tb::dma::Shm::unlink(opts.name);
+    pid = ::fork();
+    if (pid == 0) {
+      tb::dma::Server server{opts};
+      server.run();
+      std::cout << "[server] " << server.stats().to_string() << std::endl;
+      ::_exit(server.ok() ? 0 : 1);
+    }
+  }
+
+  tb::dma::Client client{opts.name};
+  if (!client.connected()) {
+    std::cerr << "Unable to attach to shared region: " << opts.name << "\n";
+    if (pid > 0) {
+      ::kill(pid, SIGKILL);
+      ::waitpid(pid, nullptr, 0);
+      tb::dma::Shm::unlink(opts.name);
+    }
+    return 1;
+  }
+
+  // Stimulus
+  tb::Random::init(1);
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::QryBidAsk, 4);
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::PopTopBid, 3);
+  bg.push_back(tb::Opcode::PopTopAsk, 3);
+  bg.push_back(tb::Opcode::BuyMarket, 1);
+  bg.push_back(tb::Opcode::SellMarket, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+  const std::deque<tb::Command> d = gen.generate(n);
+  const std::vector<tb::Command> cmds(d.begin(), d.end());
+
+  std::unordered_map<vluint32_t, clock_type::time_point> issued;
+  std::vector<double> latency_ns;
+  std::vector<double> engine_cycles;
+  latency_ns.reserve(n);
+  std::vector<tb::Response> rsps(256);
+
+  const auto start = clock_type::now();
+  std::size_t submitted = 0;
+  while ((submitted < cmds.size()) || !issued.empty()) {
+    if (submitted < cmds.size()) {
+      const std::size_t m = std::min(batch, cmds.size() - submitted);
+      const auto now = clock_type::now();
+      const std::size_t k = client.submit(&cmds[submitted], m);
+      for (std::size_t i = 0; i < k; i++) {
+        issued.emplace(cmds[submitted + i].uid, now);
+      }
+      submitted += k;
+    }
+    const std::size_t k =
+        client.wait(rsps.data(), rsps.size(), w, std::chrono::milliseconds{1});
+    const auto now = clock_type::now();
+    for (std::size_t i = 0; i < k; i++) {
+      if (rsps[i].is_trade()) continue;
+      if (auto it = issued.find(rsps[i].uid); it != issued.end()) {
+        latency_ns.push_back(
+            std::chrono::duration<double, std::nano>(now - it->second).count());
+        engine_cycles.push_back(rsps[i].latency());
+        issued.erase(it);
+      }
+    }
+    if ((k == 0) && (submitted == cmds.size()) && !issued.empty() &&
+        (clock_type::now() - start) > std::chrono::seconds{60}) {
+      std::cerr << issued.size() << " command(s) unacknowledged\n";
+      break;
+    }
+  }
+  const double elapsed =
+      std::chrono::duration<double>(clock_type::now() - start).count();
+
+  client.stop();
+  if (pid > 0) {
+    int status;
+    ::waitpid(pid, &status, 0);
+    // The server exits without unwinding; unlink its region.
+    tb::dma::Shm::unlink(opts.name);
+  }
+
+  std::cout << "n=" << n << " batch=" << batch
+            << " wait=" << ((w == tb::dma::Wait::Poll) ? "poll" : "irq")
+            << "\n"
+            << "throughput: " << (submitted / elapsed) << " cmd/s\n"
+            << "latency (ns): p50=" << percentile(latency_ns, 0.50)
+            << " p99=" << percentile(latency_ns, 0.99)
+            << " max=" << percentile(latency_ns, 1.0) << "\n"
+            << "engine (cycles): p50=" << percentile(engine_cycles, 0.50)
+            << " p99=" << percentile(engine_cycles, 0.99) << "\n";
+  return 0;
+}
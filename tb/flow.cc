@@ -0,0 +1,299 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "flow.h"
+#include "bcd.h"
+#include "utility.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+namespace tb::flow {
+
+namespace {
+
+// Fields configurable by name.
+const std::pair<const char*, double Params::*> FIELDS[] = {
+  {"mid", &Params::mid},
+  {"drift", &Params::drift},
+  {"volatility", &Params::volatility},
+  {"tick", &Params::tick},
+  {"mu", &Params::mu},
+  {"alpha", &Params::alpha},
+  {"beta", &Params::beta},
+  {"limit_w", &Params::limit_w},
+  {"market_w", &Params::market_w},
+  {"query_w", &Params::query_w},
+  {"buy_p", &Params::buy_p},
+  {"depth", &Params::depth},
+  {"cross_p", &Params::cross_p},
+  {"qty_min", &Params::qty_min},
+  {"qty_alpha", &Params::qty_alpha},
+  {"qty_max", &Params::qty_max},
+  {"cancel_p", &Params::cancel_p},
+  {"cancel_shape", &Params::cancel_shape},
+  {"cancel_scale", &Params::cancel_scale},
+};
+
+// Arrival kinds (index into the kind table).
+enum Kind : std::size_t { Limit, Market, Query };
+
+std::string trim(const std::string& s) {
+  const std::size_t b = s.find_first_not_of(" \t\r");
+  if (b == std::string::npos) return {};
+  const std::size_t e = s.find_last_not_of(" \t\r");
+  return s.substr(b, e - b + 1);
+}
+
+// Uniform double in range (0, 1].
+double uniform_oc(Xoshiro256pp& rng) { return 1.0 - rng.uniform01(); }
+
+} // namespace
+
+std::string Params::to_string() const {
+  utility::KVListRenderer r;
+  r.add_field("seed", std::to_string(seed));
+  for (const auto& [name, field] : FIELDS) {
+    std::ostringstream ss;
+    ss << this->*field;
+    r.add_field(name, ss.str());
+  }
+  return r.to_string();
+}
+
+bool Params::valid() const {
+  auto p = [](double v) { return (v >= 0.0) && (v <= 1.0); };
+  if ((mid <= 0.0) || (volatility < 0.0) || (tick < 0.01)) return false;
+  if ((mu <= 0.0) || (alpha < 0.0) || (beta <= 0.0)) return false;
+  // Otherwise, the arrival intensity grows without bound.
+  if (alpha >= beta) return false;
+  if ((limit_w < 0.0) || (market_w < 0.0) || (query_w < 0.0)) return false;
+  if ((limit_w + market_w + query_w) <= 0.0) return false;
+  if (!p(buy_p) || !p(cross_p) || !p(cancel_p)) return false;
+  if (depth < 0.0) return false;
+  if ((qty_min < 1.0) || (qty_alpha <= 0.0) || (qty_max < qty_min)) return false;
+  if (qty_max > std::numeric_limits<vluint16_t>::max()) return false;
+  if ((cancel_shape <= 0.0) || (cancel_scale <= 0.0)) return false;
+  return true;
+}
+
+bool parse(const std::string& text, Params& p) {
+  std::istringstream is{text};
+  for (std::string line; std::getline(is, line); ) {
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty()) continue;
+
+    const std::size_t eq = line.find('=');
+    if (eq == std::string::npos) return false;
+    const std::string key = trim(line.substr(0, eq));
+    const std::string value = trim(line.substr(eq + 1));
+    if (value.empty()) return false;
+
+    char* end = nullptr;
+    if (key == "seed") {
+      if (value.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+      }
+      p.seed = std::strtoull(value.c_str(), &end, 10);
+      continue;
+    }
+    auto it = std::find_if(std::begin(FIELDS), std::end(FIELDS),
+                           [&](const auto& f) { return key == f.first; });
+    if (it == std::end(FIELDS)) return false;
+    const double v = std::strtod(value.c_str(), &end);
+    if (*end != '\0') return false;
+    p.*(it->second) = v;
+  }
+  return p.valid();
+}
+
+bool load(const std::string& path, Params& p) {
+  std::ifstream is{path};
+  if (!is) return false;
+
+  std::ostringstream ss;
+  ss << is.rdbuf();
+  return parse(ss.str(), p);
+}
+
+std::string GeneratorStats::to_string() const {
+  utility::KVListRenderer r;
+  r.add_field("limit_n", std::to_string(limit_n));
+  r.add_field("market_n", std::to_string(market_n));
+  r.add_field("query_n", std::to_string(query_n));
+  r.add_field("cancel_n", std::to_string(cancel_n));
+  r.add_field("cross_n", std::to_string(cross_n));
+  r.add_field("stale_n", std::to_string(stale_n));
+  r.add_field("clamped_n", std::to_string(clamped_n));
+  r.add_field("peak", std::to_string(peak));
+  return r.to_string();
+}
+
+Generator::Generator(const Params& p)
+    : p_(p), rng_(p.seed), mid_(p.mid),
+      model_(BID_TABLE_DEPTH_N, ASK_TABLE_DEPTH_N) {
+  kinds_.build({p_.limit_w, p_.market_w, p_.query_w});
+  excite();
+}
+
+Arrival Generator::next() {
+  Arrival a;
+  Command& cmd = a.cmd;
+  for (;;) {
+    if (!cancels_.empty() && (cancels_.top().t <= arrival_t_)) {
+      const Pending c = cancels_.top();
+      cancels_.pop();
+      advance(c.t);
+      // Order has since traded (or been swept) away.
+      if (model_.find_limit(c.uid) == nullptr) {
+        ++stats_.stale_n;
+        continue;
+      }
+      cmd = Command{};
+      cmd.valid = true;
+      cmd.opcode = Opcode::Cancel;
+      cmd.uid1 = c.uid;
+      ++stats_.cancel_n;
+    } else {
+      advance(arrival_t_);
+      order(cmd);
+      excite();
+    }
+    break;
+  }
+  cmd.uid = uid_++;
+  model_.apply(cmd);
+  a.cycle = static_cast<vluint64_t>(t_);
+  return a;
+}
+
+std::vector<Arrival> Generator::generate(std::size_t n) {
+  std::vector<Arrival> as;
+  as.reserve(n);
+  while (n--) as.push_back(next());
+  return as;
+}
+
+void Generator::excite() {
+  // Ogata thinning: between arrivals the intensity only decays, hence the
+  // intensity at the most recent candidate bounds that at the next. The
+  // candidate is accepted with the ratio of the decayed to the bound.
+  for (;;) {
+    const double bound = p_.mu + excitation_;
+    const double w = -std::log(uniform_oc(rng_)) / bound;
+    arrival_t_ += w;
+    excitation_ *= std::exp(-p_.beta * w);
+    const double intensity = p_.mu + excitation_;
+    if (rng_.uniform01() * bound < intensity) {
+      excitation_ += p_.alpha;
+      stats_.peak = std::max(stats_.peak, intensity);
+      return;
+    }
+  }
+}
+
+void Generator::advance(double t) {
+  const double dt = t - t_;
+  if (dt > 0.0) {
+    mid_ += p_.drift * dt + p_.volatility * std::sqrt(dt) * rng_.normal(0, 1);
+    // Retain the mid-price within the representable range.
+    mid_ = std::clamp(mid_, 1.0, 999.0);
+  }
+  t_ = std::max(t_, t);
+}
+
+void Generator::order(Command& cmd) {
+  cmd = Command{};
+  cmd.valid = true;
+  const bool is_buy = rng_.boolean(p_.buy_p);
+  switch (kinds_(rng_)) {
+    case Limit: {
+      // Geometric distance (ticks) of mean 'depth', behind the mid-price or,
+      // should the order cross, beyond it.
+      double ticks = 1.0;
+      if (p_.depth > 0.0) {
+        ticks += std::floor(-std::log(uniform_oc(rng_)) * p_.depth);
+      }
+      if (rng_.boolean(p_.cross_p)) {
+        ticks = -ticks;
+        ++stats_.cross_n;
+      }
+      cmd.opcode = is_buy ? Opcode::BuyLimit : Opcode::SellLimit;
+      cmd.quantity = quantity();
+      cmd.price = price(is_buy ? -ticks : ticks);
+      ++stats_.limit_n;
+      if (rng_.boolean(p_.cancel_p)) {
+        // Weibull age at cancellation (inverse transform).
+        const double age = p_.cancel_scale *
+            std::pow(-std::log(uniform_oc(rng_)), 1.0 / p_.cancel_shape);
+        cancels_.push(Pending{t_ + age, uid_});
+      }
+    } break;
+    case Market: {
+      cmd.opcode = is_buy ? Opcode::BuyMarket : Opcode::SellMarket;
+      cmd.quantity = quantity();
+      ++stats_.market_n;
+    } break;
+    default: {
+      cmd.opcode = Opcode::QryBidAsk;
+      ++stats_.query_n;
+    } break;
+  }
+}
+
+vluint16_t Generator::quantity() {
+  // Pareto (inverse transform), truncated.
+  const double q =
+      p_.qty_min * std::pow(uniform_oc(rng_), -1.0 / p_.qty_alpha);
+  if (q >= p_.qty_max) {
+    ++stats_.clamped_n;
+    return static_cast<vluint16_t>(p_.qty_max);
+  }
+  return static_cast<vluint16_t>(q);
+}
+
+vluint32_t Generator::price(double ticks) const {
+  // Quantize to the tick grid.
+  const double tick_n = std::round(mid_ / p_.tick) + ticks;
+  return bcd::from_double(std::max(tick_n * p_.tick, p_.tick));
+}
+
+void schedule(const std::vector<Arrival>& as, TB& tb) {
+  vluint64_t cycle = 0;
+  for (const Arrival& a : as) {
+    // Idle (invalid) commands until the arrival cycle.
+    for (; cycle < a.cycle; cycle++) tb.push_back(Command{});
+    tb.push_back(a.cmd);
+    ++cycle;
+  }
+}
+
+} // namespace tb::flow
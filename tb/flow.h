@@ -0,0 +1,213 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_FLOW_H
+#define M_TB_FLOW_H
+
+#include "tb.h"
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <vector>
+
+// Synthetic order flow: a limit order book workload with the features of
+// production flow absent from StimulusGenerator's stationary stream.
+//
+//   - Arrivals are self-exciting (a Hawkes process with exponential kernel);
+//     each arrival raises the arrival intensity by 'alpha', which decays at
+//     rate 'beta', such that arrivals cluster into bursts.
+//   - The mid-price drifts (Brownian motion with drift); limit orders rest at
+//     a geometric number of ticks behind it, or cross it (sweeping the
+//     opposing side).
+//   - Quantities are heavy tailed (Pareto, truncated).
+//   - A fraction of limit orders is cancelled on reaching a Weibull
+//     distributed age; a shape below one concentrates cancels upon young
+//     orders, and as cancels follow the arrivals that placed them, arrival
+//     bursts are followed by cancel bursts.
+//
+// Time is measured in cycles of the UUT, such that a flow may be scheduled
+// onto the command interface (see schedule).
+//
+namespace tb::flow {
+
+struct Params {
+  std::string to_string() const;
+
+  // Parameters are self-consistent.
+  bool valid() const;
+
+  // Random seed.
+  std::uint64_t seed = 1;
+
+  // Mid-price (dollars) at time zero, its drift (dollars per cycle) and
+  // volatility (dollars per square root cycle).
+  double mid = 100.0;
+  double drift = 0.0;
+  double volatility = 0.005;
+
+  // Price increment (dollars).
+  double tick = 0.01;
+
+  // Arrival intensity: baseline (arrivals per cycle), excitation per arrival
+  // and its decay rate (per cycle). The flow is stationary for
+  // alpha < beta, with mean intensity mu / (1 - alpha / beta).
+  double mu = 0.01;
+  double alpha = 0.08;
+  double beta = 0.1;
+
+  // Relative weights of limit, market and top-of-book query arrivals.
+  double limit_w = 90.0;
+  double market_w = 5.0;
+  double query_w = 5.0;
+
+  // Probability of an arrival being a buy.
+  double buy_p = 0.5;
+
+  // Mean distance (ticks) of a limit order behind the mid-price, and the
+  // probability of it instead crossing the mid-price by the same distance.
+  double depth = 4.0;
+  double cross_p = 0.05;
+
+  // Quantity: Pareto of minimum 'qty_min' and tail index 'qty_alpha',
+  // truncated at 'qty_max'.
+  double qty_min = 10.0;
+  double qty_alpha = 1.5;
+  double qty_max = 10000.0;
+
+  // Probability of a limit order being cancelled, and the shape and scale
+  // (cycles) of the Weibull distribution of its age at cancellation.
+  double cancel_p = 0.7;
+  double cancel_shape = 0.6;
+  double cancel_scale = 2000.0;
+};
+
+// Parse parameters from 'text'; one 'key = value' per line, where key is
+// the name of a Params field, '#' introduces a comment and blank lines are
+// ignored. Fields not named retain their present value. Returns false on an
+// unknown key, a malformed value, or should the result be invalid.
+bool parse(const std::string& text, Params& p);
+
+// Parse parameters from file 'path' (as above).
+bool load(const std::string& path, Params& p);
+
+// Command and the cycle of its arrival.
+struct Arrival {
+  vluint64_t cycle = 0;
+  Command cmd;
+};
+
+struct GeneratorStats {
+  std::string to_string() const;
+
+  // Arrivals emitted, by kind.
+  std::size_t limit_n = 0;
+  std::size_t market_n = 0;
+  std::size_t query_n = 0;
+  std::size_t cancel_n = 0;
+  // Limit orders crossing the mid-price.
+  std::size_t cross_n = 0;
+  // Cancels not emitted as the order had already been retired.
+  std::size_t stale_n = 0;
+  // Quantities truncated at qty_max.
+  std::size_t clamped_n = 0;
+  // Peak arrival intensity (arrivals per cycle).
+  double peak = 0.0;
+};
+
+class Generator {
+ public:
+  explicit Generator(const Params& p = Params{});
+
+  // Next arrival; arrivals are emitted in non-decreasing cycle order.
+  Arrival next();
+
+  // Generate 'n' arrivals.
+  std::vector<Arrival> generate(std::size_t n);
+
+  // Current mid-price (dollars).
+  double mid() const { return mid_; }
+
+  const GeneratorStats& stats() const { return stats_; }
+
+ private:
+  // Scheduled cancellation of a limit order.
+  struct Pending {
+    double t;
+    vluint32_t uid;
+
+    bool operator>(const Pending& rhs) const { return t > rhs.t; }
+  };
+
+  // Advance the self-exciting process to its next arrival.
+  void excite();
+
+  // Advance the mid-price to time 't'.
+  void advance(double t);
+
+  // Render the command of an arrival at the current time.
+  void order(Command& cmd);
+
+  vluint16_t quantity();
+
+  // Price 'ticks' from the mid-price, as packed BCD.
+  vluint32_t price(double ticks) const;
+
+  Params p_;
+  Xoshiro256pp rng_;
+  // Arrival kind (limit, market or query).
+  AliasTable kinds_;
+
+  // Current time, and the mid-price at that time.
+  double t_ = 0.0;
+  double mid_;
+
+  // Time of the next arrival, and the excitation at that time.
+  double arrival_t_ = 0.0;
+  double excitation_ = 0.0;
+
+  // Scheduled cancellations, earliest first.
+  std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>>
+      cancels_;
+
+  vluint32_t uid_ = 0;
+
+  // Book as constructed by the flow; cancels of retired orders are elided.
+  Model model_;
+
+  GeneratorStats stats_;
+};
+
+// Push the commands of 'as' to 'tb', preceding each by idle cycles such
+// that it is presented at its arrival cycle. Idle cycles elapse only whilst
+// the command interface is not full, hence backpressure delays the
+// remainder of the flow (as a queue at the gateway).
+void schedule(const std::vector<Arrival>& as, TB& tb);
+
+} // namespace tb::flow
+
+#endif
@@ -0,0 +1,56 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "flow.h"
+#include <iostream>
+#include <string>
+
+// Synthetic flow benchmark: generate a bursty order flow (see tb/flow.h),
+// optionally parameterized from a file, and run it against the engine at
+// its arrival times; reports throughput, reject rate and command latency.
+//
+// Usage: flow_bench [n] [params]
+
+int main(int argc, char** argv) {
+  const std::size_t n = (argc > 1) ? std::stoul(argv[1]) : 100000;
+  tb::flow::Params p;
+  if ((argc > 2) && !tb::flow::load(argv[2], p)) {
+    std::cerr << "Unable to load parameters: " << argv[2] << "\n";
+    return 1;
+  }
+  std::cout << p.to_string() << "\n";
+
+  tb::flow::Generator gen{p};
+  const std::vector<tb::flow::Arrival> as = gen.generate(n);
+  std::cout << gen.stats().to_string() << "\n";
+
+  tb::TB tb;
+  tb::flow::schedule(as, tb);
+  tb.run();
+  std::cout << tb.throughput().to_string() << "\n"
+            << tb.latency().to_string() << "\n";
+  return 0;
+}
@@ -0,0 +1,356 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "itch.h"
+#include "bcd.h"
+#include "utility.h"
+#include "wire.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace tb::itch {
+
+namespace {
+
+// Message lengths (excluding framing).
+constexpr std::size_t ADD_N = 36;
+constexpr std::size_t EXECUTED_N = 31;
+constexpr std::size_t CANCEL_N = 23;
+constexpr std::size_t DELETE_N = 19;
+constexpr std::size_t REPLACE_N = 35;
+
+// Offset of the order reference number, common to all order messages.
+constexpr std::size_t REF_OFF = 11;
+
+// Big-endian unsigned field of 'n' bytes at 'p'.
+std::uint64_t be(const std::byte* p, std::size_t n) {
+  std::uint64_t v = 0;
+  for (std::size_t i = 0; i < n; i++) {
+    v = (v << 8) | std::to_integer<std::uint64_t>(p[i]);
+  }
+  return v;
+}
+
+// Convert ITCH price (4 implied decimal places) to packed BCD; returns false
+// if not representable.
+bool to_price(std::uint32_t p, vluint32_t& price) {
+  const std::uint32_t cents = p / 100;
+  if (cents > bcd::CENTS_MAX) return false;
+  price = bcd::from_cents(cents);
+  return true;
+}
+
+// Shares saturated to the width of the quantity field.
+vluint16_t saturate(std::uint32_t shares) {
+  return static_cast<vluint16_t>(
+      std::min<std::uint32_t>(shares, std::numeric_limits<vluint16_t>::max()));
+}
+
+} // namespace
+
+File File::open(const std::string& path) {
+  File f;
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return f;
+
+  struct stat st;
+  void* p = MAP_FAILED;
+  if ((::fstat(fd, &st) == 0) && (st.st_size > 0)) {
+    p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ,
+               MAP_PRIVATE, fd, 0);
+  }
+  ::close(fd);
+  if (p == MAP_FAILED) return f;
+
+  // Messages are visited once, in order.
+  ::madvise(p, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+  f.p_ = static_cast<const std::byte*>(p);
+  f.n_ = static_cast<std::size_t>(st.st_size);
+  return f;
+}
+
+File::File(File&& f) noexcept : p_(f.p_), n_(f.n_) {
+  f.p_ = nullptr;
+  f.n_ = 0;
+}
+
+File& File::operator=(File&& f) noexcept {
+  if (this != std::addressof(f)) {
+    close();
+    std::swap(p_, f.p_);
+    std::swap(n_, f.n_);
+  }
+  return *this;
+}
+
+File::~File() { close(); }
+
+void File::close() {
+  if (p_ != nullptr) {
+    ::munmap(const_cast<std::byte*>(p_), n_);
+    p_ = nullptr;
+    n_ = 0;
+  }
+}
+
+bool Reader::next(const std::byte*& msg, std::size_t& n) {
+  if ((end_ - p_) < 2) return false;
+  n = static_cast<std::size_t>(be(p_, 2));
+  if (static_cast<std::size_t>(end_ - p_ - 2) < n) return false;
+  msg = p_ + 2;
+  p_ += (2 + n);
+  return true;
+}
+
+std::string ConverterStats::to_string() const {
+  utility::KVListRenderer r;
+  r.add_field("msg_n", std::to_string(msg_n));
+  r.add_field("filtered_n", std::to_string(filtered_n));
+  r.add_field("unknown_n", std::to_string(unknown_n));
+  r.add_field("price_range_n", std::to_string(price_range_n));
+  r.add_field("clamped_n", std::to_string(clamped_n));
+  r.add_field("cmd_n", std::to_string(cmd_n));
+  return r.to_string();
+}
+
+Converter::Converter(const ConverterOptions& opts)
+    : opts_(opts), uid_(opts.uid_base) {
+  std::memset(symbol_, ' ', sizeof(symbol_));
+  std::memcpy(symbol_, opts_.symbol.data(),
+              std::min(opts_.symbol.size(), sizeof(symbol_)));
+}
+
+bool Converter::convert(const std::byte* msg, std::size_t n, Command& cmd) {
+  stats_.msg_n++;
+  if (n == 0) {
+    stats_.filtered_n++;
+    return false;
+  }
+
+  bool emit = false;
+  switch (static_cast<char>(msg[0])) {
+    case Type::AddOrder:
+    case Type::AddOrderMpid: {
+      emit = (n >= ADD_N) && add(msg, cmd);
+    } break;
+    case Type::OrderExecuted:
+    case Type::OrderExecutedPrice: {
+      emit = (n >= EXECUTED_N) && execute(msg, cmd);
+    } break;
+    case Type::OrderCancel: {
+      emit = (n >= CANCEL_N) && reduce(msg, cmd);
+    } break;
+    case Type::OrderDelete: {
+      emit = (n >= DELETE_N) && remove(msg, cmd);
+    } break;
+    case Type::OrderReplace: {
+      emit = (n >= REPLACE_N) && replace(msg, cmd);
+    } break;
+    default: {
+      // Otherwise, not applicable to the book.
+      stats_.filtered_n++;
+    } break;
+  }
+  if (emit) stats_.cmd_n++;
+  return emit;
+}
+
+vluint16_t Converter::quantity(std::uint32_t shares) {
+  const vluint16_t q = saturate(shares);
+  if (q != shares) stats_.clamped_n++;
+  return q;
+}
+
+bool Converter::add(const std::byte* msg, Command& cmd) {
+  // Stock (8), space padded, at offset 24.
+  if (std::memcmp(msg + 24, symbol_, sizeof(symbol_)) != 0) {
+    stats_.filtered_n++;
+    return false;
+  }
+  Order o;
+  if (!to_price(static_cast<std::uint32_t>(be(msg + 32, 4)), o.price)) {
+    stats_.price_range_n++;
+    return false;
+  }
+  o.uid = uid_++;
+  o.is_buy = (static_cast<char>(msg[19]) == 'B');
+  o.shares = static_cast<std::uint32_t>(be(msg + 20, 4));
+  orders_[be(msg + REF_OFF, 8)] = o;
+
+  cmd = Command{};
+  cmd.valid = true;
+  cmd.opcode = o.is_buy ? Opcode::BuyLimit : Opcode::SellLimit;
+  cmd.uid = o.uid;
+  cmd.quantity = quantity(o.shares);
+  cmd.price = o.price;
+  return true;
+}
+
+bool Converter::execute(const std::byte* msg, Command& cmd) {
+  auto it = orders_.find(be(msg + REF_OFF, 8));
+  if (it == orders_.end()) {
+    stats_.unknown_n++;
+    return false;
+  }
+  Order& o = it->second;
+  const std::uint32_t executed =
+      std::min(o.shares, static_cast<std::uint32_t>(be(msg + 19, 4)));
+
+  if (opts_.exec == Exec::Amend) {
+    const vluint16_t was = saturate(o.shares);
+    o.shares -= executed;
+    return amend(it, was, cmd);
+  }
+
+  cmd = Command{};
+  cmd.valid = true;
+  cmd.opcode = o.is_buy ? Opcode::SellMarket : Opcode::BuyMarket;
+  cmd.tif = Tif::ImmediateOrCancel;
+  cmd.uid = uid_++;
+  cmd.quantity = quantity(executed);
+  o.shares -= executed;
+  if (o.shares == 0) orders_.erase(it);
+  return true;
+}
+
+bool Converter::reduce(const std::byte* msg, Command& cmd) {
+  auto it = orders_.find(be(msg + REF_OFF, 8));
+  if (it == orders_.end()) {
+    stats_.unknown_n++;
+    return false;
+  }
+  Order& o = it->second;
+  const vluint16_t was = saturate(o.shares);
+  o.shares -= std::min(o.shares, static_cast<std::uint32_t>(be(msg + 19, 4)));
+  return amend(it, was, cmd);
+}
+
+bool Converter::remove(const std::byte* msg, Command& cmd) {
+  auto it = orders_.find(be(msg + REF_OFF, 8));
+  if (it == orders_.end()) {
+    stats_.unknown_n++;
+    return false;
+  }
+  it->second.shares = 0;
+  return amend(it, 0, cmd);
+}
+
+bool Converter::replace(const std::byte* msg, Command& cmd) {
+  auto it = orders_.find(be(msg + REF_OFF, 8));
+  if (it == orders_.end()) {
+    stats_.unknown_n++;
+    return false;
+  }
+  Order o = it->second;
+  orders_.erase(it);
+
+  cmd = Command{};
+  cmd.valid = true;
+  cmd.uid = uid_++;
+  cmd.uid1 = o.uid;
+  if (!to_price(static_cast<std::uint32_t>(be(msg + 31, 4)), o.price)) {
+    // Replacement unrepresentable; retire the original order.
+    stats_.price_range_n++;
+    cmd.opcode = Opcode::Cancel;
+    return true;
+  }
+  // The new order reference aliases the original uid, which the engine
+  // retains across the amendment.
+  o.shares = static_cast<std::uint32_t>(be(msg + 27, 4));
+  orders_[be(msg + 19, 8)] = o;
+
+  cmd.opcode = Opcode::Replace;
+  cmd.quantity = quantity(o.shares);
+  cmd.price = o.price;
+  return true;
+}
+
+bool Converter::amend(std::unordered_map<std::uint64_t, Order>::iterator it,
+                      vluint16_t was, Command& cmd) {
+  const Order o = it->second;
+  cmd = Command{};
+  cmd.valid = true;
+  cmd.uid1 = o.uid;
+  if (o.shares == 0) {
+    orders_.erase(it);
+    cmd.opcode = Opcode::Cancel;
+    cmd.uid = uid_++;
+    return true;
+  }
+  // Saturated quantity is unchanged; nothing to issue.
+  if (saturate(o.shares) == was) return false;
+  cmd.opcode = Opcode::Replace;
+  cmd.uid = uid_++;
+  cmd.quantity = quantity(o.shares);
+  cmd.price = o.price;
+  return true;
+}
+
+bool replay(const std::string& path, Converter& c, TB& tb) {
+  const File f = File::open(path);
+  if (!f.valid()) return false;
+
+  c.convert(f.data(), f.size(), [&](const Command& cmd) { tb.push_back(cmd); });
+  return true;
+}
+
+bool replay(const std::string& path, Converter& c, const std::string& trace) {
+  const File f = File::open(path);
+  if (!f.valid()) return false;
+
+  std::FILE* os = std::fopen(trace.c_str(), "wb");
+  if (os == nullptr) return false;
+
+  std::byte rec[wire::Cmd::BYTES];
+  c.convert(f.data(), f.size(), [&](const Command& cmd) {
+    wire::encode(cmd, rec);
+    std::fwrite(rec, sizeof(rec), 1, os);
+  });
+  return (std::fclose(os) == 0);
+}
+
+bool load(const std::string& trace, std::vector<Command>& cmds) {
+  const File f = File::open(trace);
+  if (!f.valid()) return false;
+
+  const std::size_t n = f.size() / wire::Cmd::BYTES;
+  cmds.reserve(cmds.size() + n);
+  for (std::size_t i = 0; i < n; i++) {
+    Command cmd;
+    wire::decode(f.data() + i * wire::Cmd::BYTES, cmd);
+    cmds.push_back(cmd);
+  }
+  return true;
+}
+
+} // namespace tb::itch
@@ -0,0 +1,215 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_ITCH_H
+#define M_TB_ITCH_H
+
+#include "tb.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Historical market data replay: conversion of an ITCH style message file
+// (NASDAQ TotalView-ITCH 5.0, BinaryFILE framing: each message preceded by
+// its big-endian 16b length) into engine commands. Only the order book
+// messages of a single symbol are considered:
+//
+//   A/F  Add Order           -> BuyLimit/SellLimit (new uid)
+//   E/C  Order Executed      -> SellMarket/BuyMarket IOC against the order's
+//                               side (or, amended in place; see Exec)
+//   X    Order Cancel        -> Replace at reduced quantity (or Cancel)
+//   D    Order Delete        -> Cancel
+//   U    Order Replace       -> Replace; the new order reference aliases the
+//                               uid of the original order
+//
+// Prices are re-encoded from 4 implied decimal places to packed BCD cents
+// (sub-cent digits are truncated); orders priced beyond the BCD range are
+// dropped, as are all subsequent messages referencing them. Share counts
+// are saturated to the width of the quantity field.
+//
+namespace tb::itch {
+
+// Message types.
+enum Type : char {
+  StockDirectory = 'R',
+  AddOrder = 'A',
+  AddOrderMpid = 'F',
+  OrderExecuted = 'E',
+  OrderExecutedPrice = 'C',
+  OrderCancel = 'X',
+  OrderDelete = 'D',
+  OrderReplace = 'U'
+};
+
+// Read-only memory map of a file; invalid on failure.
+class File {
+ public:
+  static File open(const std::string& path);
+
+  File() = default;
+  File(File&& f) noexcept;
+  File& operator=(File&& f) noexcept;
+  File(const File&) = delete;
+  File& operator=(const File&) = delete;
+  ~File();
+
+  bool valid() const { return p_ != nullptr; }
+
+  const std::byte* data() const { return p_; }
+  std::size_t size() const { return n_; }
+
+ private:
+  void close();
+
+  const std::byte* p_ = nullptr;
+  std::size_t n_ = 0;
+};
+
+// Iterate the framed messages of a buffer.
+class Reader {
+ public:
+  Reader(const std::byte* p, std::size_t n) : p_(p), end_(p + n) {}
+
+  // Next message; returns false at the end of the buffer, or on a truncated
+  // final message.
+  bool next(const std::byte*& msg, std::size_t& n);
+
+ private:
+  const std::byte* p_;
+  const std::byte* end_;
+};
+
+// Treatment of order executions.
+enum class Exec {
+  // Issue an IOC market order against the executed order's side, such that
+  // the execution is reproduced as a trade by the engine.
+  Market,
+  // Reduce (or cancel) the executed order; the engine's book tracks the
+  // historical book regardless of any divergence in matching.
+  Amend
+};
+
+struct ConverterOptions {
+  // Symbol of interest (without padding).
+  std::string symbol;
+
+  // Treatment of order executions.
+  Exec exec = Exec::Market;
+
+  // UID assigned to the first command.
+  vluint32_t uid_base = 0;
+};
+
+struct ConverterStats {
+  std::string to_string() const;
+
+  // Messages visited.
+  std::size_t msg_n = 0;
+  // Messages of another symbol, or of an unsupported type.
+  std::size_t filtered_n = 0;
+  // Messages referencing an unknown (or dropped) order.
+  std::size_t unknown_n = 0;
+  // Orders dropped as their price is not representable.
+  std::size_t price_range_n = 0;
+  // Commands whose quantity was saturated.
+  std::size_t clamped_n = 0;
+  // Commands emitted.
+  std::size_t cmd_n = 0;
+};
+
+class Converter {
+ public:
+  explicit Converter(const ConverterOptions& opts = ConverterOptions{});
+
+  // Convert message 'msg' of length 'n'; returns true if a command has been
+  // emitted to 'cmd'.
+  bool convert(const std::byte* msg, std::size_t n, Command& cmd);
+
+  // Convert all messages of a buffer, invoking 'f' on each command emitted.
+  template<typename F>
+  void convert(const std::byte* p, std::size_t n, F&& f) {
+    Reader r{p, n};
+    const std::byte* msg;
+    std::size_t msg_n;
+    Command cmd;
+    while (r.next(msg, msg_n)) {
+      if (convert(msg, msg_n, cmd)) f(cmd);
+    }
+  }
+
+  const ConverterStats& stats() const { return stats_; }
+
+  // Orders presently live.
+  std::size_t order_n() const { return orders_.size(); }
+
+ private:
+  struct Order {
+    vluint32_t uid;
+    bool is_buy;
+    // Outstanding shares (unsaturated).
+    std::uint32_t shares;
+    vluint32_t price;
+  };
+
+  vluint16_t quantity(std::uint32_t shares);
+
+  bool add(const std::byte* msg, Command& cmd);
+  bool execute(const std::byte* msg, Command& cmd);
+  bool reduce(const std::byte* msg, Command& cmd);
+  bool remove(const std::byte* msg, Command& cmd);
+  bool replace(const std::byte* msg, Command& cmd);
+
+  // Amend order 'it' to its outstanding shares, or cancel it should none
+  // remain.
+  bool amend(std::unordered_map<std::uint64_t, Order>::iterator it,
+             vluint16_t was, Command& cmd);
+
+  ConverterOptions opts_;
+  // Symbol of interest, space padded.
+  char symbol_[8];
+  vluint32_t uid_;
+  // Live orders by order reference number.
+  std::unordered_map<std::uint64_t, Order> orders_;
+  ConverterStats stats_;
+};
+
+// Replay file 'path' into 'tb'; returns false if the file cannot be opened.
+bool replay(const std::string& path, Converter& c, TB& tb);
+
+// Replay file 'path' to trace file 'trace' as wire format command records
+// (wire::Cmd); returns false if either file cannot be opened.
+bool replay(const std::string& path, Converter& c, const std::string& trace);
+
+// Load the commands of trace file 'trace'; returns false if the file cannot
+// be opened.
+bool load(const std::string& trace, std::vector<Command>& cmds);
+
+} // namespace tb::itch
+
+#endif
@@ -0,0 +1,72 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "itch.h"
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Historical replay: convert the order book messages of one symbol from
+// an ITCH message file, and either run them against the engine (reporting
+// throughput and reject rate), or write them to a trace file of wire format
+// command records.
+//
+// Usage: itch_replay file symbol [market|amend] [trace]
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " file symbol [market|amend] [trace]\n";
+    return 1;
+  }
+  tb::itch::ConverterOptions opts;
+  opts.symbol = argv[2];
+  if ((argc > 3) && (std::strcmp(argv[3], "amend") == 0)) {
+    opts.exec = tb::itch::Exec::Amend;
+  }
+  tb::itch::Converter c{opts};
+
+  if (argc > 4) {
+    if (!tb::itch::replay(argv[1], c, argv[4])) {
+      std::cerr << "Unable to convert: " << argv[1] << " to " << argv[4]
+                << "\n";
+      return 1;
+    }
+    std::cout << c.stats().to_string() << "\n";
+    return 0;
+  }
+
+  tb::TB tb;
+  if (!tb::itch::replay(argv[1], c, tb)) {
+    std::cerr << "Unable to open: " << argv[1] << "\n";
+    return 1;
+  }
+  std::cout << c.stats().to_string() << "\n";
+  tb.run();
+  std::cout << tb.throughput().to_string() << "\n";
+  return 0;
+}
@@ -0,0 +1,319 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "journal.h"
+#include "utility.h"
+#include "wire.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+namespace tb::journal {
+
+namespace {
+
+constexpr std::uint64_t MAGIC = 0x314C4E524A424FULL; // "OBJRNL1"
+constexpr std::uint32_t VERSION = 1;
+
+void store(std::byte* p, std::uint64_t v, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) {
+    p[i] = static_cast<std::byte>(v >> (8 * i));
+  }
+}
+
+std::uint64_t load(const std::byte* p, std::size_t n) {
+  std::uint64_t v = 0;
+  for (std::size_t i = n; i > 0; i--) {
+    v = (v << 8) | std::to_integer<std::uint64_t>(p[i - 1]);
+  }
+  return v;
+}
+
+// FNV-1a over the record, excluding the check field.
+std::uint32_t check(const Record& r) {
+  std::uint32_t h = 0x811C9DC5u;
+  for (std::size_t i = 0; i < RECORD_BYTES; i++) {
+    if ((i >= 12) && (i < 16)) continue;
+    h = (h ^ std::to_integer<std::uint32_t>(r.b[i])) * 0x01000193u;
+  }
+  return h;
+}
+
+void encode_header(std::byte* p) {
+  store(p, MAGIC, 8);
+  store(p + 8, VERSION, 4);
+  store(p + 12, RECORD_BYTES, 4);
+}
+
+bool decode_header(const std::byte* p) {
+  return (load(p, 8) == MAGIC) && (load(p + 8, 4) == VERSION) &&
+         (load(p + 12, 4) == RECORD_BYTES);
+}
+
+// Write 'n' bytes of 'p' in their entirety.
+bool write_all(int fd, const std::byte* p, std::size_t n) {
+  while (n != 0) {
+    const ssize_t k = ::write(fd, p, n);
+    if (k < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    p += k;
+    n -= static_cast<std::size_t>(k);
+  }
+  return true;
+}
+
+} // namespace
+
+void encode(std::uint64_t seq, const Command& cmd, Record& r) {
+  store(r.b, seq, 8);
+  store(r.b + 8, cmd.was_cn ? Flag::WasCn : 0, 4);
+  wire::encode(cmd, r.b + 16);
+  store(r.b + 12, check(r), 4);
+}
+
+bool decode(const Record& r, std::uint64_t& seq, Command& cmd) {
+  if (load(r.b + 12, 4) != check(r)) return false;
+  seq = load(r.b, 8);
+  wire::decode(r.b + 16, cmd);
+  cmd.was_cn = (load(r.b + 8, 4) & Flag::WasCn) != 0;
+  return true;
+}
+
+std::string JournalStats::to_string() const {
+  utility::KVListRenderer r;
+  r.add_field("records", std::to_string(records));
+  r.add_field("commits", std::to_string(commits));
+  r.add_field("group_mean", std::to_string(group_mean()));
+  r.add_field("group_max", std::to_string(group_max));
+  r.add_field("stalls", std::to_string(stalls));
+  r.add_field("discards", std::to_string(discards));
+  r.add_field("commit_ns_max", std::to_string(commit_ns_max));
+  return r.to_string();
+}
+
+Journal::Journal(const JournalOptions& opts)
+    : opts_(opts), seq_(opts.seq), q_(opts.queue_n) {
+  fd_ = ::open(opts_.path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  if (fd_ < 0) return;
+
+  struct stat st;
+  std::byte h[HEADER_BYTES];
+  bool ok = (::fstat(fd_, &st) == 0);
+  if (ok && (st.st_size == 0)) {
+    encode_header(h);
+    ok = write_all(fd_, h, sizeof(h)) && (::fdatasync(fd_) == 0);
+  } else if (ok) {
+    // A torn tail must be truncated (by recover) prior to appending, else
+    // appended records would follow it and be discarded upon recovery.
+    const std::size_t bytes = static_cast<std::size_t>(st.st_size);
+    ok = (bytes >= HEADER_BYTES) &&
+         ((bytes - HEADER_BYTES) % RECORD_BYTES == 0) &&
+         (::pread(fd_, h, sizeof(h), 0) == sizeof(h)) && decode_header(h);
+    if (ok && (bytes != HEADER_BYTES)) {
+      // The last record must pass its check (a tail of whole, but garbage,
+      // records is torn), and appended records must follow it in sequence.
+      Record r;
+      Command cmd;
+      std::uint64_t last = 0;
+      ok = (::pread(fd_, r.b, RECORD_BYTES, bytes - RECORD_BYTES) ==
+            RECORD_BYTES) && decode(r, last, cmd);
+      if (ok && (seq_ == 0)) seq_ = last + 1;
+      ok = ok && (seq_ == last + 1);
+    }
+  }
+  if (seq_ == 0) seq_ = 1;
+  durable_.store(seq_ - 1);
+  if (!ok) {
+    ::close(fd_);
+    fd_ = -1;
+    return;
+  }
+  ok_.store(true, std::memory_order_release);
+  writer_ = std::thread([this]() { run(); });
+}
+
+Journal::~Journal() { close(); }
+
+std::uint64_t Journal::append(const Command& cmd) {
+  if (!ok()) {
+    // Not open, or failed; the record can never become durable (and,
+    // without a writer, the queue would never drain).
+    ++discards_;
+    return seq_++;
+  }
+  Record r;
+  encode(seq_, cmd, r);
+  if (!q_.try_push(r)) {
+    // Writer has fallen behind by a full queue; backpressure.
+    ++stalls_;
+    q_.push(r);
+  }
+  return seq_++;
+}
+
+bool Journal::sync(std::uint64_t seq) {
+  while (durable() < seq) {
+    if (!ok()) return false;
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+void Journal::close() {
+  if (writer_.joinable()) {
+    stop_.store(true, std::memory_order_release);
+    writer_.join();
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  stats_.stalls = stalls_;
+  stats_.discards = discards_;
+}
+
+void Journal::run() {
+  std::vector<Record> buf(opts_.group_n);
+  std::size_t empty_n = 0;
+  while (true) {
+    // Sample stop prior to draining, such that all records appended before
+    // close() are committed.
+    const bool stop = stop_.load(std::memory_order_acquire);
+
+    std::size_t n = 0;
+    while ((n < buf.size()) && q_.try_pop(buf[n])) ++n;
+
+    if (n != 0) {
+      empty_n = 0;
+      if (ok() && !commit(buf.data(), n)) {
+        // Device error; subsequent records are discarded.
+        ok_.store(false, std::memory_order_release);
+      }
+      continue;
+    }
+    if (stop) break;
+
+    if (++empty_n < opts_.spin_n) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(opts_.idle);
+    }
+  }
+}
+
+bool Journal::commit(const Record* buf, std::size_t n) {
+  const auto start = std::chrono::steady_clock::now();
+  if (!write_all(fd_, buf[0].b, n * RECORD_BYTES)) return false;
+  if (opts_.sync && (::fdatasync(fd_) != 0)) return false;
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count();
+
+  stats_.records += n;
+  ++stats_.commits;
+  stats_.group_max = std::max(stats_.group_max, n);
+  stats_.commit_ns_max =
+      std::max(stats_.commit_ns_max, static_cast<std::uint64_t>(ns));
+  durable_.store(load(buf[n - 1].b, 8), std::memory_order_release);
+  return true;
+}
+
+std::string RecoveryStats::to_string() const {
+  utility::KVListRenderer r;
+  r.add_field("records", std::to_string(records));
+  r.add_field("torn_bytes", std::to_string(torn_bytes));
+  r.add_field("seq", std::to_string(seq));
+  return r.to_string();
+}
+
+bool recover(const std::string& path, Model& model, RecoveryStats& stats) {
+  stats = RecoveryStats{};
+  const int fd = ::open(path.c_str(), O_RDWR);
+  if (fd < 0) return (errno == ENOENT);
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    return false;
+  }
+  const std::size_t bytes = static_cast<std::size_t>(st.st_size);
+  if (bytes < HEADER_BYTES) {
+    // Torn at creation.
+    stats.torn_bytes = bytes;
+    const bool ok = (::ftruncate(fd, 0) == 0);
+    ::close(fd);
+    return ok;
+  }
+  void* p = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (p == MAP_FAILED) {
+    ::close(fd);
+    return false;
+  }
+  const std::byte* b = static_cast<const std::byte*>(p);
+  if (!decode_header(b)) {
+    ::munmap(p, bytes);
+    ::close(fd);
+    return false;
+  }
+  ::madvise(p, bytes, MADV_SEQUENTIAL);
+
+  std::size_t end = HEADER_BYTES;
+  Record r;
+  Command cmd;
+  std::uint64_t seq;
+  while ((bytes - end) >= RECORD_BYTES) {
+    std::memcpy(r.b, b + end, RECORD_BYTES);
+    if (!decode(r, seq, cmd)) break;
+    if ((stats.records != 0) && (seq != stats.seq)) break;
+
+    // As applied by the engine; a matured conditional command is retired
+    // from the conditional table.
+    model.apply(cmd);
+    if (cmd.was_cn) model.delete_uid_from_cn(cmd.uid);
+
+    ++stats.records;
+    stats.seq = seq + 1;
+    end += RECORD_BYTES;
+  }
+  ::munmap(p, bytes);
+
+  bool ok = true;
+  if (end != bytes) {
+    stats.torn_bytes = bytes - end;
+    ok = (::ftruncate(fd, static_cast<off_t>(end)) == 0);
+  }
+  ::close(fd);
+  return ok;
+}
+
+} // namespace tb::journal
@@ -0,0 +1,207 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_JOURNAL_H
+#define M_TB_JOURNAL_H
+
+#include "tb.h"
+#include "spsc.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Write-ahead command journal of the software engine (Model). Each command
+// applied to the engine is assigned a sequence number and appended to the
+// journal; a writer thread drains appended records in groups, issuing one
+// write and one fdatasync per group (group commit), such that the matching
+// thread never waits upon the device. Recovery replays the journal into a
+// Model, reconstructing the book.
+//
+// File layout:
+//
+//   Header (16B) | Record (32B) | Record (32B) | ...
+//
+// Record:
+//
+//   [ 7: 0] Sequence number
+//   [11: 8] Flags (see Flag)
+//   [15:12] Check (FNV-1a of the remaining bytes)
+//   [31:16] Command (wire::Cmd)
+//
+// Fields are little-endian. A record which fails its check, or which is out
+// of sequence, denotes a torn tail (a group partially written at the time of
+// a crash) and terminates recovery.
+//
+namespace tb::journal {
+
+constexpr std::size_t HEADER_BYTES = 16;
+constexpr std::size_t RECORD_BYTES = 32;
+
+// Record flags.
+enum Flag : std::uint32_t {
+  // Command is a matured conditional command (Command::was_cn).
+  WasCn = 0x1
+};
+
+struct Record {
+  std::byte b[RECORD_BYTES];
+};
+
+// Encode command 'cmd' of sequence number 'seq' to record 'r'.
+void encode(std::uint64_t seq, const Command& cmd, Record& r);
+
+// Decode record 'r'; returns false if the record fails its check.
+bool decode(const Record& r, std::uint64_t& seq, Command& cmd);
+
+struct JournalOptions {
+  // Journal file; created if not present, otherwise appended. A journal
+  // with a torn tail (a partially written, or corrupt, final record) is not
+  // opened; it must first be recovered.
+  std::string path = "ob.journal";
+
+  // Sequence number of the first appended record (see RecoveryStats::seq);
+  // zero continues from the last record of the journal (or from one, if
+  // empty). A journal not followed in sequence by 'seq' is not opened.
+  std::uint64_t seq = 0;
+
+  // Capacity of the append queue (records).
+  std::size_t queue_n = (1 << 16);
+
+  // Maximum records per group commit.
+  std::size_t group_n = 4096;
+
+  // Issue fdatasync per group; otherwise, records are durable only once
+  // written back by the OS.
+  bool sync = true;
+
+  // Writer spins for 'spin_n' polls of an empty queue, then sleeps for
+  // 'idle' between polls.
+  std::size_t spin_n = 1024;
+  std::chrono::microseconds idle{20};
+};
+
+struct JournalStats {
+  std::string to_string() const;
+
+  // Mean records per group commit.
+  double group_mean() const {
+    return commits ? static_cast<double>(records) / commits : 0.0;
+  }
+
+  // Records written.
+  std::uint64_t records = 0;
+  // Group commits.
+  std::uint64_t commits = 0;
+  // Largest group.
+  std::size_t group_max = 0;
+  // Appends stalled on a full queue.
+  std::uint64_t stalls = 0;
+  // Appends discarded as the journal is not open, or has failed.
+  std::uint64_t discards = 0;
+  // Longest write+fdatasync (ns).
+  std::uint64_t commit_ns_max = 0;
+};
+
+class Journal {
+ public:
+  explicit Journal(const JournalOptions& opts = JournalOptions{});
+  ~Journal();
+
+  Journal(const Journal&) = delete;
+  Journal& operator=(const Journal&) = delete;
+
+  // Journal opened successfully, and no write has failed.
+  bool ok() const { return ok_.load(std::memory_order_acquire); }
+
+  // Append 'cmd'; returns its sequence number. The record is durable once
+  // durable() reaches the sequence number. Does not block unless the
+  // append queue is full. Should the journal not be ok(), the record is
+  // discarded (and is never durable).
+  std::uint64_t append(const Command& cmd);
+
+  // Sequence number of the most recent durable record (zero if none).
+  std::uint64_t durable() const {
+    return durable_.load(std::memory_order_acquire);
+  }
+
+  // Block until record 'seq' is durable; returns false on write failure.
+  bool sync(std::uint64_t seq);
+
+  // Drain outstanding records and close the journal.
+  void close();
+
+  // Writer statistics (stable once closed).
+  const JournalStats& stats() const { return stats_; }
+
+ private:
+  // Writer thread.
+  void run();
+
+  // Write, and sync, 'n' records of 'buf'.
+  bool commit(const Record* buf, std::size_t n);
+
+  JournalOptions opts_;
+  int fd_ = -1;
+  std::thread writer_;
+
+  // Producer (matching thread) state.
+  std::uint64_t seq_;
+  std::uint64_t stalls_ = 0;
+  std::uint64_t discards_ = 0;
+
+  SpscQueue<Record> q_;
+
+  alignas(64) std::atomic<std::uint64_t> durable_{0};
+  std::atomic<bool> ok_{false};
+  std::atomic<bool> stop_{false};
+
+  JournalStats stats_;
+};
+
+struct RecoveryStats {
+  std::string to_string() const;
+
+  // Records replayed.
+  std::size_t records = 0;
+  // Bytes discarded from a torn tail.
+  std::size_t torn_bytes = 0;
+  // Sequence number of the next record to be appended.
+  std::uint64_t seq = 1;
+};
+
+// Replay journal 'path' into 'model'; a torn tail is truncated, such that
+// the journal may subsequently be appended from 'stats.seq'. Returns false
+// if the journal cannot be opened, or is not a journal. A journal which does
+// not exist is treated as empty.
+bool recover(const std::string& path, Model& model, RecoveryStats& stats);
+
+} // namespace tb::journal
+
+#endif
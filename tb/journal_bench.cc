@@ -0,0 +1,142 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "journal.h"
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Journal benchmark: commands are applied to the software engine (Model)
+// at a fixed offered rate, each appended to the journal before it is
+// applied. Reports the cost of the append to the matching thread, and the
+// latency from append until the record is durable (as observed by the
+// matching thread).
+//
+// Usage: journal_bench [n] [rate] [path] [nosync]
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double percentile(std::vector<double>& v, double p) {
+  if (v.empty()) return 0.0;
+  const std::size_t i = static_cast<std::size_t>(p * (v.size() - 1));
+  std::nth_element(v.begin(), v.begin() + i, v.end());
+  return v[i];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t n = (argc > 1) ? std::stoul(argv[1]) : (1 << 20);
+  const double rate = (argc > 2) ? std::stod(argv[2]) : 1e6;
+  tb::journal::JournalOptions opts;
+  opts.path = (argc > 3) ? argv[3]
+                         : ("ob_journal_bench." + std::to_string(::getpid()));
+  opts.sync = !((argc > 4) && (std::strcmp(argv[4], "nosync") == 0));
+
+  // Stimulus
+  tb::Random::init(1);
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::QryBidAsk, 4);
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::PopTopBid, 3);
+  bg.push_back(tb::Opcode::PopTopAsk, 3);
+  bg.push_back(tb::Opcode::Cancel, 3);
+  bg.push_back(tb::Opcode::BuyMarket, 1);
+  bg.push_back(tb::Opcode::SellMarket, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+  const std::deque<tb::Command> d = gen.generate(n);
+  const std::vector<tb::Command> cmds(d.begin(), d.end());
+
+  ::unlink(opts.path.c_str());
+  tb::Model model(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  tb::journal::Journal journal{opts};
+  if (!journal.ok()) {
+    std::cerr << "Unable to open journal: " << opts.path << "\n";
+    return 1;
+  }
+
+  std::vector<clock_type::time_point> appended;
+  std::vector<double> append_ns, durable_ns;
+  appended.reserve(n);
+  append_ns.reserve(n);
+  durable_ns.reserve(n);
+  std::uint64_t observed = 0;
+  auto observe = [&](clock_type::time_point now) {
+    const std::uint64_t d = journal.durable();
+    for (; observed < d; observed++) {
+      durable_ns.push_back(
+          std::chrono::duration<double, std::nano>(now - appended[observed])
+              .count());
+    }
+  };
+
+  const auto period = std::chrono::duration_cast<clock_type::duration>(
+      std::chrono::duration<double>(1.0 / rate));
+  const auto start = clock_type::now();
+  for (std::size_t i = 0; i < cmds.size(); i++) {
+    // Offered rate.
+    const auto due = start + period * i;
+    while (clock_type::now() < due) {}
+
+    const auto t0 = clock_type::now();
+    journal.append(cmds[i]);
+    const auto t1 = clock_type::now();
+    model.apply(cmds[i]);
+    appended.push_back(t0);
+    append_ns.push_back(
+        std::chrono::duration<double, std::nano>(t1 - t0).count());
+    observe(t1);
+  }
+  while (journal.durable() < cmds.size()) {
+    if (!journal.ok()) break;
+    observe(clock_type::now());
+  }
+  observe(clock_type::now());
+  const double elapsed =
+      std::chrono::duration<double>(clock_type::now() - start).count();
+  journal.close();
+  ::unlink(opts.path.c_str());
+
+  std::cout << "n=" << n << " rate=" << rate
+            << " sync=" << (opts.sync ? "fdatasync" : "none") << "\n"
+            << "throughput: " << (n / elapsed) << " cmd/s\n"
+            << "append (ns): p50=" << percentile(append_ns, 0.50)
+            << " p99=" << percentile(append_ns, 0.99)
+            << " max=" << percentile(append_ns, 1.0) << "\n"
+            << "durable (ns): p50=" << percentile(durable_ns, 0.50)
+            << " p99=" << percentile(durable_ns, 0.99)
+            << " max=" << percentile(durable_ns, 1.0) << "\n"
+            << journal.stats().to_string() << "\n";
+  return journal.ok() ? 0 : 1;
+}
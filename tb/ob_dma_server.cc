@@ -0,0 +1,54 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "dma.h"
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Engine server: owns the Verilated engine and services the command and
+// response rings of shared region 'name' until a client requests stop.
+//
+// Usage: ob_dma_server [name] [poll|irq]
+
+int main(int argc, char** argv) {
+  tb::dma::ServerOptions opts;
+  if (argc > 1) opts.name = argv[1];
+  if (argc > 2) {
+    opts.wait = (std::strcmp(argv[2], "poll") == 0) ? tb::dma::Wait::Poll
+                                                    : tb::dma::Wait::Interrupt;
+  }
+
+  tb::dma::Server server{opts};
+  if (!server.ok()) {
+    std::cerr << "Unable to create shared region: " << opts.name << "\n";
+    return 1;
+  }
+  server.run();
+  std::cout << server.stats().to_string() << "\n";
+  return 0;
+}
@@ -0,0 +1,249 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_RNG_H
+#define M_TB_RNG_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace tb {
+
+// xoshiro256++ pseudo-random generator (Blackman/Vigna); satisfies
+// UniformRandomBitGenerator. Small, fast and self-contained such that each
+// generator (or thread) may own an independent, reproducible stream.
+//
+class Xoshiro256pp {
+ public:
+  using result_type = std::uint64_t;
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  Xoshiro256pp() : Xoshiro256pp(1) {}
+
+  explicit Xoshiro256pp(std::uint64_t seed) { seed_with(seed); }
+
+  // Re-seed; state is expanded from seed using splitmix64.
+  void seed_with(std::uint64_t seed) {
+    for (std::uint64_t& s : s_) {
+      seed += 0x9E3779B97F4A7C15ULL;
+      std::uint64_t z = seed;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      s = z ^ (z >> 31);
+    }
+    has_spare_ = false;
+  }
+
+  result_type operator()() {
+    const std::uint64_t r = rotl(s_[0] + s_[3], 23) + s_[0];
+    const std::uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+    return r;
+  }
+
+  // Advance the state by 2^128 steps; successive jumps from a common seed
+  // yield non-overlapping streams (for example, one per thread).
+  void jump() {
+    static constexpr std::uint64_t JUMP[] = {
+      0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+      0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+    std::uint64_t s[4] = {0, 0, 0, 0};
+    for (std::uint64_t j : JUMP) {
+      for (int b = 0; b < 64; b++) {
+        if (j & (1ULL << b)) {
+          for (int i = 0; i < 4; i++) s[i] ^= s_[i];
+        }
+        (*this)();
+      }
+    }
+    for (int i = 0; i < 4; i++) s_[i] = s[i];
+  }
+
+  // Fill [out, out + n) with raw 64b values.
+  void fill(std::uint64_t* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) out[i] = (*this)();
+  }
+
+  // Uniform integer in range [0, n); Lemire's multiply-shift with
+  // rejection (unbiased, and in the common case free of division).
+  std::uint64_t bounded(std::uint64_t n) {
+    unsigned __int128 m = static_cast<unsigned __int128>((*this)()) * n;
+    std::uint64_t l = static_cast<std::uint64_t>(m);
+    if (l < n) {
+      const std::uint64_t t = (-n) % n;
+      while (l < t) {
+        m = static_cast<unsigned __int128>((*this)()) * n;
+        l = static_cast<std::uint64_t>(m);
+      }
+    }
+    return static_cast<std::uint64_t>(m >> 64);
+  }
+
+  // Uniform integer in range [lo, hi].
+  template<typename T>
+  T uniform(T hi, T lo) {
+    const std::uint64_t range =
+        static_cast<std::uint64_t>(hi) - static_cast<std::uint64_t>(lo);
+    if (range == std::numeric_limits<std::uint64_t>::max()) {
+      return static_cast<T>((*this)());
+    }
+    return static_cast<T>(static_cast<std::uint64_t>(lo) + bounded(range + 1));
+  }
+
+  // Uniform double in range [0, 1).
+  double uniform01() {
+    return ((*this)() >> 11) * 0x1.0p-53;
+  }
+
+  // Boolean with true probability p.
+  bool boolean(double p) { return uniform01() < p; }
+
+  // Normally distributed double (Marsaglia polar method); values are
+  // produced in pairs, the second retained for the subsequent call.
+  double normal(double mean, double stddev) {
+    if (has_spare_) {
+      has_spare_ = false;
+      return mean + stddev * spare_;
+    }
+    double u, v, s;
+    do {
+      u = 2.0 * uniform01() - 1.0;
+      v = 2.0 * uniform01() - 1.0;
+      s = u * u + v * v;
+    } while ((s >= 1.0) || (s == 0.0));
+    const double f = std::sqrt(-2.0 * std::log(s) / s);
+    spare_ = v * f;
+    has_spare_ = true;
+    return mean + stddev * (u * f);
+  }
+
+  // Fill [out, out + n) with normally distributed doubles.
+  void fill_normal(double* out, std::size_t n, double mean, double stddev) {
+    for (std::size_t i = 0; i < n; i++) out[i] = normal(mean, stddev);
+  }
+
+ private:
+  static constexpr std::uint64_t rotl(std::uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  std::uint64_t s_[4];
+
+  // Retained second value of the most recent normal pair.
+  bool has_spare_ = false;
+  double spare_ = 0.0;
+};
+
+// Batch of normally distributed values, refilled on exhaustion; amortizes
+// the generation of (for example) prices across many commands.
+//
+class NormalBatch {
+ public:
+  explicit NormalBatch(double mean = 0.0, double stddev = 1.0,
+                       std::size_t n = 1024)
+      : mean_(mean), stddev_(stddev), vs_(n), i_(n)
+  {}
+
+  double operator()(Xoshiro256pp& rng) {
+    if (i_ == vs_.size()) {
+      rng.fill_normal(vs_.data(), vs_.size(), mean_, stddev_);
+      i_ = 0;
+    }
+    return vs_[i_++];
+  }
+
+ private:
+  double mean_;
+  double stddev_;
+  std::vector<double> vs_;
+  std::size_t i_;
+};
+
+// Walker/Vose alias table; samples an index in proportion to its weight in
+// O(1) (one bounded integer and one uniform double per sample).
+//
+class AliasTable {
+ public:
+  AliasTable() = default;
+
+  // Rebuild from weights; O(n).
+  void build(const std::vector<double>& weights) {
+    const std::size_t n = weights.size();
+    prob_.assign(n, 0.0);
+    alias_.assign(n, 0);
+    if (n == 0) return;
+
+    double sum = 0.0;
+    for (double w : weights) sum += w;
+
+    std::vector<double> p(n);
+    std::vector<std::size_t> small, large;
+    for (std::size_t i = 0; i < n; i++) {
+      p[i] = (sum > 0.0) ? (weights[i] * n / sum) : 1.0;
+      ((p[i] < 1.0) ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+      const std::size_t s = small.back(); small.pop_back();
+      const std::size_t l = large.back(); large.pop_back();
+      prob_[s] = p[s];
+      alias_[s] = l;
+      p[l] = (p[l] + p[s]) - 1.0;
+      ((p[l] < 1.0) ? small : large).push_back(l);
+    }
+    // Residual entries (numerical error) are taken with certainty.
+    for (std::size_t i : large) prob_[i] = 1.0;
+    for (std::size_t i : small) prob_[i] = 1.0;
+  }
+
+  bool empty() const { return prob_.empty(); }
+
+  std::size_t operator()(Xoshiro256pp& rng) const {
+    const std::size_t i = rng.bounded(prob_.size());
+    return (rng.uniform01() < prob_[i]) ? i : alias_[i];
+  }
+
+ private:
+  std::vector<double> prob_;
+  std::vector<std::size_t> alias_;
+};
+
+} // namespace tb
+
+#endif
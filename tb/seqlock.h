@@ -0,0 +1,107 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_SEQLOCK_H
+#define M_TB_SEQLOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace tb {
+
+// Single-writer, multiple-reader sequence lock. The writer never blocks; a
+// reader copies the record and retries should a store have overlapped the
+// copy, as indicated by the sequence (odd whilst a store is in progress).
+// The sequence and record share a cache line, such that an uncontended read
+// touches a single line. The record is held as relaxed atomic words so that
+// a torn copy, although discarded, is never a data race.
+//
+template<typename T>
+class alignas(64) SeqLock {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+ public:
+  SeqLock() = default;
+
+  explicit SeqLock(const T& t) { store(t); }
+
+  // Publish record; single writer only.
+  void store(const T& t) {
+    const std::uint64_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::uint64_t ws[N] = {};
+    std::memcpy(ws, std::addressof(t), sizeof(T));
+    for (std::size_t i = 0; i < N; i++) {
+      ws_[i].store(ws[i], std::memory_order_relaxed);
+    }
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  // Non-blocking read; false if a store was in progress, or overlapped the
+  // copy. On success, 'version' (where provided) is the number of stores
+  // preceding the record.
+  bool try_load(T& t, std::uint64_t* version = nullptr) const {
+    const std::uint64_t seq0 = seq_.load(std::memory_order_acquire);
+    if (seq0 & 1) return false;
+    std::uint64_t ws[N];
+    for (std::size_t i = 0; i < N; i++) {
+      ws[i] = ws_[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq_.load(std::memory_order_relaxed) != seq0) return false;
+    std::memcpy(std::addressof(t), ws, sizeof(T));
+    if (version != nullptr) *version = (seq0 >> 1);
+    return true;
+  }
+
+  // Blocking read; spins until a consistent copy is obtained.
+  T load(std::uint64_t* version = nullptr) const {
+    T t;
+    while (!try_load(t, version)) {}
+    return t;
+  }
+
+  // Number of completed stores; a reader may poll the version to detect a
+  // change without copying the record.
+  std::uint64_t version() const {
+    return (seq_.load(std::memory_order_acquire) >> 1);
+  }
+
+ private:
+  static constexpr std::size_t N = (sizeof(T) + 7) / 8;
+
+  std::atomic<std::uint64_t> seq_{0};
+  std::atomic<std::uint64_t> ws_[N] = {};
+};
+
+} // namespace tb
+
+#endif
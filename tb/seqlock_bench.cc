@@ -0,0 +1,131 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "tb.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Top-of-book publication benchmark: commands are applied to the software
+// engine (Model) as fast as possible, the engine publishing its top-of-book
+// through a seqlock, whilst a number of reader threads continuously poll the
+// publication. Reports the cost to the engine per command, and the cost and
+// retry rate of reads.
+//
+// Usage: seqlock_bench [n] [readers]
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// Reader counters; padded to avoid false sharing between readers.
+struct alignas(64) ReaderStats {
+  std::uint64_t reads = 0;
+  std::uint64_t retries = 0;
+  std::uint64_t changes = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t n = (argc > 1) ? std::stoul(argv[1]) : (1 << 20);
+  const std::size_t readers_n = (argc > 2) ? std::stoul(argv[2]) : 2;
+
+  // Stimulus
+  tb::Random::init(1);
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::QryBidAsk, 4);
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::PopTopBid, 3);
+  bg.push_back(tb::Opcode::PopTopAsk, 3);
+  bg.push_back(tb::Opcode::Cancel, 3);
+  bg.push_back(tb::Opcode::BuyMarket, 1);
+  bg.push_back(tb::Opcode::SellMarket, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+  const std::deque<tb::Command> d = gen.generate(n);
+  const std::vector<tb::Command> cmds(d.begin(), d.end());
+
+  tb::TopOfBook tob;
+  tb::Model model(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  model.publish(&tob);
+
+  std::atomic<bool> done{false};
+  std::vector<ReaderStats> stats(readers_n);
+  std::vector<std::thread> readers;
+  for (std::size_t i = 0; i < readers_n; i++) {
+    readers.emplace_back([&, i]() {
+      ReaderStats& s = stats[i];
+      tb::MarketData md;
+      std::uint64_t version, last = 0;
+      while (!done.load(std::memory_order_relaxed)) {
+        if (!tob.try_load(md, &version)) {
+          ++s.retries;
+          continue;
+        }
+        ++s.reads;
+        if (version != last) ++s.changes;
+        last = version;
+      }
+    });
+  }
+
+  const auto start = clock_type::now();
+  for (const tb::Command& cmd : cmds) {
+    model.apply(cmd);
+  }
+  const double elapsed =
+      std::chrono::duration<double>(clock_type::now() - start).count();
+  done.store(true, std::memory_order_relaxed);
+  for (std::thread& t : readers) t.join();
+
+  // Baseline: the same command sequence without publication.
+  tb::Model baseline(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  const auto base_start = clock_type::now();
+  for (const tb::Command& cmd : cmds) {
+    baseline.apply(cmd);
+  }
+  const double base_elapsed =
+      std::chrono::duration<double>(clock_type::now() - base_start).count();
+
+  std::cout << "n=" << n << " readers=" << readers_n
+            << " publications=" << tob.version() << "\n"
+            << "engine (ns/cmd): published=" << (elapsed * 1e9 / n)
+            << " unpublished=" << (base_elapsed * 1e9 / n) << "\n";
+  for (std::size_t i = 0; i < readers_n; i++) {
+    const ReaderStats& s = stats[i];
+    const std::uint64_t attempts = s.reads + s.retries;
+    std::cout << "reader " << i << ": reads=" << s.reads
+              << " ns/read=" << (attempts ? (elapsed * 1e9 / attempts) : 0.0)
+              << " retry=" << (attempts ? (100.0 * s.retries / attempts) : 0.0)
+              << "% changes=" << s.changes << "\n";
+  }
+  return 0;
+}
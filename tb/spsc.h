@@ -0,0 +1,106 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_SPSC_H
+#define M_TB_SPSC_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace tb {
+
+// Bounded, lock-free, single-producer/single-consumer queue. The producer
+// and consumer indices reside on separate cache lines, and each side caches
+// the index of the other such that the shared lines are only touched when
+// the cached copy indicates full/empty.
+//
+template<typename T>
+class SpscQueue {
+ public:
+  // Capacity is rounded up to a power of two.
+  explicit SpscQueue(std::size_t n = (1 << 16))
+      : ts_(round_up(n)), mask_(ts_.size() - 1)
+  {}
+
+  // Non-blocking push; false if full.
+  bool try_push(const T& t) {
+    const std::size_t wr = wr_.load(std::memory_order_relaxed);
+    if ((wr - rd_cached_) == ts_.size()) {
+      rd_cached_ = rd_.load(std::memory_order_acquire);
+      if ((wr - rd_cached_) == ts_.size()) return false;
+    }
+    ts_[wr & mask_] = t;
+    wr_.store(wr + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Blocking push; yields whilst full.
+  void push(const T& t) {
+    while (!try_push(t)) std::this_thread::yield();
+  }
+
+  // Non-blocking pop; false if empty.
+  bool try_pop(T& t) {
+    const std::size_t rd = rd_.load(std::memory_order_relaxed);
+    if (rd == wr_cached_) {
+      wr_cached_ = wr_.load(std::memory_order_acquire);
+      if (rd == wr_cached_) return false;
+    }
+    t = std::move(ts_[rd & mask_]);
+    rd_.store(rd + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Blocking pop; yields whilst empty.
+  void pop(T& t) {
+    while (!try_pop(t)) std::this_thread::yield();
+  }
+
+ private:
+  static std::size_t round_up(std::size_t n) {
+    std::size_t r = 1;
+    while (r < n) r <<= 1;
+    return r;
+  }
+
+  std::vector<T> ts_;
+  std::size_t mask_;
+
+  // Producer state.
+  alignas(64) std::atomic<std::size_t> wr_{0};
+  std::size_t rd_cached_ = 0;
+
+  // Consumer state.
+  alignas(64) std::atomic<std::size_t> rd_{0};
+  std::size_t wr_cached_ = 0;
+};
+
+} // namespace tb
+
+#endif
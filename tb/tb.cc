@@ -29,6 +29,8 @@
 #include <cerrno>
 #include "vsupport.h"
 #include "utility.h"
+#include "bcd.h"
+#include "spsc.h"
 #include "vobj/Vtb_ob.h"
 #ifdef OPT_VCD_ENABLE
 #  include "verilated_vcd_c.h"
@@ -38,49 +40,53 @@
 #  include <iostream>
 #endif
 #include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <thread>
 
 //#define UID_AS_HEX
 
 namespace tb {
 
+namespace {
+
+// Event observed on the UUT interfaces, forwarded to the checker.
+struct CheckEvent {
+  enum Kind { Issue, Rsp, Trade, Md, Checkpoint, Done };
+
+  Kind kind = Done;
+
+  // Cycle at which the event was observed.
+  vluint64_t cycle = 0;
+
+  // Issued command (Issue)
+  Command cmd;
+
+  // Received response (Rsp) or trade (Trade)
+  Response rsp;
+
+  // Accepted market data record (Md)
+  MarketData md;
+
+  // Issued command was forwarded through the ingress queue bypass (Issue)
+  bool bypassed = false;
+};
+
+} // namespace
+
 void Random::init(unsigned seed) {
 #ifdef OPT_LOGGING_ENABLE
   std::cout << "[RND] seed set to " << seed << "\n";
 #endif
-  mt_ = std::mt19937{seed};
+  rng_.seed_with(seed);
 }
 
 bool Random::boolean(double true_prob) {
-  std::bernoulli_distribution d(true_prob);
-  return d(mt_);
-}
-
-std::string to_bcd_string(double d) {
-  static char c[128];
-  snprintf(c, 128, "%.2f", d);
-  return std::string(c);
+  return rng_.boolean(true_prob);
 }
 
 Bcd Bcd::from_string(const std::string& s) {
-  Bcd b;
-
-  std::string::size_type i = s.find('.');
-
-  std::string dollar{s.substr(0, i)};
-  for (std::string::size_type i = 0; !dollar.empty(); i++) {
-    const char c = dollar.back();
-    b.dollars[i] = c - '0';
-    dollar.pop_back();
-  }
-
-  std::string cents{s.substr(i + 1)};
-  std::reverse(cents.begin(), cents.end());
-  for (std::size_t i = 0; i < cents.size(); i++) {
-    b.cents[i] = cents[i] - '0';
-  }
-
-  return b;
+  return from_packed(bcd::from_ascii(s.data(), s.size()));
 }
 
 Bcd Bcd::from_packed(vluint32_t p) {
@@ -109,25 +115,13 @@ Bcd::Bcd() {
     dollars [i] = 0x0;
   }
   for (std::size_t i = 0; i < 2; i++) {
-    dollars [i] = 0x0;
+    cents [i] = 0x0;
   }
 }
 
 std::string Bcd::to_string() const {
-  std::string s;
-  if (dollars[2] != 0) {
-    s += ('0' + dollars[2]);
-  }
-  if (!s.empty() || (dollars[1] != 0)) {
-    s += ('0' + dollars[1]);
-  }
-  if (!s.empty() || (dollars[0] != 0)) {
-    s += ('0' + dollars[0]);
-  }
-  s += '.';
-  s += ('0' + cents[1]);
-  s += ('0' + cents[0]);
-  return s;
+  char s[bcd::ASCII_MAX_N];
+  return std::string(s, bcd::to_ascii(pack(), s));
 }
 
 bool Bcd::is_valid() const {
@@ -203,6 +197,104 @@ const char* to_opcode_string(vluint8_t opcode) {
     case Opcode::SellStopLoss: return "SellStopLoss";
     case Opcode::BuyStopLimit: return "BuyStopLimit";
     case Opcode::SellStopLimit: return "SellStopLimit";
+    case Opcode::QryDepthBid: return "QryDepthBid";
+    case Opcode::QryDepthAsk: return "QryDepthAsk";
+    case Opcode::MassCancel: return "MassCancel";
+    case Opcode::Replace: return "Replace";
+    case Opcode::QryStats: return "QryStats";
+    case Opcode::QrySnapshot: return "QrySnapshot";
+    case Opcode::LoadBid: return "LoadBid";
+    case Opcode::LoadAsk: return "LoadAsk";
+    default: return "Invalid";
+  }
+}
+
+namespace stats {
+
+const char* to_string(vluint16_t id) {
+  if (id < Trade) return to_opcode_string(id - Cmd);
+  if (id >= Fsm) return "Fsm";
+  switch (id) {
+    case Trade: return "Trade";
+    case RejectLmBid: return "RejectLmBid";
+    case RejectLmAsk: return "RejectLmAsk";
+    case RejectMkBid: return "RejectMkBid";
+    case RejectMkAsk: return "RejectMkAsk";
+    case RejectCnBuy: return "RejectCnBuy";
+    case RejectCnSell: return "RejectCnSell";
+    case CancelHit: return "CancelHit";
+    case CancelMiss: return "CancelMiss";
+    case CnMtr: return "CnMtr";
+    case EgressStall: return "EgressStall";
+    default: return "Invalid";
+  }
+}
+
+} // namespace stats
+
+namespace snapshot {
+
+const char* to_string(vluint8_t table) {
+  switch (table) {
+    case LmBid: return "LmBid";
+    case LmAsk: return "LmAsk";
+    case MkBid: return "MkBid";
+    case MkAsk: return "MkAsk";
+    case CnBuy: return "CnBuy";
+    case CnSell: return "CnSell";
+    default: return "Invalid";
+  }
+}
+
+bool to_commands(const std::vector<Response>& rsps,
+                 std::vector<Command>& cmds) {
+  cmds.clear();
+  // Conditional entries span two responses; the second (ext) completes the
+  // command opened by the first.
+  bool open = false;
+  for (const Response& rsp : rsps) {
+    const auto& e = rsp.result.snapshot;
+    if (e.last) return !open;
+
+    if (e.ext) {
+      if (!open || (cmds.back().uid != e.uid)) return false;
+      Command& cmd = cmds.back();
+      cmd.opcode = (e.quantity & 0x1F);
+      cmd.tif = ((e.quantity >> 5) & 0x7);
+      cmd.price1 = e.price;
+      open = false;
+      continue;
+    }
+    if (open) return false;
+
+    Command cmd;
+    cmd.valid = true;
+    cmd.uid = e.uid;
+    cmd.quantity = e.quantity;
+    cmd.price = e.price;
+    switch (e.table) {
+      case LmBid: cmd.opcode = Opcode::LoadBid; break;
+      case LmAsk: cmd.opcode = Opcode::LoadAsk; break;
+      case MkBid: cmd.opcode = Opcode::BuyMarket; break;
+      case MkAsk: cmd.opcode = Opcode::SellMarket; break;
+      case CnBuy:
+      case CnSell: open = true; break;
+      default: return false;
+    }
+    cmds.push_back(cmd);
+  }
+  // Stream is incomplete.
+  return false;
+}
+
+} // namespace snapshot
+
+const char* to_tif_string(vluint8_t tif) {
+  switch (tif) {
+    case Tif::GoodUntilCancelled: return "GUC";
+    case Tif::ImmediateOrCancel: return "IOC";
+    case Tif::FillOrKill: return "FOK";
+    case Tif::AllOrNone: return "AON";
     default: return "Invalid";
   }
 }
@@ -240,6 +332,9 @@ std::string Command::to_string() const {
   r.add_field("uid", to_string(uid));
 #endif
   r.add_field("opcode", to_opcode_string(opcode));
+  if (tif != Tif::GoodUntilCancelled) {
+    r.add_field("tif", to_tif_string(tif));
+  }
   switch (opcode) {
     case Opcode::BuyMarket: {
       r.add_field("quantity", to_string(quantity));
@@ -257,9 +352,37 @@ std::string Command::to_string() const {
       const Bcd bcd = Bcd::from_packed(price);
       r.add_field("price", bcd.to_string());
     } break;
+    case Opcode::LoadBid:
+    case Opcode::LoadAsk: {
+      r.add_field("quantity", to_string(quantity));
+      r.add_field("price", Bcd::from_packed(price).to_string());
+    } break;
     case Opcode::Cancel: {
       r.add_field("cancelled uid", to_string(uid1));
     } break;
+    case Opcode::Replace: {
+      r.add_field("amended uid", to_string(uid1));
+      r.add_field("quantity", to_string(quantity));
+      const Bcd bcd = Bcd::from_packed(price);
+      r.add_field("price", bcd.to_string());
+    } break;
+    case Opcode::MassCancel: {
+      std::string side;
+      if (quantity & mass_cancel::Bid) side += "Bid";
+      if (quantity & mass_cancel::Ask) side += "Ask";
+      r.add_field("side", side);
+      switch (quantity & (0x3 << 2)) {
+        case mass_cancel::Ge: {
+          r.add_field("price >=", Bcd::from_packed(price).to_string());
+        } break;
+        case mass_cancel::Le: {
+          r.add_field("price <=", Bcd::from_packed(price).to_string());
+        } break;
+        default: {
+          r.add_field("range", "All");
+        } break;
+      }
+    } break;
     case Opcode::QryTblAskLe:
     case Opcode::QryTblBidGe: {
       r.add_field("price", Bcd::from_packed(price).to_string());
@@ -284,6 +407,7 @@ const char* to_status_string(vluint8_t status) {
     case Status::CancelMiss: return "CancelMiss";
     case Status::Bad: return "Bad";
     case Status::BadPop: return "BadPop";
+    case Status::Killed: return "Killed";
     default: return "Invalid";
   }
 }
@@ -335,8 +459,54 @@ std::string Response::to_string(vluint8_t opcode) const {
       case Opcode::QryTblBidGe: {
         r.add_field("accum", to_string(result.qry.accum));
       } break;
+      case Opcode::MassCancel: {
+        if (status == Status::CancelHit) {
+          const Bcd price = Bcd::from_packed(result.poptop.price);
+          r.add_field("price", price.to_string());
+          r.add_field("quantity", to_string(result.poptop.quantity));
+          r.add_field("cancelled uid", to_string(result.poptop.uid));
+        } else {
+          r.add_field("cancelled", to_string(result.qry.accum));
+        }
+      } break;
+      case Opcode::QryDepthBid:
+      case Opcode::QryDepthAsk: {
+        if (status != Status::Bad) {
+          r.add_field("level", to_string(result.depth.level));
+          const Bcd price = Bcd::from_packed(result.depth.price);
+          r.add_field("price", price.to_string());
+          r.add_field("accum", to_string(result.depth.accum));
+          r.add_field("last", result.depth.last ? "1" : "0");
+        }
+      } break;
+      case Opcode::QryStats: {
+        r.add_field("id", to_string(result.stats.id));
+        r.add_field("counter", stats::to_string(result.stats.id));
+        r.add_field("value", to_string(result.stats.value));
+        r.add_field("last", result.stats.last ? "1" : "0");
+      } break;
+      case Opcode::QrySnapshot: {
+        if (!result.snapshot.last) {
+          r.add_field("table", snapshot::to_string(result.snapshot.table));
+          if (result.snapshot.ext) {
+            r.add_field("price1",
+                        Bcd::from_packed(result.snapshot.price).to_string());
+            r.add_field("opcode", to_opcode_string(
+                result.snapshot.quantity & 0x1F));
+          } else {
+            r.add_field("price",
+                        Bcd::from_packed(result.snapshot.price).to_string());
+            r.add_field("quantity", to_string(result.snapshot.quantity));
+          }
+          r.add_field("entry uid", to_string(result.snapshot.uid));
+        }
+        r.add_field("last", result.snapshot.last ? "1" : "0");
+      } break;
     }
   }
+  if (ts_emit != 0) {
+    r.add_field("latency", to_string(latency()));
+  }
   return r.to_string();
 }
 
@@ -351,12 +521,84 @@ bool operator==(const Response& lhs, const Response& rhs) {
   return true;
 }
 
+std::string MarketData::to_string() const {
+  utility::KVListRenderer r;
+  if (bid_vld) {
+    r.add_field("bid", Bcd::from_packed(bid_price).to_string());
+    r.add_field("bid_quantity", std::to_string(bid_quantity));
+  }
+  if (ask_vld) {
+    r.add_field("ask", Bcd::from_packed(ask_price).to_string());
+    r.add_field("ask_quantity", std::to_string(ask_quantity));
+  }
+  return r.to_string();
+}
+
+std::string LatencyStats::to_string() const {
+  utility::KVListRenderer r;
+  r.add_field("n", std::to_string(n));
+  if (n != 0) {
+    r.add_field("min", std::to_string(min));
+    r.add_field("max", std::to_string(max));
+    r.add_field("mean", std::to_string(mean()));
+    r.add_field("bypassed", std::to_string(bypassed));
+    r.add_field("bypassed_mean", std::to_string(bypassed_mean()));
+    r.add_field("queued_mean", std::to_string(queued_mean()));
+    r.add_field("saved_per_cmd",
+                std::to_string(static_cast<double>(bypassed) / n));
+  }
+  return r.to_string();
+}
+
+std::string ThroughputStats::to_string() const {
+  utility::KVListRenderer r;
+  r.add_field("cycles", std::to_string(cycles));
+  r.add_field("cmd_n", std::to_string(cmd_n));
+  r.add_field("trade_n", std::to_string(trade_n));
+  r.add_field("reject_n", std::to_string(reject_n));
+  r.add_field("cycles_per_cmd", std::to_string(cycles_per_cmd()));
+  r.add_field("trades_per_cycle", std::to_string(trades_per_cycle()));
+  r.add_field("reject_rate", std::to_string(reject_rate()));
+  return r.to_string();
+}
+
+std::string DigestStats::to_string() const {
+  utility::KVListRenderer r;
+  r.add_field("checkpoint_n", std::to_string(checkpoint_n));
+  r.add_field("mismatch_n", std::to_string(mismatch_n));
+  r.add_field("replay_n", std::to_string(replay_n));
+  return r.to_string();
+}
+
+void LatencyStats::add(vluint64_t cycles, bool byp) {
+  ++n;
+  min = std::min(min, cycles);
+  max = std::max(max, cycles);
+  sum += cycles;
+  if (byp) {
+    ++bypassed;
+    bypassed_sum += cycles;
+  }
+}
+
+bool operator==(const MarketData& lhs, const MarketData& rhs) {
+  if (lhs.bid_vld != rhs.bid_vld) return false;
+  if (lhs.bid_price != rhs.bid_price) return false;
+  if (lhs.bid_quantity != rhs.bid_quantity) return false;
+  if (lhs.ask_vld != rhs.ask_vld) return false;
+  if (lhs.ask_price != rhs.ask_price) return false;
+  if (lhs.ask_quantity != rhs.ask_quantity) return false;
+
+  return true;
+}
+
 bool compare(const Command& cmd, const Response& actual,
              const Response& expected) {
   EXPECT_EQ(actual.uid, expected.uid);
   EXPECT_EQ(actual.status, expected.status) <<
       " Expected: " << to_status_string(expected.status) <<
-      " Actual: " << to_status_string(actual.status);
+      " Actual: " << to_status_string(actual.status) <<
+      " Uid: " << actual.uid;
   if (actual.uid == 0xFFFFFFFF) {
     // Trade
     EXPECT_EQ(actual.result.trade.bid_uid, expected.result.trade.bid_uid);
@@ -374,21 +616,141 @@ bool compare(const Command& cmd, const Response& actual,
       case Opcode::QryTblBidGe: {
         EXPECT_EQ(actual.result.qry.accum, expected.result.qry.accum);
       } break;
+      case Opcode::QryDepthBid:
+      case Opcode::QryDepthAsk: {
+        if (expected.status != Status::Bad) {
+          EXPECT_EQ(actual.result.depth.last, expected.result.depth.last);
+          EXPECT_EQ(actual.result.depth.level, expected.result.depth.level);
+          EXPECT_EQ(actual.result.depth.price, expected.result.depth.price);
+          EXPECT_EQ(actual.result.depth.accum, expected.result.depth.accum);
+        }
+      } break;
+      case Opcode::MassCancel: {
+        if (expected.status == Status::CancelHit) {
+          EXPECT_EQ(actual.result.poptop.uid, expected.result.poptop.uid);
+          EXPECT_EQ(actual.result.poptop.price, expected.result.poptop.price);
+          EXPECT_EQ(actual.result.poptop.quantity,
+                    expected.result.poptop.quantity);
+        } else {
+          EXPECT_EQ(actual.result.qry.accum, expected.result.qry.accum);
+        }
+      } break;
+      case Opcode::QryStats: {
+        EXPECT_EQ(actual.result.stats.last, expected.result.stats.last);
+        EXPECT_EQ(actual.result.stats.id, expected.result.stats.id);
+        if (stats::is_exact(expected.result.stats.id)) {
+          // Timing dependent counters are not predicted.
+          EXPECT_EQ(actual.result.stats.value, expected.result.stats.value)
+              << " Counter: " << stats::to_string(expected.result.stats.id);
+        }
+      } break;
+      case Opcode::QrySnapshot: {
+        const auto& a = actual.result.snapshot;
+        const auto& e = expected.result.snapshot;
+        EXPECT_EQ(a.last, e.last);
+        if (!e.last) {
+          EXPECT_EQ(a.table, e.table) <<
+              " Expected: " << snapshot::to_string(e.table) <<
+              " Actual: " << snapshot::to_string(a.table);
+          EXPECT_EQ(a.ext, e.ext);
+          EXPECT_EQ(a.price, e.price);
+          EXPECT_EQ(a.quantity, e.quantity);
+          EXPECT_EQ(a.uid, e.uid);
+        }
+      } break;
     }
   }
 
   return (actual == expected);
 }
 
+void Digest::add(const Command& cmd, const Response& rsp) {
+  ++n_;
+  mix(rsp.uid);
+  mix(rsp.status);
+  if (rsp.uid == 0xFFFFFFFF) {
+    // Trade
+    mix(rsp.result.trade.bid_uid);
+    mix(rsp.result.trade.ask_uid);
+    mix(rsp.result.trade.quantity);
+    return;
+  }
+  switch (cmd.opcode) {
+    case Opcode::QryTblAskLe:
+    case Opcode::QryTblBidGe: {
+      mix(rsp.result.qry.accum);
+    } break;
+    case Opcode::QryDepthBid:
+    case Opcode::QryDepthAsk: {
+      if (rsp.status != Status::Bad) {
+        mix(rsp.result.depth.last);
+        mix(rsp.result.depth.level);
+        mix(rsp.result.depth.price);
+        mix(rsp.result.depth.accum);
+      }
+    } break;
+    case Opcode::MassCancel: {
+      if (rsp.status == Status::CancelHit) {
+        mix(rsp.result.poptop.uid);
+        mix(rsp.result.poptop.price);
+        mix(rsp.result.poptop.quantity);
+      } else {
+        mix(rsp.result.qry.accum);
+      }
+    } break;
+    case Opcode::QryStats: {
+      mix(rsp.result.stats.last);
+      mix(rsp.result.stats.id);
+      // Timing dependent counters are not predicted.
+      if (stats::is_exact(rsp.result.stats.id)) mix(rsp.result.stats.value);
+    } break;
+    case Opcode::QrySnapshot: {
+      const auto& r = rsp.result.snapshot;
+      mix(r.last);
+      if (!r.last) {
+        mix(r.table);
+        mix(r.ext);
+        mix(r.price);
+        mix(r.quantity);
+        mix(r.uid);
+      }
+    } break;
+    default: break;
+  }
+}
+
+void Digest::mix(vluint64_t v) {
+  // FNV-1a over 64b words; each word is first avalanched (MurmurHash3
+  // finalizer) such that a difference in any bit perturbs the digest.
+  v ^= v >> 33;
+  v *= 0xFF51AFD7ED558CCDULL;
+  v ^= v >> 33;
+  v *= 0xC4CEB9FE1A85EC53ULL;
+  v ^= v >> 33;
+  h_ = (h_ ^ v) * 0x100000001B3ULL;
+}
+
 vluint64_t VSignals::cycle() const {
   return vsupport::get(tb_cycle);
 }
 
+vluint64_t VSignals::ingress_byp_n() const {
+  return vsupport::get(tb_ingress_byp_n);
+}
+
 //
 void VSignals::set_rsp_accept(bool b) {
   vsupport::set(rsp_accept, b);
 }
 
+void VSignals::set_trd_accept(bool b) {
+  vsupport::set(trd_accept, b);
+}
+
+void VSignals::set_md_accept(bool b) {
+  vsupport::set(md_accept, b);
+}
+
 void VSignals::set_clk(bool b) {
   vsupport::set(clk, b);
 }
@@ -401,6 +763,7 @@ void VSignals::set_rst(bool b) {
 void VSignals::set(const Command& cmd) {
   vsupport::set(cmd_vld_r, cmd.valid);
   vsupport::set(cmd_opcode_r, cmd.opcode);
+  vsupport::set(cmd_tif_r, cmd.tif);
   vsupport::set(cmd_uid_r, cmd.uid);
   switch (cmd.opcode) {
     case Opcode::Nop: {
@@ -417,9 +780,19 @@ void VSignals::set(const Command& cmd) {
       vsupport::set(cmd_quantity_r, cmd.quantity);
       vsupport::set(cmd_price_r, cmd.price);
     } break;
+    case Opcode::LoadBid:
+    case Opcode::LoadAsk: {
+      vsupport::set(cmd_quantity_r, cmd.quantity);
+      vsupport::set(cmd_price_r, cmd.price);
+    } break;
     case Opcode::Cancel: {
       vsupport::set(cmd_uid1_r, cmd.uid1);
     } break;
+    case Opcode::Replace: {
+      vsupport::set(cmd_uid1_r, cmd.uid1);
+      vsupport::set(cmd_quantity_r, cmd.quantity);
+      vsupport::set(cmd_price_r, cmd.price);
+    } break;
     case Opcode::QryTblAskLe:
     case Opcode::QryTblBidGe: {
       vsupport::set(cmd_quantity_r, cmd.quantity);
@@ -433,6 +806,17 @@ void VSignals::set(const Command& cmd) {
       vsupport::set(cmd_price_r, cmd.price);
       vsupport::set(cmd_price1_r, cmd.price1);
     } break;
+    case Opcode::QryDepthBid:
+    case Opcode::QryDepthAsk: {
+      vsupport::set(cmd_quantity_r, cmd.quantity);
+    } break;
+    case Opcode::MassCancel: {
+      vsupport::set(cmd_quantity_r, cmd.quantity);
+      vsupport::set(cmd_price_r, cmd.price);
+    } break;
+    case Opcode::QryStats:
+    case Opcode::QrySnapshot: {
+    } break;
     default: {
       // Unknown opcode.
     } break;
@@ -461,19 +845,57 @@ void VSignals::get(TbSupport& tb) const {
 }
 
 //
-void VSignals::get(Response& rsp) const {
-  rsp.valid = vsupport::get_as_bool(rsp_vld);
-  rsp.uid = vsupport::get(rsp_uid);
-  rsp.status = vsupport::get(rsp_status);
-  rsp.result.trade.bid_uid = vsupport::get(rsp_trade_bid_uid);
-  rsp.result.trade.ask_uid = vsupport::get(rsp_trade_ask_uid);
-  rsp.result.trade.quantity = vsupport::get(rsp_trade_quantity);
-  rsp.result.qrybidask.bid = vsupport::get(rsp_qry_bid);
-  rsp.result.qrybidask.ask = vsupport::get(rsp_qry_ask);
-  rsp.result.poptop.price = vsupport::get(rsp_pop_price);
-  rsp.result.poptop.quantity = vsupport::get(rsp_pop_quantity);
-  rsp.result.poptop.uid = vsupport::get(rsp_pop_uid);
-  rsp.result.qry.accum = vsupport::get(rsp_qry_accum);
+void VSignals::get(Response& rsp, std::size_t lane) const {
+  rsp.valid = ((vsupport::get(rsp_vld) >> lane) & 1) != 0;
+  rsp.uid = rsp_uid[lane];
+  rsp.status = static_cast<vluint8_t>(rsp_status[lane]);
+  rsp.ts_accept = rsp_ts_accept[lane];
+  rsp.ts_emit = rsp_ts_emit[lane];
+  // Trades are presented on the trade interface.
+  rsp.result.trade = {};
+  rsp.result.qrybidask.bid = rsp_qry_bid[lane];
+  rsp.result.qrybidask.ask = rsp_qry_ask[lane];
+  rsp.result.poptop.price = rsp_pop_price[lane];
+  rsp.result.poptop.quantity = static_cast<vluint16_t>(rsp_pop_quantity[lane]);
+  rsp.result.poptop.uid = rsp_pop_uid[lane];
+  rsp.result.qry.accum = rsp_qry_accum[lane];
+  rsp.result.depth.last = (rsp_depth_last[lane] != 0);
+  rsp.result.depth.level = static_cast<vluint16_t>(rsp_depth_level[lane]);
+  rsp.result.depth.price = rsp_depth_price[lane];
+  rsp.result.depth.accum = rsp_depth_accum[lane];
+  rsp.result.stats.last = (rsp_stats_last[lane] != 0);
+  rsp.result.stats.id = static_cast<vluint16_t>(rsp_stats_id[lane]);
+  rsp.result.stats.value = rsp_stats_value[lane];
+  rsp.result.snapshot.last = (rsp_snap_last[lane] != 0);
+  rsp.result.snapshot.table = static_cast<vluint8_t>(rsp_snap_tbl[lane]);
+  rsp.result.snapshot.ext = (rsp_snap_ext[lane] != 0);
+  rsp.result.snapshot.price = rsp_snap_price[lane];
+  rsp.result.snapshot.quantity =
+      static_cast<vluint16_t>(rsp_snap_quantity[lane]);
+  rsp.result.snapshot.uid = rsp_snap_uid[lane];
+}
+
+//
+void VSignals::get_trade(Response& rsp, std::size_t lane) const {
+  rsp.valid = ((vsupport::get(trd_vld) >> lane) & 1) != 0;
+  rsp.uid = trd_uid[lane];
+  rsp.status = static_cast<vluint8_t>(trd_status[lane]);
+  rsp.ts_accept = trd_ts_accept[lane];
+  rsp.ts_emit = trd_ts_emit[lane];
+  rsp.result = {};
+  rsp.result.trade.bid_uid = trd_bid_uid[lane];
+  rsp.result.trade.ask_uid = trd_ask_uid[lane];
+  rsp.result.trade.quantity = static_cast<vluint16_t>(trd_quantity[lane]);
+}
+
+void VSignals::get(MarketData& md) const {
+  md.valid = vsupport::get_as_bool(md_vld_r);
+  md.bid_vld = vsupport::get_as_bool(md_bid_vld);
+  md.bid_price = vsupport::get(md_bid_price);
+  md.bid_quantity = vsupport::get(md_bid_quantity);
+  md.ask_vld = vsupport::get_as_bool(md_ask_vld);
+  md.ask_price = vsupport::get(md_ask_price);
+  md.ask_quantity = vsupport::get(md_ask_quantity);
 }
 
 TB::TB(const Options& opts) : opts_(opts) {
@@ -519,159 +941,567 @@ void TB::run() {
   Command cmd;
   vs_.set(cmd);
 
-  // Response accept
+  // Response/Trade accept
   vs_.set_rsp_accept(true);
+  vs_.set_trd_accept(true);
+
+  // Market data accept
+  vs_.set_md_accept(true);
 
   std::map<vluint32_t, Command> uid_to_cmd;
   std::deque<std::pair<Command, Response> > rsps;
 
+  // Trades are emitted on a channel distinct from acknowledgements, and
+  // therefore may be received before or after the acknowledgement of the
+  // command from which they are predicted. Predicted and received trades
+  // are queued independently and compared in order as both become available.
+  std::deque<std::pair<Command, Response> > trds;
+  std::deque<Response> trds_actual;
+
+  // Cycle at which each outstanding command was issued, and whether it was
+  // forwarded through the ingress queue bypass.
+  std::map<vluint32_t, std::pair<vluint64_t, bool> > uid_to_issue_cycle;
+  latency_ = LatencyStats{};
+  throughput_ = ThroughputStats{};
+  // Cycle at which the first command was issued, and the most recent
+  // response was received.
+  vluint64_t first_issue_cycle = 0;
+  vluint64_t last_rsp_cycle = 0;
+  cn_issue_n_ = 0;
+  cn_reject_n_ = 0;
+
   // Prediction model
   Model model(BID_TABLE_DEPTH_N, ASK_TABLE_DEPTH_N);
 
-  bool stopped = false;
-  while (!stopped) {
-    // Issue command:
-    cmd.valid = false;
-    if (!vs_.get_cmd_full_r() && !cmds_.empty()) {
-      // Apply input command.
-      cmd = cmds_.front();
-      uid_to_cmd.insert(std::make_pair(cmd.uid, cmd));
+  // Digest checking: received and predicted digests of the response and
+  // trade channels, and the number of predicted (non-trade) tail responses
+  // yet to be received, of command 'tail_cmd'.
+  const bool digest = (opts_.digest_window != 0);
+  digest_ = DigestStats{};
+  Digest ack_actual, ack_expected, trd_actual, trd_expected;
+  std::size_t tails = 0;
+  Command tail_cmd;
+  // State of the preceding checkpoint, as a restore sequence, and the
+  // commands issued since (the window).
+  std::vector<Command> restore, window;
+  std::atomic<bool> digest_failed{false};
+
+  // Cycle at which the event currently being checked was observed.
+  vluint64_t check_cycle = 0;
+
+  // Record a command issued to the UUT.
+  auto issue = [&](const Command& cmd, bool bypassed) {
+    if (throughput_.cmd_n++ == 0) first_issue_cycle = check_cycle;
+    if (digest && !digest_failed) window.push_back(cmd);
+    uid_to_cmd.insert(std::make_pair(cmd.uid, cmd));
+    uid_to_issue_cycle.insert(
+        std::make_pair(cmd.uid, std::make_pair(check_cycle, bypassed)));
+  };
+
+  // Timing dependent performance counters are not predicted by the model,
+  // but are bounded by the number of cycles elapsed.
+  vluint64_t stats_fsm_n = 0;
+  counters_.fill(0);
+  auto check_stats = [&](const Response& actual) {
+    const vluint16_t id = actual.result.stats.id;
+    if (id < stats::N) counters_[id] = actual.result.stats.value;
+    if (id == stats::EgressStall) {
+      EXPECT_LE(actual.result.stats.value, check_cycle);
+    } else if (id >= stats::Fsm) {
+      if (id == stats::Fsm) stats_fsm_n = 0;
+      stats_fsm_n += actual.result.stats.value;
+      // The controller is resident in exactly one state per cycle.
+      if (actual.result.stats.last) {
+        EXPECT_GT(stats_fsm_n, 0);
+        EXPECT_LE(stats_fsm_n, check_cycle);
+      }
+    }
+  };
+
+  // Timestamps are not predicted by the model, but are monotonic: a response
+  // is emitted no earlier than the acceptance of its command, and emission
+  // times are non-decreasing within each channel. Comparisons are modulo the
+  // timestamp width.
+  vluint32_t ack_ts_emit = 0;
+  vluint32_t trd_ts_emit = 0;
+  auto check_ts = [&](const Response& actual, vluint32_t& last_ts_emit) {
+    if (!RSP_TIMESTAMP_EN) {
+      EXPECT_EQ(actual.ts_accept, 0u);
+      EXPECT_EQ(actual.ts_emit, 0u);
+      return;
+    }
+    EXPECT_GE(static_cast<vlsint32_t>(actual.latency()), 0)
+        << " Response emitted before command accepted: "
+        << actual.to_string(0);
+    EXPECT_GE(static_cast<vlsint32_t>(actual.ts_emit - last_ts_emit), 0)
+        << " Response emission time is non-monotonic: "
+        << actual.to_string(0);
+    last_ts_emit = actual.ts_emit;
+  };
+
+  // Top-of-book predicted after each command applied to the model
+  // (consecutive duplicates elided), and accepted market data records yet to
+  // be matched. Records are published only at committed states of the book,
+  // therefore each must be drawn, in order, from the predicted sequence;
+  // the feed is conflated, therefore states may be skipped. A record may be
+  // accepted before the response of the command by which it was published,
+  // and is retained until the model has caught up.
+  std::deque<MarketData> tobs{model.top_of_book()};
+  std::deque<MarketData> mds;
+  auto drain_md = [&]() {
+    while (!mds.empty()) {
+      auto it = std::find(tobs.begin(), tobs.end(), mds.front());
+      if (it == tobs.end()) break;
+      // Retain the matched state; it may be published once more.
+      tobs.erase(tobs.begin(), it);
+      mds.pop_front();
+    }
+  };
+
+  // Process a market data record accepted from the UUT.
+  auto process_md = [&](const MarketData& actual) {
+    mds.push_back(actual);
+    drain_md();
+  };
+
+  // Compare predicted against received trades.
+  auto drain_trades = [&]() {
+    while (!trds.empty() && !trds_actual.empty()) {
+      const std::pair<Command, Response>& cr = trds.front();
+      const Response& actual = trds_actual.front();
 #ifdef OPT_TRACE_ENABLE
       if (opts_.trace_enable) {
-        std::cout << "[TB] " << vs_.cycle()
-                  << ": Issue command: " << cmd.to_string() << "\n";
+        std::cout << "[TB] " << check_cycle << ": Trade emitted: "
+                  << actual.to_string(cr.first.opcode) << "\n";
       }
 #endif
-      cmds_.pop_front();
+      compare(cr.first, actual, cr.second);
+      trds.pop_front();
+      trds_actual.pop_front();
     }
-    // Issue command to RTL
-    vs_.set(cmd);
-
-
-    // Process Response:
-    //
-    Response actual;
-    vs_.get(actual);
-    if (actual.valid) {
-      bool resolved_uid = false;
-      if (actual.is_trade()) {
-        // A trade has been received.
-        EXPECT_FALSE(rsps.empty());
-        const std::pair<Command, Response>& cr = rsps.front();
+  };
+
+  // Process a trade received from the UUT.
+  auto process_trade = [&](const Response& actual) {
+    last_rsp_cycle = check_cycle;
+    ++throughput_.trade_n;
+    EXPECT_TRUE(actual.is_trade());
+    check_ts(actual, trd_ts_emit);
+    if (digest) {
+      trd_actual.add(Command{}, actual);
+      return;
+    }
+    trds_actual.push_back(actual);
+    drain_trades();
+  };
+
+  // The snapshot stream most recently received is retained; a stream is
+  // superseded by the first entry of the next.
+  snapshot_.clear();
+  bool snapshot_last = false;
+  auto capture_snapshot = [&](const Response& actual) {
+    if (snapshot_last) snapshot_.clear();
+    snapshot_.push_back(actual);
+    snapshot_last = actual.result.snapshot.last;
+  };
+
+  // Process a response received from the UUT.
+  auto process = [&](const Response& actual) {
+    last_rsp_cycle = check_cycle;
+    EXPECT_FALSE(actual.is_trade());
+    check_ts(actual, ack_ts_emit);
+    if (actual.status == Status::Reject) {
+      ++throughput_.reject_n;
+    }
+    if (digest && (tails != 0)) {
+      // A predicted tail response has been received.
+      ack_actual.add(tail_cmd, actual);
+      if (tail_cmd.opcode == Opcode::QryStats) check_stats(actual);
+      if (tail_cmd.opcode == Opcode::QrySnapshot) capture_snapshot(actual);
+      --tails;
+    } else if (!rsps.empty()) {
+      // A pre-computed response has been received.
+      const std::pair<Command, Response>& cr = rsps.front();
 #ifdef OPT_TRACE_ENABLE
-        if (opts_.trace_enable) {
-          std::cout << "[TB] " << vs_.cycle() << ": Trade emitted: "
-                    << actual.to_string(cr.first.opcode) << "\n";
-        }
+      if (opts_.trace_enable) {
+        std::cout << "[TB] " << check_cycle << ": Response received: "
+                  << cr.second.to_string(cr.first.opcode) << "\n";
+      }
 #endif
-        compare(cr.first, actual, cr.second);
-        rsps.pop_front();
-      } else if (!rsps.empty()) {
-        // A pre-computed response has been received.
-        const std::pair<Command, Response>& cr = rsps.front();
+      compare(cr.first, actual, cr.second);
+      if (cr.first.opcode == Opcode::QryStats) check_stats(actual);
+      if (cr.first.opcode == Opcode::QrySnapshot) capture_snapshot(actual);
+      rsps.pop_front();
+    } else if (auto it = uid_to_cmd.find(actual.uid); it != uid_to_cmd.end()) {
+      // Command response.
+      const Command& cmd = it->second;
+      if (auto ic = uid_to_issue_cycle.find(actual.uid);
+          ic != uid_to_issue_cycle.end()) {
+        // First response of the command; record latency.
+        latency_.add(check_cycle - ic->second.first, ic->second.second);
+        uid_to_issue_cycle.erase(ic);
+      }
+      // Compute set of expected responses.
+      std::deque<Response> expected_rsps = model.apply(cmd);
+      if (cmd.was_cn) {
+        // If the current command originated from the CN table; care must
+        // be delete to delete the entry from this table so that we do not
+        // see it again (on a cancel operation, for example).
+        model.delete_uid_from_cn(cmd.uid);
+      }
 #ifdef OPT_TRACE_ENABLE
-        if (opts_.trace_enable) {
-          std::cout << "[TB] " << vs_.cycle() << ": Response received: "
-                    << cr.second.to_string(cr.first.opcode) << "\n";
-        }
+      if (opts_.trace_enable) {
+        std::cout << "[TB] " << check_cycle << ": Response received: "
+                  << actual.to_string(cmd.opcode) << "\n";
+      }
 #endif
-        compare(cr.first, actual, cr.second);
-        rsps.pop_front();
-      } else if (auto it = uid_to_cmd.find(actual.uid); it != uid_to_cmd.end()) {
-        // Command response.
-        const Command& cmd = it->second;
-        // Compute set of expected responses.
-        std::deque<Response> expected_rsps = model.apply(cmd);
-        if (cmd.was_cn) {
-          // If the current command originated from the CN table; care must
-          // be delete to delete the entry from this table so that we do not
-          // see it again (on a cancel operation, for example).
-          model.delete_uid_from_cn(cmd.uid);
-        }
+      bool delete_uid = true;
+      switch (cmd.opcode) {
+        case Opcode::BuyStopLoss:
+        case Opcode::SellStopLoss:
+        case Opcode::BuyStopLimit:
+        case Opcode::SellStopLimit: {
+          // Difficult to predict the occupancy of the CN table here because
+          // of pipelining. Instead, we accept the status from the RTL as
+          // truth, otherwise if incorrect, the models would soon diverge
+          // anyway.
+          ++cn_issue_n_;
+          if (actual.status != Status::Reject) {
+            // Command was not rejected, therefore permute command.
+            Command permuted_cmd = to_mtr_command(cmd);
+            permuted_cmd.was_cn = true;
 #ifdef OPT_TRACE_ENABLE
-        if (opts_.trace_enable) {
-          std::cout << "[TB] " << vs_.cycle() << ": Response received: "
-                    << actual.to_string(cmd.opcode) << "\n";
-        }
+            if (opts_.trace_enable) {
+              std::cout << "[TB] " << check_cycle
+                        << ": Conditional command issued, becomes (on maturity): "
+                        << permuted_cmd.to_string()
+                        << "\n";
+            }
 #endif
-        bool delete_uid = true;
-        switch (cmd.opcode) {
-          case Opcode::BuyStopLoss:
-          case Opcode::SellStopLoss:
-          case Opcode::BuyStopLimit:
-          case Opcode::SellStopLimit: {
-            // Difficult to predict the occupancy of the CN table here because
-            // of pipelining. Instead, we accept the status from the RTL as
-            // truth, otherwise if incorrect, the models would soon diverge
-            // anyway.
-            if (actual.status != Status::Reject) {
-              // Command was not rejected, therefore permute command.
-              Command permuted_cmd = to_mtr_command(cmd);
-              permuted_cmd.was_cn = true;
+            uid_to_cmd[actual.uid] = permuted_cmd;
+            delete_uid = false;
+          } else {
+            // Command has been rejected.
+            ++cn_reject_n_;
+            model.reject_cn(cmd);
 #ifdef OPT_TRACE_ENABLE
-              if (opts_.trace_enable) {
-                std::cout << "[TB] " << vs_.cycle()
-                          << ": Conditional command issued, becomes (on maturity): "
-                          << permuted_cmd.to_string()
-                          << "\n";
-              }
+            if (opts_.trace_enable) {
+              std::cout << "[TB] " << check_cycle
+                        << ": Conditional command is rejected\n";
+            }
 #endif
-              uid_to_cmd[actual.uid] = permuted_cmd;
-              delete_uid = false;
-            } else {
-              // Command has been rejected.
-              model.delete_uid_from_cn(actual.uid);
-#ifdef OPT_TRACE_ENABLE
-              if (opts_.trace_enable) {
-                std::cout << "[TB] " << vs_.cycle()
-                          << ": Conditional command is rejected\n";
+          }
+        } break;
+        default: {
+          if (digest) {
+            // Fold, rather than compare, the received response and the
+            // predicted responses; tail responses are folded on receipt.
+            ack_actual.add(cmd, actual);
+            if (cmd.opcode == Opcode::QryStats) check_stats(actual);
+            if (cmd.opcode == Opcode::QrySnapshot) capture_snapshot(actual);
+            for (const Response& rsp : expected_rsps) {
+              if (rsp.is_trade()) {
+                trd_expected.add(cmd, rsp);
+              } else {
+                ack_expected.add(cmd, rsp);
+                ++tails;
               }
-#endif
             }
-          } break;
-          default: {
-            // Otherwise, just a standard command.
-            compare(cmd, actual, expected_rsps.front());
-            expected_rsps.pop_front();
-
-            // Predicted tail commands:
-            for (const Response& rsp : expected_rsps) {
+            // Less the response received.
+            --tails;
+            tail_cmd = cmd;
+            break;
+          }
+          // Otherwise, just a standard command.
+          compare(cmd, actual, expected_rsps.front());
+          if (cmd.opcode == Opcode::QryStats) check_stats(actual);
+          if (cmd.opcode == Opcode::QrySnapshot) capture_snapshot(actual);
+          expected_rsps.pop_front();
+
+          // Predicted tail commands:
+          for (const Response& rsp : expected_rsps) {
+            if (rsp.is_trade()) {
+              trds.push_back(std::make_pair(cmd, rsp));
+            } else {
               rsps.push_back(std::make_pair(cmd, rsp));
             }
-          } break;
-        }
-        if (delete_uid) {
-          // Finished with current UID.
-          uid_to_cmd.erase(it);
-        }
-      } else if (opts_.trace_enable) {
+          }
+          drain_trades();
+        } break;
+      }
+      if (delete_uid) {
+        // Finished with current UID.
+        uid_to_cmd.erase(it);
+      }
+      if (const MarketData tob = model.top_of_book(); !(tob == tobs.back())) {
+        tobs.push_back(tob);
+        drain_md();
+      }
+    } else if (opts_.trace_enable) {
+#ifdef OPT_TRACE_ENABLE
+      // Unknown UID has been received.
+      std::cout << "[TB] " << check_cycle << ": Unexpected response: "
+                << actual.to_string(0) << "\n";
+#endif
+    }
+  };
+
+  // Compare digests at a checkpoint; the UUT is quiescent, therefore all
+  // predicted responses have been received. On agreement, retain the
+  // current state such that a subsequent window may be replayed.
+  auto checkpoint = [&]() {
+    if (digest_failed) return;
+
+    if ((ack_actual != ack_expected) || (trd_actual != trd_expected)) {
+      ++digest_.mismatch_n;
+      digest_failed = true;
+      return;
+    }
+    ++digest_.checkpoint_n;
+    restore = model.snapshot();
+    window.clear();
+  };
+
+  // Observed events are checked against the model either inline or, when
+  // enabled, on a checker thread which runs concurrently with the
+  // simulation (the model then adds nothing to simulation time). Tracing
+  // forces inline checking such that the log remains ordered.
+  const bool async_check = opts_.async_check && !opts_.trace_enable;
+  SpscQueue<CheckEvent> events;
+  auto check = [&](const CheckEvent& ev) {
+    check_cycle = ev.cycle;
+    // Stamp any mismatch with the cycle at which it was observed.
+    SCOPED_TRACE("cycle " + std::to_string(ev.cycle));
+    switch (ev.kind) {
+      case CheckEvent::Issue: issue(ev.cmd, ev.bypassed); break;
+      case CheckEvent::Rsp: process(ev.rsp); break;
+      case CheckEvent::Trade: process_trade(ev.rsp); break;
+      case CheckEvent::Md: process_md(ev.md); break;
+      case CheckEvent::Checkpoint: checkpoint(); break;
+      default: break;
+    }
+  };
+  auto post = [&](const CheckEvent& ev) {
+    if (async_check) {
+      events.push(ev);
+    } else {
+      check(ev);
+    }
+  };
+  std::thread checker;
+  if (async_check) {
+    checker = std::thread([&]() {
+      for (CheckEvent ev; ; ) {
+        events.pop(ev);
+        if (ev.kind == CheckEvent::Done) break;
+        check(ev);
+      }
+    });
+  }
+
+  // Most recently accepted market data record.
+  MarketData md;
+
+  // Accept is asserted once every 'n' cycles and thereafter with
+  // probability 'p'.
+  auto accept = [&](std::size_t n, double p) {
+    if ((cycle_ % n) != 0) return false;
+    return (p >= 1.0) || Random::boolean(p);
+  };
+
+  // Drive and sample the response, trade and market data interfaces in the
+  // current cycle; returns true if any interface has a record pending.
+  auto beat = [&]() {
+    bool pending = false;
+
+    // Process Response; all valid lanes of the beat are consumed on accept,
+    // in lane order.
+    //
+    const bool rsp_accept = accept(opts_.rsp_accept_n, opts_.rsp_accept_p);
+    vs_.set_rsp_accept(rsp_accept);
+    for (std::size_t lane = 0; lane < RSP_LANES_N; lane++) {
+      Response actual;
+      vs_.get(actual, lane);
+      // Valid lanes are contiguous from lane 0.
+      if (!actual.valid) break;
+
+      pending = true;
+      if (!rsp_accept) continue;
+
+      if (rsp_filter_) rsp_filter_(actual);
+      post(CheckEvent{CheckEvent::Rsp, cycle_, {}, actual});
+    }
+
+    // Process Trade; backpressured independently of the response interface.
+    //
+    const bool trd_accept = accept(opts_.trd_accept_n, opts_.trd_accept_p);
+    vs_.set_trd_accept(trd_accept);
+    for (std::size_t lane = 0; lane < RSP_LANES_N; lane++) {
+      Response actual;
+      vs_.get_trade(actual, lane);
+      if (!actual.valid) break;
+
+      pending = true;
+      if (trd_accept) post(CheckEvent{CheckEvent::Trade, cycle_, {}, actual});
+    }
+
+    // Market Data; the feed is conflated therefore only the most recently
+    // accepted record is retained.
+    //
+    const bool md_accept = ((cycle_ % opts_.md_accept_n) == 0);
+    vs_.set_md_accept(md_accept);
+    MarketData md_actual;
+    vs_.get(md_actual);
+    if (md_actual.valid) {
+      pending = true;
+      if (md_accept) {
+        md = md_actual;
+        post(CheckEvent{CheckEvent::Md, cycle_, {}, {}, md});
 #ifdef OPT_TRACE_ENABLE
-        // Unknown UID has been received.
-        std::cout << "[TB] " << vs_.cycle() << ": Unexpected response: "
-                  << actual.to_string(0) << "\n";
+        if (opts_.trace_enable) {
+          std::cout << "[TB] " << vs_.cycle() << ": Market data received: "
+                    << md.to_string() << "\n";
+        }
 #endif
       }
     }
+    return pending;
+  };
+
+  // Set interfaces to idle, and continue to drain the response, trade and
+  // market data interfaces until the UUT has been quiescent for some period.
+  auto quiesce = [&]() {
+    cmd.valid = false;
+    vs_.set(cmd);
+    for (std::size_t idle = 0; idle < 20; ) {
+      idle = beat() ? 0 : (idle + 1);
+      step();
+    }
+  };
+
+  // Commands issued in the current digest window.
+  std::size_t window_n = 0;
+  bool stopped = false;
+  while (!stopped) {
+    // Issue command:
+    cmd.valid = false;
+    if (!vs_.get_cmd_full_r() && !cmds_.empty()) {
+      // Apply input command.
+      cmd = cmds_.front();
+#ifdef OPT_TRACE_ENABLE
+      if (opts_.trace_enable) {
+        std::cout << "[TB] " << vs_.cycle()
+                  << ": Issue command: " << cmd.to_string() << "\n";
+      }
+#endif
+      cmds_.pop_front();
+    }
+    // Issue command to RTL
+    vs_.set(cmd);
+
+
+    // Sample response and market data interfaces.
+    beat();
 
     // Advance RTL by one cycle.
+    const vluint64_t issue_cycle = cycle_;
+    const vluint64_t ingress_byp_n = vs_.ingress_byp_n();
     step();
 
-    // Stopped when we've received all data.
-    stopped = cmds_.empty();
+    if (cmd.valid) {
+      // The bypass, if taken, forwards the command in its cycle of issue.
+      CheckEvent ev{CheckEvent::Issue, issue_cycle, cmd, {}};
+      ev.bypassed = (vs_.ingress_byp_n() != ingress_byp_n);
+      post(ev);
+    }
+
+    if (digest && cmd.valid && (++window_n == opts_.digest_window)) {
+      // Checkpoint; pause issue until every response of the window has
+      // been received.
+      quiesce();
+      post(CheckEvent{CheckEvent::Checkpoint, cycle_, {}, {}});
+      window_n = 0;
+    }
+
+    // Stopped when we've received all data (or on a digest mismatch).
+    stopped = cmds_.empty() || digest_failed;
   }
 
+  // Wind-down simulation.
+  quiesce();
+  if (digest) post(CheckEvent{CheckEvent::Checkpoint, cycle_, {}, {}});
 
-  // Set interfaces to idle.
-  cmd.valid = false;
-  vs_.set(cmd);
+  // Await completion of checking.
+  if (async_check) {
+    events.push(CheckEvent{CheckEvent::Done, cycle_, {}, {}});
+    checker.join();
+  }
+
+  // All predicted trades must have been received, and vice versa.
+  EXPECT_TRUE(trds.empty()) << trds.size() << " trade(s) not received";
+  EXPECT_TRUE(trds_actual.empty())
+      << trds_actual.size() << " trade(s) not predicted";
+
+  if (throughput_.cmd_n != 0) {
+    throughput_.cycles = (last_rsp_cycle - first_issue_cycle) + 1;
+  }
 
-  // Wind-down simulation
-  step(20);
+  // Every accepted market data record must have been predicted.
+  EXPECT_TRUE(mds.empty())
+      << mds.size() << " market data record(s) not predicted; first: "
+      << (mds.empty() ? std::string{} : mds.front().to_string());
+
+  // Upon quiescence, the last market data record must reflect the predicted
+  // top-of-book.
+  const MarketData expected_md = model.top_of_book();
+  EXPECT_TRUE(md == expected_md)
+      << " Expected: " << expected_md.to_string()
+      << " Actual: " << md.to_string();
 #ifdef OPT_TRACE_ENABLE
   if (opts_.trace_enable) {
+    std::cout << "[TB] " << vs_.cycle() << ": Command latency: "
+              << latency_.to_string() << "\n";
+    std::cout << "[TB] " << vs_.cycle() << ": Throughput: "
+              << throughput_.to_string() << "\n";
+    std::cout << "[TB] " << vs_.cycle() << ": Conditional commands: "
+              << cn_issue_n_ << " issued, " << cn_reject_n_ << " rejected\n";
     std::cout << "[TB] " << vs_.cycle() << ": Simulation complete!\n";
   }
 #endif
+
+  if (digest_failed) {
+    // Replay the failing window with full checking, onto a UUT restored to
+    // the state of the preceding checkpoint, such that the first response
+    // in disagreement is reported. The statistics of the original run are
+    // retained.
+    ADD_FAILURE() << "Digest mismatch after checkpoint "
+                  << digest_.checkpoint_n << "; replaying "
+                  << window.size() << " command(s) from " << restore.size()
+                  << " restored entries";
+    cmds_.assign(restore.begin(), restore.end());
+    cmds_.insert(cmds_.end(), window.begin(), window.end());
+    DigestStats digest_stats = digest_;
+    digest_stats.replay_n = cmds_.size();
+    const LatencyStats latency = latency_;
+    const ThroughputStats throughput = throughput_;
+    const std::size_t cn_issue_n = cn_issue_n_;
+    const std::size_t cn_reject_n = cn_reject_n_;
+    const std::array<vluint32_t, stats::N> counters = counters_;
+    const std::vector<Response> snapshot = snapshot_;
+
+    const std::size_t digest_window = opts_.digest_window;
+    opts_.digest_window = 0;
+    run();
+    opts_.digest_window = digest_window;
+
+    digest_ = digest_stats;
+    latency_ = latency;
+    throughput_ = throughput;
+    cn_issue_n_ = cn_issue_n;
+    cn_reject_n_ = cn_reject_n;
+    counters_ = counters;
+    snapshot_ = snapshot;
+  }
 }
 
 void TB::reset() {
@@ -762,7 +1592,10 @@ std::string Entry::to_string() const {
 }
 
 bool CNModel::cancel(vluint32_t uid) {
-  if (auto it = cmds_.find(uid); it != cmds_.end()) {
+  auto it = std::find_if(cmds_.begin(), cmds_.end(), [&](const Command& c) {
+    return c.uid == uid;
+  });
+  if (it != cmds_.end()) {
     // Hit matching UID in table. Command is cancelled.
     cmds_.erase(it);
     return true;
@@ -771,10 +1604,28 @@ bool CNModel::cancel(vluint32_t uid) {
 }
 
 bool CNModel::insert(const Command& cmd) {
-  cmds_.insert(std::make_pair(cmd.uid, cmd));
+  cmds_.push_back(cmd);
   return true;
 }
 
+std::vector<Command> CNModel::entries(bool is_buy) const {
+  std::vector<Command> cmds;
+  for (const Command& cmd : cmds_) {
+    const bool cmd_is_buy = (cmd.opcode == Opcode::BuyStopLoss) ||
+                            (cmd.opcode == Opcode::BuyStopLimit);
+    if (cmd_is_buy == is_buy) cmds.push_back(cmd);
+  }
+  // Buy stops mature as the market falls (greatest trigger first), Sell
+  // stops as the market rises (smallest trigger first); ties retain order
+  // of arrival.
+  std::stable_sort(cmds.begin(), cmds.end(),
+                   [&](const Command& lhs, const Command& rhs) {
+                     return is_buy ? (lhs.price1 > rhs.price1)
+                                   : (lhs.price1 < rhs.price1);
+                   });
+  return cmds;
+}
+
 Model::Model(std::size_t bid_n, std::size_t ask_n)
     : bid_n_(bid_n), ask_n_(ask_n)
 {}
@@ -792,6 +1643,9 @@ std::deque<Response> Model::apply(const Command& cmd) {
     return {};
   }
 
+  // Matured conditional commands do not pass through the ingress interface.
+  count(cmd.was_cn ? stats::CnMtr : (stats::Cmd + cmd.opcode));
+
   Response rsp;
   switch (cmd.opcode) {
     case Opcode::Nop: {
@@ -811,6 +1665,8 @@ std::deque<Response> Model::apply(const Command& cmd) {
       rsps.push_back(rsp);
     } break;
     case Opcode::BuyLimit: {
+      if (!qualify(cmd, rsps)) break;
+
       // Command executes, therefore emit response
       rsp.valid = true;
       rsp.uid = cmd.uid;
@@ -827,6 +1683,9 @@ std::deque<Response> Model::apply(const Command& cmd) {
       while (attempt_trade(rsp)) {
         rsps.push_back(rsp);
       }
+      // Kill any non-GUC remainder before considering the reject, such that
+      // it never displaces a resting order.
+      kill(cmd, rsps);
       if (bid_table_.size() > bid_n_) {
         // Issue reject
         const Entry& reject = bid_table_.back();
@@ -839,6 +1698,8 @@ std::deque<Response> Model::apply(const Command& cmd) {
       }
     } break;
     case Opcode::SellLimit: {
+      if (!qualify(cmd, rsps)) break;
+
       // Command executes, therefore emit response
       rsp.valid = true;
       rsp.uid = cmd.uid;
@@ -855,6 +1716,9 @@ std::deque<Response> Model::apply(const Command& cmd) {
       while (attempt_trade(rsp)) {
         rsps.push_back(rsp);
       }
+      // Kill any non-GUC remainder before considering the reject, such that
+      // it never displaces a resting order.
+      kill(cmd, rsps);
       if (ask_table_.size() > ask_n_) {
         // Issue reject
         const Entry& reject = ask_table_.back();
@@ -939,6 +1803,103 @@ std::deque<Response> Model::apply(const Command& cmd) {
       rsp.status = did_cancel ? Status::CancelHit : Status::CancelMiss;
       rsps.push_back(rsp);
     } break;
+    case Opcode::Replace: {
+      // Amend resting limit order. A reduction in quantity at the same price
+      // is updated in place (retaining priority), otherwise the order is
+      // removed and reinserted at the back of its new price level.
+      rsp.valid = true;
+      rsp.uid = cmd.uid;
+      rsp.status = Status::Okay;
+
+      auto amend = [&](std::vector<Entry>& tbl, auto comparer) {
+        auto it = std::find_if(tbl.begin(), tbl.end(), UidFinder{cmd.uid1});
+        if (it == tbl.end()) return false;
+
+        if ((it->price == cmd.price) && (cmd.quantity != 0) &&
+            (cmd.quantity < it->quantity)) {
+          it->quantity = cmd.quantity;
+          rsps.push_back(rsp);
+          return true;
+        }
+        tbl.erase(it);
+        rsps.push_back(rsp);
+        if (cmd.quantity != 0) {
+          Entry e;
+          e.uid = cmd.uid1;
+          e.quantity = cmd.quantity;
+          e.price = cmd.price;
+          tbl.push_back(e);
+          std::stable_sort(tbl.begin(), tbl.end(), comparer);
+
+          while (attempt_trade(rsp)) {
+            rsps.push_back(rsp);
+          }
+        }
+        return true;
+      };
+      if (!amend(bid_table_, BidComparer{}) &&
+          !amend(ask_table_, AskComparer{})) {
+        // Miss, UID not found.
+        rsp.status = Status::CancelMiss;
+        rsps.push_back(rsp);
+      }
+    } break;
+    case Opcode::MassCancel: {
+      // Tables are visited in order: Bid limit, Bid market, Ask limit, Ask
+      // market; each from its head. A response is emitted per cancelled
+      // order, followed by a final response denoting the count.
+      const vluint16_t range = (cmd.quantity & (0x3 << 2));
+      auto in_range = [&](const Entry& e) {
+        switch (range) {
+          case mass_cancel::Ge: return (e.price >= cmd.price);
+          case mass_cancel::Le: return (e.price <= cmd.price);
+          default: return true;
+        }
+      };
+      rsp.valid = true;
+      rsp.uid = cmd.uid;
+      vluint32_t n = 0;
+      auto cancel_from = [&](auto& tbl, bool sel) {
+        if (!sel) return;
+        for (auto it = tbl.begin(); it != tbl.end(); ) {
+          if (!in_range(*it)) {
+            ++it;
+            continue;
+          }
+          rsp.status = Status::CancelHit;
+          rsp.result.poptop.price = it->price;
+          rsp.result.poptop.quantity = it->quantity;
+          rsp.result.poptop.uid = it->uid;
+          rsps.push_back(rsp);
+          ++n;
+          it = tbl.erase(it);
+        }
+      };
+      const bool bid = (cmd.quantity & mass_cancel::Bid) != 0;
+      const bool ask = (cmd.quantity & mass_cancel::Ask) != 0;
+      const bool all = (range == mass_cancel::All);
+      cancel_from(bid_table_, bid);
+      cancel_from(bid_table_mk_, bid && all);
+      cancel_from(ask_table_, ask);
+      cancel_from(ask_table_mk_, ask && all);
+
+      rsp.status = Status::Okay;
+      rsp.result.qry.accum = n;
+      rsps.push_back(rsp);
+    } break;
+    case Opcode::QryStats: {
+      // Counters are streamed in order of identifier; the command itself
+      // has been counted on issue.
+      rsp.valid = true;
+      rsp.uid = cmd.uid;
+      rsp.status = Status::Okay;
+      for (std::size_t id = 0; id < stats::N; id++) {
+        rsp.result.stats.last = (id == (stats::N - 1));
+        rsp.result.stats.id = id;
+        rsp.result.stats.value = stats_[id];
+        rsps.push_back(rsp);
+      }
+    } break;
     case Opcode::QryTblAskLe: {
       rsp.valid = true;
       rsp.uid = cmd.uid;
@@ -969,6 +1930,99 @@ std::deque<Response> Model::apply(const Command& cmd) {
       }
       rsps.push_back(rsp);
     } break;
+    case Opcode::QryDepthBid:
+    case Opcode::QryDepthAsk: {
+      const std::vector<Entry>& tbl =
+          (cmd.opcode == Opcode::QryDepthBid) ? bid_table_ : ask_table_;
+      rsp.valid = true;
+      rsp.uid = cmd.uid;
+      if (tbl.empty()) {
+        // Table is unpopulated therefore command cannot complete.
+        rsp.status = Status::Bad;
+        rsps.push_back(rsp);
+        break;
+      }
+      // Tables are sorted, therefore entries at the same price are
+      // consecutive; aggregate each into a level, upto K levels (where K == 0
+      // denotes all levels).
+      rsp.status = Status::Okay;
+      rsp.result.depth.last = false;
+      std::deque<Response> levels;
+      for (const Entry& e : tbl) {
+        if (levels.empty() || (levels.back().result.depth.price != e.price)) {
+          if ((cmd.quantity != 0) && (levels.size() == cmd.quantity)) break;
+
+          rsp.result.depth.level = levels.size();
+          rsp.result.depth.price = e.price;
+          rsp.result.depth.accum = 0;
+          levels.push_back(rsp);
+        }
+        levels.back().result.depth.accum += e.quantity;
+      }
+      levels.back().result.depth.last = true;
+      rsps.insert(rsps.end(), levels.begin(), levels.end());
+    } break;
+    case Opcode::QrySnapshot: {
+      // Tables are streamed in turn, each from its head; conditional entries
+      // are followed by their extension (trigger price and opcode).
+      rsp.valid = true;
+      rsp.uid = cmd.uid;
+      rsp.status = Status::Okay;
+      rsp.result.snapshot = {};
+      auto emit = [&](vluint8_t table, bool ext, vluint32_t price,
+                      vluint16_t quantity, vluint32_t uid) {
+        rsp.result.snapshot.table = table;
+        rsp.result.snapshot.ext = ext;
+        rsp.result.snapshot.price = price;
+        rsp.result.snapshot.quantity = quantity;
+        rsp.result.snapshot.uid = uid;
+        rsps.push_back(rsp);
+      };
+      for (const Entry& e : bid_table_)
+        emit(snapshot::LmBid, false, e.price, e.quantity, e.uid);
+      for (const Entry& e : ask_table_)
+        emit(snapshot::LmAsk, false, e.price, e.quantity, e.uid);
+      for (const Entry& e : bid_table_mk_)
+        emit(snapshot::MkBid, false, e.price, e.quantity, e.uid);
+      for (const Entry& e : ask_table_mk_)
+        emit(snapshot::MkAsk, false, e.price, e.quantity, e.uid);
+      for (const bool is_buy : {true, false}) {
+        const vluint8_t table = is_buy ? snapshot::CnBuy : snapshot::CnSell;
+        for (const Command& c : cn_model_.entries(is_buy)) {
+          emit(table, false, c.price, c.quantity, c.uid);
+          emit(table, true, c.price1, snapshot::pack_ext(c.opcode, c.tif),
+               c.uid);
+        }
+      }
+      rsp.result.snapshot = {};
+      rsp.result.snapshot.last = true;
+      rsps.push_back(rsp);
+    } break;
+    case Opcode::LoadBid:
+    case Opcode::LoadAsk: {
+      // Entry is installed behind those of equal price without matching; a
+      // full table rejects the entry.
+      const bool is_bid = (cmd.opcode == Opcode::LoadBid);
+      std::vector<Entry>& tbl = is_bid ? bid_table_ : ask_table_;
+      rsp.valid = true;
+      rsp.uid = cmd.uid;
+      if (tbl.size() == (is_bid ? bid_n_ : ask_n_)) {
+        rsp.status = Status::Reject;
+      } else {
+        rsp.status = Status::Okay;
+        Entry e;
+        e.uid = cmd.uid;
+        e.quantity = cmd.quantity;
+        e.price = cmd.price;
+        tbl.push_back(e);
+        if (is_bid) {
+          std::stable_sort(tbl.begin(), tbl.end(), BidComparer{});
+        } else {
+          std::stable_sort(tbl.begin(), tbl.end(), AskComparer{});
+        }
+      }
+      rsps.push_back(rsp);
+    } break;
     case Opcode::BuyMarket: {
       rsp.valid = true;
       rsp.uid = cmd.uid;
@@ -976,7 +2030,7 @@ std::deque<Response> Model::apply(const Command& cmd) {
         // Table has reached capacity, reject
         rsp.status = Status::Reject;
         rsps.push_back(rsp);
-      } else {
+      } else if (qualify(cmd, rsps)) {
         // Okay push to the back of the deque.
         Entry e;
         e.uid = cmd.uid;
@@ -988,6 +2042,7 @@ std::deque<Response> Model::apply(const Command& cmd) {
         while (attempt_trade(rsp)) {
           rsps.push_back(rsp);
         }
+        kill(cmd, rsps);
       }
     } break;
     case Opcode::SellMarket: {
@@ -998,7 +2053,7 @@ std::deque<Response> Model::apply(const Command& cmd) {
         // Table has reached capacity, reject
         rsp.status = Status::Reject;
         rsps.push_back(rsp);
-      } else {
+      } else if (qualify(cmd, rsps)) {
         // Okay push to the back of the deque.
         Entry e;
         e.uid = cmd.uid;
@@ -1011,6 +2066,7 @@ std::deque<Response> Model::apply(const Command& cmd) {
         while (attempt_trade(rsp)) {
           rsps.push_back(rsp);
         }
+        kill(cmd, rsps);
       }
     } break;
     case Opcode::BuyStopLoss:
@@ -1031,6 +2087,27 @@ std::deque<Response> Model::apply(const Command& cmd) {
     } break;
   }
 
+  // Count trades and rejects by the table from which they originate.
+  // Rejects of conditional commands are not predicted (see reject_cn).
+  for (const Response& r : rsps) {
+    if (r.is_trade()) {
+      count(stats::Trade);
+    } else if (r.status == Status::Reject) {
+      switch (cmd.opcode) {
+        case Opcode::BuyLimit: count(stats::RejectLmBid); break;
+        case Opcode::SellLimit: count(stats::RejectLmAsk); break;
+        case Opcode::BuyMarket: count(stats::RejectMkBid); break;
+        case Opcode::SellMarket: count(stats::RejectMkAsk); break;
+        default: break;
+      }
+    } else if (cmd.opcode == Opcode::Cancel) {
+      count((r.status == Status::CancelHit) ? stats::CancelHit
+                                            : stats::CancelMiss);
+    }
+  }
+
+  publish_top_of_book();
+
 #if defined(OPT_VERBOSE) && defined(OPT_TRACE_ENABLE)
   verbose();
 #endif
@@ -1046,10 +2123,195 @@ std::deque<Response> Model::apply_mtr(const Command& cmd) {
   return apply(permuted_command);
 }
 
+void Model::reject_cn(const Command& cmd) {
+  cn_model_.cancel(cmd.uid);
+  switch (cmd.opcode) {
+    case Opcode::BuyStopLoss:
+    case Opcode::BuyStopLimit: count(stats::RejectCnBuy); break;
+    default: count(stats::RejectCnSell); break;
+  }
+}
+
+void Model::count(std::size_t id) {
+  // Saturate, as the UUT.
+  if (stats_[id] != std::numeric_limits<vluint32_t>::max()) ++stats_[id];
+}
+
 bool Model::delete_uid_from_cn(vluint32_t uid) {
   return cn_model_.cancel(uid);
 }
 
+std::vector<Command> Model::snapshot() const {
+  std::vector<Command> cmds;
+  auto restore = [&](vluint8_t opcode, const Entry& e) {
+    Command cmd;
+    cmd.valid = true;
+    cmd.opcode = opcode;
+    cmd.uid = e.uid;
+    cmd.quantity = e.quantity;
+    cmd.price = e.price;
+    cmds.push_back(cmd);
+  };
+  for (const Entry& e : bid_table_) restore(Opcode::LoadBid, e);
+  for (const Entry& e : ask_table_) restore(Opcode::LoadAsk, e);
+  for (const Entry& e : bid_table_mk_) restore(Opcode::BuyMarket, e);
+  for (const Entry& e : ask_table_mk_) restore(Opcode::SellMarket, e);
+  for (const bool is_buy : {true, false}) {
+    for (const Command& c : cn_model_.entries(is_buy)) {
+      Command cmd;
+      cmd.valid = true;
+      cmd.opcode = c.opcode;
+      cmd.tif = c.tif;
+      cmd.uid = c.uid;
+      cmd.quantity = c.quantity;
+      cmd.price = c.price;
+      cmd.price1 = c.price1;
+      cmds.push_back(cmd);
+    }
+  }
+  return cmds;
+}
+
+MarketData Model::top_of_book() const {
+  MarketData md;
+  if (!bid_table_.empty()) {
+    const Entry& bid = bid_table_.front();
+    md.bid_vld = true;
+    md.bid_price = bid.price;
+    md.bid_quantity = bid.quantity;
+  }
+  if (!ask_table_.empty()) {
+    const Entry& ask = ask_table_.front();
+    md.ask_vld = true;
+    md.ask_price = ask.price;
+    md.ask_quantity = ask.quantity;
+  }
+  return md;
+}
+
+void Model::publish(TopOfBook* tob) {
+  tob_ = tob;
+  if (tob_ == nullptr) return;
+
+  tob_last_ = top_of_book();
+  tob_last_.valid = true;
+  tob_->store(tob_last_);
+}
+
+void Model::publish_top_of_book() {
+  if (tob_ == nullptr) return;
+
+  // Readers are only disturbed when the top-of-book actually changes; the
+  // majority of commands rest behind, or trade without exhausting, the head.
+  MarketData md = top_of_book();
+  if (md == tob_last_) return;
+
+  md.valid = true;
+  tob_last_ = md;
+  tob_->store(md);
+}
+
+const Entry* Model::find_limit(vluint32_t uid) const {
+  for (const std::vector<Entry>* tbl : {&bid_table_, &ask_table_}) {
+    if (auto it = std::find_if(tbl->begin(), tbl->end(), UidFinder{uid});
+        it != tbl->end()) {
+      return &*it;
+    }
+  }
+  return nullptr;
+}
+
+vluint32_t Model::available(const Command& cmd) const {
+  vluint32_t quantity = 0;
+  switch (cmd.opcode) {
+    case Opcode::BuyLimit:
+    case Opcode::BuyMarket: {
+      const bool is_limit = (cmd.opcode == Opcode::BuyLimit);
+      for (const Entry& e : ask_table_) {
+        if (!is_limit || (cmd.price >= e.price)) {
+          quantity += e.quantity;
+        }
+      }
+      for (const Entry& e : ask_table_mk_) {
+        quantity += e.quantity;
+      }
+    } break;
+    case Opcode::SellLimit:
+    case Opcode::SellMarket: {
+      const bool is_limit = (cmd.opcode == Opcode::SellLimit);
+      for (const Entry& e : bid_table_) {
+        if (!is_limit || (cmd.price <= e.price)) {
+          quantity += e.quantity;
+        }
+      }
+      for (const Entry& e : bid_table_mk_) {
+        quantity += e.quantity;
+      }
+    } break;
+    default: {
+      // Otherwise, not applicable.
+    } break;
+  }
+  return quantity;
+}
+
+bool Model::qualify(const Command& cmd, std::deque<Response>& rsps) const {
+  switch (cmd.tif) {
+    case Tif::FillOrKill:
+    case Tif::AllOrNone: {
+      // Order must execute in its entirety, otherwise it is killed prior to
+      // installation.
+      if (available(cmd) < cmd.quantity) {
+        Response rsp;
+        rsp.valid = true;
+        rsp.uid = cmd.uid;
+        rsp.status = Status::Killed;
+        rsps.push_back(rsp);
+        return false;
+      }
+    } break;
+    default: {
+    } break;
+  }
+  return true;
+}
+
+void Model::kill(const Command& cmd, std::deque<Response>& rsps) {
+  if (cmd.tif == Tif::GoodUntilCancelled) return;
+
+  // Remove unexecuted remainder of the order, where present. The order may
+  // have already executed in its entirety.
+  bool did_kill = false;
+  if (auto it = std::find_if(bid_table_.begin(), bid_table_.end(),
+                             UidFinder{cmd.uid}); it != bid_table_.end()) {
+    did_kill = true;
+    bid_table_.erase(it);
+  } else if (auto it = std::find_if(ask_table_.begin(), ask_table_.end(),
+                                    UidFinder{cmd.uid});
+             it != ask_table_.end()) {
+    did_kill = true;
+    ask_table_.erase(it);
+  } else if (auto it = std::find_if(bid_table_mk_.begin(), bid_table_mk_.end(),
+                                    UidFinder{cmd.uid});
+             it != bid_table_mk_.end()) {
+    did_kill = true;
+    bid_table_mk_.erase(it);
+  } else if (auto it = std::find_if(ask_table_mk_.begin(), ask_table_mk_.end(),
+                                    UidFinder{cmd.uid});
+             it != ask_table_mk_.end()) {
+    did_kill = true;
+    ask_table_mk_.erase(it);
+  }
+
+  if (did_kill) {
+    Response rsp;
+    rsp.valid = true;
+    rsp.uid = cmd.uid;
+    rsp.status = Status::Killed;
+    rsps.push_back(rsp);
+  }
+}
+
 void Model::dump(std::ostream& os) const {
   os << "Bid Table:\n";
   for (int i = 0; i < bid_table_.size(); i++) {
@@ -1312,9 +2574,11 @@ void Model::verbose() const {
 #endif
 
 StimulusGenerator::StimulusGenerator(const Bag<vluint8_t>& opcodes,
-                                     double mean, double stddev)
-    : opcodes_(opcodes), model_(BID_TABLE_DEPTH_N, ASK_TABLE_DEPTH_N),
-      mean_(mean), stddev_(stddev) {
+                                     double mean, double stddev,
+                                     const Bag<vluint8_t>& tifs)
+    : rng_(Random::rng()()), prices_(mean, stddev),
+      opcodes_(opcodes), model_(BID_TABLE_DEPTH_N, ASK_TABLE_DEPTH_N),
+      mean_(mean), stddev_(stddev), tifs_(tifs) {
 }
 
 std::deque<Command> StimulusGenerator::generate(std::size_t n) {
@@ -1346,12 +2610,13 @@ std::deque<Command> StimulusGenerator::generate(std::size_t n) {
 void StimulusGenerator::generate(Command& cmd) {
   cmd.valid = true;
   cmd.uid = uid_i_;
-  cmd.opcode = opcodes_();
+  cmd.opcode = opcodes_(rng_);
+  cmd.tif = tifs_(rng_);
 
-  const double price = Random::normal(mean_, stddev_);
-  const Bcd bcd = Bcd::from_string(to_bcd_string(price));
+  const double price = prices_(rng_);
+  const Bcd bcd = Bcd::from_packed(tb::bcd::from_double(price));
   ASSERT_TRUE(bcd.is_valid());
-  const vluint16_t quantity = Random::uniform<int>(100, 10);
+  const vluint16_t quantity = rng_.uniform<int>(100, 10);
 
   switch (cmd.opcode) {
     case Opcode::Nop: {
@@ -1381,9 +2646,11 @@ void StimulusGenerator::generate(Command& cmd) {
       // No oprands.
     } break;
     case Opcode::Cancel: {
-      const bool do_definately_miss = Random::boolean(0.1);
+      const bool do_definately_miss =
+          rng_.boolean(0.1) || prior_uid_.empty();
       if (!do_definately_miss) {
-        auto it = Random::select_one(prior_uid_.begin(), prior_uid_.end());
+        auto it =
+            Random::select_one(rng_, prior_uid_.begin(), prior_uid_.end());
         cmd.uid1 = *it;
       } else {
         // Some UID we haven't issued yet and which is guarenteed to
@@ -1396,12 +2663,45 @@ void StimulusGenerator::generate(Command& cmd) {
       // Query either table for some random price.
       cmd.price = bcd.pack();
     } break;
+    case Opcode::QryStats:
+    case Opcode::QrySnapshot: {
+      // No oprands.
+    } break;
+    case Opcode::LoadBid:
+    case Opcode::LoadAsk: {
+      cmd.quantity = quantity;
+      cmd.price = bcd.pack();
+    } break;
+    case Opcode::QryDepthBid:
+    case Opcode::QryDepthAsk: {
+      // Some number of levels (zero denotes all).
+      cmd.quantity = rng_.uniform<int>(4, 0);
+    } break;
+    case Opcode::Replace: {
+      // Amend some prior order; either reduce its quantity in place, or
+      // move it to some random price/quantity.
+      auto it =
+          Random::select_one(rng_, prior_uid_.begin(), prior_uid_.end());
+      cmd.uid1 = (it != prior_uid_.end()) ? *it : (uid_i_ + 100);
+      cmd.quantity = quantity;
+      cmd.price = bcd.pack();
+      if (const Entry* e = model_.find_limit(cmd.uid1);
+          (e != nullptr) && (e->quantity > 1) && rng_.boolean(0.5)) {
+        cmd.quantity = rng_.uniform<int>(e->quantity - 1, 1);
+        cmd.price = e->price;
+      }
+    } break;
+    case Opcode::MassCancel: {
+      // Either, or both, sides over some range about a random price.
+      cmd.quantity = rng_.uniform<int>(3, 1) | (rng_.uniform<int>(2, 0) << 2);
+      cmd.price = bcd.pack();
+    } break;
     case Opcode::BuyStopLoss:
     case Opcode::SellStopLoss:
     case Opcode::BuyStopLimit:
     case Opcode::SellStopLimit: {
-      const double price1 = Random::normal(mean_, stddev_);
-      const Bcd bcd1 = Bcd::from_string(to_bcd_string(price1));
+      const double price1 = prices_(rng_);
+      const Bcd bcd1 = Bcd::from_packed(tb::bcd::from_double(price1));
       cmd.price1 = bcd1.pack();
     } break;
   }
@@ -0,0 +1,91 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "bcd.h"
+#include <cstdio>
+#include <string>
+
+static_assert(tb::bcd::from_cents(12345) == 0x12345);
+static_assert(tb::bcd::to_cents(0x99999) == 99999);
+static_assert(tb::bcd::from_ascii("1.5", 3) == 0x00150);
+
+TEST(TbBcd, Cents) {
+  // Exhaustively compare against the decimal rendering of each price.
+  for (std::uint32_t c = 0; c <= tb::bcd::CENTS_MAX; c++) {
+    char s[16];
+    std::snprintf(s, sizeof(s), "%05u", c);
+    std::uint32_t expected = 0;
+    for (std::size_t i = 0; i < tb::bcd::DIGITS_N; i++) {
+      expected = (expected << 4) | (s[i] - '0');
+    }
+    const std::uint32_t packed = tb::bcd::from_cents(c);
+    ASSERT_EQ(packed, expected);
+    ASSERT_EQ(tb::bcd::to_cents(packed), c);
+    ASSERT_TRUE(tb::bcd::is_valid(packed));
+  }
+}
+
+TEST(TbBcd, Ascii) {
+  for (std::uint32_t c = 0; c <= tb::bcd::CENTS_MAX; c++) {
+    const std::uint32_t packed = tb::bcd::from_cents(c);
+    char s[tb::bcd::ASCII_MAX_N];
+    const std::size_t n = tb::bcd::to_ascii(packed, s);
+    ASSERT_EQ(tb::bcd::from_ascii(s, n), packed);
+
+    // Rendering matches the (legacy) BCD string representation.
+    char expected[16];
+    std::snprintf(expected, sizeof(expected), "%u.%02u", c / 100, c % 100);
+    const std::string e = (c < 100) ? std::string(expected + 1) : expected;
+    ASSERT_EQ(std::string(s, n), e);
+    ASSERT_EQ(tb::Bcd::from_packed(packed).to_string(), e);
+  }
+}
+
+TEST(TbBcd, Double) {
+  EXPECT_EQ(tb::bcd::from_double(100.0), 0x10000u);
+  EXPECT_EQ(tb::bcd::from_double(123.456), 0x12346u);
+  EXPECT_EQ(tb::bcd::from_double(0.004), tb::bcd::PACKED_MIN);
+  // Out-of-range prices saturate.
+  EXPECT_EQ(tb::bcd::from_double(-3.0), tb::bcd::PACKED_MIN);
+  EXPECT_EQ(tb::bcd::from_double(1000.0), tb::bcd::PACKED_MAX);
+}
+
+TEST(TbBcd, Invalid) {
+  // Each digit position with each non-decimal value.
+  for (std::size_t i = 0; i < tb::bcd::DIGITS_N; i++) {
+    for (std::uint32_t d = 10; d < 16; d++) {
+      EXPECT_FALSE(tb::bcd::is_valid(d << (4 * i)));
+    }
+  }
+  EXPECT_FALSE(tb::bcd::is_valid(0x100000));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
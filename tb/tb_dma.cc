@@ -0,0 +1,148 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "gtest/gtest.h"
+#include "dma.h"
+#include "cmd.h"
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Server in a child process. The child exits without unwinding, therefore the
+// region is unlinked by the parent (join_server).
+pid_t fork_server(const tb::dma::ServerOptions& opts) {
+  tb::dma::Shm::unlink(opts.name);
+  const pid_t pid = ::fork();
+  if (pid == 0) {
+    tb::dma::Server server{opts};
+    server.run();
+    ::_exit(server.ok() ? 0 : 1);
+  }
+  return pid;
+}
+
+// Reap the server; returns its exit status.
+int join_server(pid_t pid, const tb::dma::ServerOptions& opts) {
+  int status = 0;
+  if (::waitpid(pid, &status, 0) != pid) status = -1;
+  tb::dma::Shm::unlink(opts.name);
+  return status;
+}
+
+// Submit 'cmds' in batches of 'batch'; return all responses received
+// until 'n' acknowledgements have arrived.
+std::vector<tb::Response> exchange(tb::dma::Client& client,
+                                   const std::vector<tb::Command>& cmds,
+                                   std::size_t batch, tb::dma::Wait w) {
+  std::vector<tb::Response> rsps;
+  std::vector<tb::Response> buf(64);
+  std::size_t submitted = 0, acks = 0;
+  while (acks < cmds.size()) {
+    if (submitted < cmds.size()) {
+      submitted += client.submit(
+          &cmds[submitted], std::min(batch, cmds.size() - submitted));
+    }
+    const std::size_t k = client.wait(buf.data(), buf.size(), w);
+    if ((k == 0) && (submitted == cmds.size())) break;
+    for (std::size_t i = 0; i < k; i++) {
+      if (!buf[i].is_trade()) ++acks;
+      rsps.push_back(buf[i]);
+    }
+  }
+  return rsps;
+}
+
+void run(tb::dma::Wait w, std::size_t batch) {
+  tb::dma::ServerOptions opts;
+  opts.name = "/ob_tb_dma." + std::to_string(::getpid());
+  opts.wait = w;
+  // Ring smaller than the stimulus such that the host is backpressured.
+  opts.cmd_n = 16;
+  opts.rsp_n = 16;
+  const pid_t pid = fork_server(opts);
+  ASSERT_GT(pid, 0);
+
+  tb::dma::Client client{opts.name};
+  if (!client.connected()) {
+    ::kill(pid, SIGKILL);
+    join_server(pid, opts);
+    FAIL() << "Unable to attach to server region " << opts.name;
+  }
+
+  std::vector<tb::Command> cmds;
+  vluint32_t uid = 0;
+  // Resting asks swept by a single bid; one trade per ask.
+  cmds.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "100.00", 10));
+  cmds.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "100.25", 10));
+  cmds.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "100.50", 10));
+  cmds.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "100.75", 10));
+  cmds.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "101.00", 40));
+  for (int i = 0; i < 64; i++) cmds.push_back(tb::make_nop(uid++));
+
+  const std::vector<tb::Response> rsps = exchange(client, cmds, batch, w);
+  client.stop();
+  const int status = join_server(pid, opts);
+  ASSERT_NE(status, -1);
+  EXPECT_TRUE(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+
+  // Acknowledgements are received in command order; trades in any order
+  // relative to the acknowledgements.
+  std::size_t ack = 0, trades = 0;
+  for (const tb::Response& rsp : rsps) {
+    if (rsp.is_trade()) {
+      ++trades;
+      EXPECT_EQ(rsp.result.trade.bid_uid, 4);
+      EXPECT_EQ(rsp.result.trade.quantity, 10);
+      continue;
+    }
+    ASSERT_LT(ack, cmds.size());
+    EXPECT_EQ(rsp.uid, cmds[ack].uid);
+    EXPECT_EQ(rsp.status, tb::Status::Okay);
+    ++ack;
+  }
+  EXPECT_EQ(ack, cmds.size());
+  EXPECT_EQ(trades, 4);
+}
+
+} // namespace
+
+TEST(TbDma, Poll) {
+  run(tb::dma::Wait::Poll, 1);
+}
+
+TEST(TbDma, Interrupt) {
+  run(tb::dma::Wait::Interrupt, 8);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
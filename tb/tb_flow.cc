@@ -0,0 +1,179 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "gtest/gtest.h"
+#include "flow.h"
+#include "bcd.h"
+#include <unistd.h>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+TEST(TbFlow, Parse) {
+  tb::flow::Params p;
+  EXPECT_TRUE(p.valid());
+  EXPECT_TRUE(tb::flow::parse("# Bursty\n"
+                              "seed = 7\n"
+                              "\n"
+                              "  mu=0.02   # baseline\n"
+                              "alpha = 0.09\n"
+                              "cancel_shape = 0.5\n", p));
+  EXPECT_EQ(p.seed, 7);
+  EXPECT_DOUBLE_EQ(p.mu, 0.02);
+  EXPECT_DOUBLE_EQ(p.alpha, 0.09);
+  EXPECT_DOUBLE_EQ(p.cancel_shape, 0.5);
+  // Fields not named retain their value.
+  EXPECT_DOUBLE_EQ(p.beta, 0.1);
+
+  tb::flow::Params q;
+  EXPECT_FALSE(tb::flow::parse("unknown = 1\n", q));
+  EXPECT_FALSE(tb::flow::parse("mu = fast\n", q));
+  EXPECT_FALSE(tb::flow::parse("mu\n", q));
+  EXPECT_FALSE(tb::flow::parse("seed = -1\n", q));
+  // Explosive: excitation does not decay faster than it accrues.
+  EXPECT_FALSE(tb::flow::parse("alpha = 0.1\nbeta = 0.1\n", q));
+}
+
+TEST(TbFlow, Load) {
+  char path[] = "/tmp/tb_flow.XXXXXX";
+  const int fd = ::mkstemp(path);
+  ASSERT_GE(fd, 0);
+  const std::string text = "mid = 50.0\nqty_alpha = 1.2\n";
+  ASSERT_EQ(::write(fd, text.data(), text.size()),
+            static_cast<ssize_t>(text.size()));
+  ::close(fd);
+
+  tb::flow::Params p;
+  EXPECT_TRUE(tb::flow::load(path, p));
+  EXPECT_DOUBLE_EQ(p.mid, 50.0);
+  EXPECT_DOUBLE_EQ(p.qty_alpha, 1.2);
+  std::remove(path);
+  EXPECT_FALSE(tb::flow::load(path, p));
+}
+
+TEST(TbFlow, Generate) {
+  tb::flow::Params p;
+  const std::size_t n = 100000;
+  tb::flow::Generator gen{p};
+  const std::vector<tb::flow::Arrival> as = gen.generate(n);
+  ASSERT_EQ(as.size(), n);
+
+  // Reproducible from the seed.
+  tb::flow::Generator again{p};
+  for (std::size_t i = 0; i < 1000; i++) {
+    const tb::flow::Arrival a = again.next();
+    ASSERT_EQ(a.cycle, as[i].cycle);
+    ASSERT_EQ(a.cmd.opcode, as[i].cmd.opcode);
+    ASSERT_EQ(a.cmd.price, as[i].cmd.price);
+    ASSERT_EQ(a.cmd.quantity, as[i].cmd.quantity);
+  }
+
+  std::map<vluint32_t, std::size_t> placed;
+  std::vector<vluint64_t> gaps;
+  vluint16_t qty_max = 0;
+  for (std::size_t i = 0; i < n; i++) {
+    const tb::Command& cmd = as[i].cmd;
+    EXPECT_TRUE(cmd.valid);
+    EXPECT_EQ(cmd.uid, i);
+    if (i != 0) {
+      ASSERT_GE(as[i].cycle, as[i - 1].cycle);
+      gaps.push_back(as[i].cycle - as[i - 1].cycle);
+    }
+    switch (cmd.opcode) {
+      case tb::Opcode::BuyLimit:
+      case tb::Opcode::SellLimit: {
+        EXPECT_TRUE(tb::Bcd::from_packed(cmd.price).is_valid());
+        placed[cmd.uid] = i;
+      } [[fallthrough]];
+      case tb::Opcode::BuyMarket:
+      case tb::Opcode::SellMarket: {
+        EXPECT_GE(cmd.quantity, p.qty_min);
+        EXPECT_LE(cmd.quantity, p.qty_max);
+        qty_max = std::max(qty_max, cmd.quantity);
+      } break;
+      case tb::Opcode::Cancel: {
+        // Cancels are only of prior limit orders.
+        EXPECT_EQ(placed.count(cmd.uid1), 1);
+      } break;
+      default: {
+        EXPECT_EQ(cmd.opcode, tb::Opcode::QryBidAsk);
+      } break;
+    }
+  }
+  const tb::flow::GeneratorStats& s = gen.stats();
+  EXPECT_EQ(s.limit_n + s.market_n + s.query_n + s.cancel_n, n);
+  EXPECT_GT(s.cancel_n, 0);
+  EXPECT_GT(s.cross_n, 0);
+  EXPECT_GT(s.stale_n, 0);
+
+  // Mean arrival rate approximates that of the stationary process,
+  // mu / (1 - alpha / beta), augmented by cancels.
+  const double rate = static_cast<double>(n - s.cancel_n) / as.back().cycle;
+  const double expected = p.mu / (1.0 - p.alpha / p.beta);
+  EXPECT_NEAR(rate, expected, 0.2 * expected);
+
+  // Bursty: the peak intensity is many times the mean, and inter-arrival
+  // times are overdispersed (coefficient of variation well above that of a
+  // Poisson process).
+  EXPECT_GT(s.peak, 4 * expected);
+  double mean = 0.0, var = 0.0;
+  for (vluint64_t g : gaps) mean += g;
+  mean /= gaps.size();
+  for (vluint64_t g : gaps) var += (g - mean) * (g - mean);
+  var /= gaps.size();
+  EXPECT_GT(std::sqrt(var) / mean, 1.5);
+
+  // Heavy tailed: quantities far beyond the minimum occur.
+  EXPECT_GT(qty_max, 100 * p.qty_min);
+}
+
+TEST(TbFlow, Drift) {
+  tb::flow::Params p;
+  p.drift = 0.001;
+  p.volatility = 0.0;
+  tb::flow::Generator gen{p};
+  const std::vector<tb::flow::Arrival> as = gen.generate(1000);
+  EXPECT_NEAR(gen.mid(), p.mid + p.drift * as.back().cycle, 0.01);
+}
+
+TEST(TbFlow, Schedule) {
+  tb::flow::Params p;
+  tb::flow::Generator gen{p};
+  const std::vector<tb::flow::Arrival> as = gen.generate(2000);
+  tb::TB tb;
+  tb::flow::schedule(as, tb);
+  tb.run();
+
+  EXPECT_EQ(tb.throughput().cmd_n, as.size());
+  // The flow is paced by its arrivals.
+  EXPECT_GE(tb.throughput().cycles, as.back().cycle - as.front().cycle);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
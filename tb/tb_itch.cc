@@ -0,0 +1,295 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "gtest/gtest.h"
+#include "itch.h"
+#include "bcd.h"
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Synthetic ITCH message file.
+class Builder {
+ public:
+  const std::vector<std::byte>& data() const { return b_; }
+
+  void add(std::uint64_t ref, char side, std::uint32_t shares,
+           const char* stock, std::uint32_t price) {
+    begin('A');
+    be(ref, 8);
+    b_.push_back(static_cast<std::byte>(side));
+    be(shares, 4);
+    char s[8];
+    std::memset(s, ' ', sizeof(s));
+    std::memcpy(s, stock, std::min(std::strlen(stock), sizeof(s)));
+    for (char c : s) b_.push_back(static_cast<std::byte>(c));
+    be(price, 4);
+    end();
+  }
+
+  void execute(std::uint64_t ref, std::uint32_t shares) {
+    begin('E');
+    be(ref, 8);
+    be(shares, 4);
+    be(0, 8);
+    end();
+  }
+
+  void cancel(std::uint64_t ref, std::uint32_t shares) {
+    begin('X');
+    be(ref, 8);
+    be(shares, 4);
+    end();
+  }
+
+  void remove(std::uint64_t ref) {
+    begin('D');
+    be(ref, 8);
+    end();
+  }
+
+  void replace(std::uint64_t ref, std::uint64_t new_ref,
+               std::uint32_t shares, std::uint32_t price) {
+    begin('U');
+    be(ref, 8);
+    be(new_ref, 8);
+    be(shares, 4);
+    be(price, 4);
+    end();
+  }
+
+  // System event; not applicable to the book.
+  void system_event() {
+    begin('S');
+    b_.push_back(std::byte{'O'});
+    end();
+  }
+
+  // Write to a temporary file; returns its path.
+  std::string write() const {
+    char path[] = "/tmp/tb_itch.XXXXXX";
+    const int fd = ::mkstemp(path);
+    if (fd < 0) return {};
+    const bool ok = (::write(fd, b_.data(), b_.size()) ==
+                     static_cast<ssize_t>(b_.size()));
+    ::close(fd);
+    return ok ? path : std::string{};
+  }
+
+ private:
+  void be(std::uint64_t v, std::size_t n) {
+    for (std::size_t i = n; i > 0; i--) {
+      b_.push_back(static_cast<std::byte>(v >> (8 * (i - 1))));
+    }
+  }
+
+  // Length, type, stock locate, tracking number, timestamp.
+  void begin(char type) {
+    start_ = b_.size();
+    be(0, 2);
+    b_.push_back(static_cast<std::byte>(type));
+    be(1, 2);
+    be(0, 2);
+    be(0, 6);
+  }
+
+  void end() {
+    const std::size_t n = b_.size() - start_ - 2;
+    b_[start_] = static_cast<std::byte>(n >> 8);
+    b_[start_ + 1] = static_cast<std::byte>(n);
+  }
+
+  std::vector<std::byte> b_;
+  std::size_t start_ = 0;
+};
+
+std::vector<tb::Command> convert(tb::itch::Converter& c, const Builder& b) {
+  std::vector<tb::Command> cmds;
+  c.convert(b.data().data(), b.data().size(),
+            [&](const tb::Command& cmd) { cmds.push_back(cmd); });
+  return cmds;
+}
+
+// ITCH price (4 implied decimal places) from cents.
+constexpr std::uint32_t px(std::uint32_t cents) { return cents * 100; }
+
+} // namespace
+
+TEST(TbItch, Convert) {
+  Builder b;
+  b.system_event();
+  b.add(10, 'B', 100, "AAPL", px(10000));
+  b.add(11, 'S', 50, "MSFT", px(10100));
+  b.add(12, 'S', 200, "AAPL", px(10100) + 99);
+  b.execute(10, 40);
+  b.cancel(12, 50);
+  b.replace(12, 13, 120, px(10200));
+  b.execute(11, 10);
+  b.remove(13);
+  b.add(14, 'B', 1, "AAPL", px(100000));
+  b.add(15, 'B', 100000, "AAPL", px(9900));
+
+  tb::itch::ConverterOptions opts;
+  opts.symbol = "AAPL";
+  tb::itch::Converter c{opts};
+  const std::vector<tb::Command> cmds = convert(c, b);
+  ASSERT_EQ(cmds.size(), 7);
+
+  EXPECT_EQ(cmds[0].opcode, tb::Opcode::BuyLimit);
+  EXPECT_EQ(cmds[0].uid, 0);
+  EXPECT_EQ(cmds[0].quantity, 100);
+  EXPECT_EQ(cmds[0].price, tb::bcd::from_cents(10000));
+
+  // Sub-cent digits truncated.
+  EXPECT_EQ(cmds[1].opcode, tb::Opcode::SellLimit);
+  EXPECT_EQ(cmds[1].uid, 1);
+  EXPECT_EQ(cmds[1].price, tb::bcd::from_cents(10100));
+
+  // Execution against the bid as an IOC sell.
+  EXPECT_EQ(cmds[2].opcode, tb::Opcode::SellMarket);
+  EXPECT_EQ(cmds[2].tif, tb::Tif::ImmediateOrCancel);
+  EXPECT_EQ(cmds[2].quantity, 40);
+
+  // Partial cancel; reduced in place.
+  EXPECT_EQ(cmds[3].opcode, tb::Opcode::Replace);
+  EXPECT_EQ(cmds[3].uid1, 1);
+  EXPECT_EQ(cmds[3].quantity, 150);
+  EXPECT_EQ(cmds[3].price, tb::bcd::from_cents(10100));
+
+  // Replace; new reference aliases the original uid.
+  EXPECT_EQ(cmds[4].opcode, tb::Opcode::Replace);
+  EXPECT_EQ(cmds[4].uid1, 1);
+  EXPECT_EQ(cmds[4].quantity, 120);
+  EXPECT_EQ(cmds[4].price, tb::bcd::from_cents(10200));
+
+  EXPECT_EQ(cmds[5].opcode, tb::Opcode::Cancel);
+  EXPECT_EQ(cmds[5].uid1, 1);
+
+  // Quantity saturated.
+  EXPECT_EQ(cmds[6].opcode, tb::Opcode::BuyLimit);
+  EXPECT_EQ(cmds[6].quantity, 0xFFFF);
+
+  const tb::itch::ConverterStats& s = c.stats();
+  EXPECT_EQ(s.msg_n, 11);
+  EXPECT_EQ(s.filtered_n, 2);
+  EXPECT_EQ(s.unknown_n, 1);
+  EXPECT_EQ(s.price_range_n, 1);
+  EXPECT_EQ(s.clamped_n, 1);
+  EXPECT_EQ(s.cmd_n, 7);
+  EXPECT_EQ(c.order_n(), 2);
+}
+
+TEST(TbItch, Amend) {
+  Builder b;
+  b.add(1, 'S', 100, "AAPL", px(10000));
+  b.execute(1, 30);
+  b.execute(1, 70);
+  b.execute(1, 10);
+
+  tb::itch::ConverterOptions opts;
+  opts.symbol = "AAPL";
+  opts.exec = tb::itch::Exec::Amend;
+  tb::itch::Converter c{opts};
+  const std::vector<tb::Command> cmds = convert(c, b);
+  ASSERT_EQ(cmds.size(), 3);
+  EXPECT_EQ(cmds[1].opcode, tb::Opcode::Replace);
+  EXPECT_EQ(cmds[1].uid1, 0);
+  EXPECT_EQ(cmds[1].quantity, 70);
+  EXPECT_EQ(cmds[2].opcode, tb::Opcode::Cancel);
+  EXPECT_EQ(cmds[2].uid1, 0);
+  EXPECT_EQ(c.stats().unknown_n, 1);
+  EXPECT_EQ(c.order_n(), 0);
+}
+
+TEST(TbItch, Trace) {
+  Builder b;
+  b.add(1, 'B', 100, "AAPL", px(10000));
+  b.add(2, 'S', 100, "AAPL", px(10050));
+  b.cancel(1, 25);
+  b.execute(2, 100);
+  const std::string path = b.write();
+  ASSERT_FALSE(path.empty());
+  const std::string trace = path + ".trace";
+
+  tb::itch::ConverterOptions opts;
+  opts.symbol = "AAPL";
+  tb::itch::Converter c0{opts};
+  ASSERT_TRUE(tb::itch::replay(path, c0, trace));
+
+  tb::itch::Converter c1{opts};
+  const std::vector<tb::Command> expected = convert(c1, b);
+  std::vector<tb::Command> actual;
+  ASSERT_TRUE(tb::itch::load(trace, actual));
+  ASSERT_EQ(actual.size(), expected.size());
+  for (std::size_t i = 0; i < actual.size(); i++) {
+    EXPECT_EQ(actual[i].opcode, expected[i].opcode);
+    EXPECT_EQ(actual[i].tif, expected[i].tif);
+    EXPECT_EQ(actual[i].uid, expected[i].uid);
+    EXPECT_EQ(actual[i].uid1, expected[i].uid1);
+    EXPECT_EQ(actual[i].quantity, expected[i].quantity);
+    EXPECT_EQ(actual[i].price, expected[i].price);
+  }
+  std::remove(trace.c_str());
+  std::remove(path.c_str());
+}
+
+TEST(TbItch, Replay) {
+  // Book built on both sides, partially executed, amended and retired.
+  Builder b;
+  for (std::uint32_t i = 0; i < 8; i++) {
+    b.add(100 + i, 'B', 100 + i, "AAPL", px(10000 - 5 * i));
+    b.add(200 + i, 'S', 100 + i, "AAPL", px(10010 + 5 * i));
+  }
+  b.execute(100, 60);
+  b.execute(200, 100);
+  b.cancel(101, 1);
+  b.replace(102, 302, 50, px(10005));
+  b.execute(302, 50);
+  b.remove(203);
+  const std::string path = b.write();
+  ASSERT_FALSE(path.empty());
+
+  tb::itch::ConverterOptions opts;
+  opts.symbol = "AAPL";
+  tb::itch::Converter c{opts};
+  tb::TB tb;
+  ASSERT_TRUE(tb::itch::replay(path, c, tb));
+  tb.run();
+  std::remove(path.c_str());
+
+  EXPECT_EQ(tb.throughput().cmd_n, c.stats().cmd_n);
+  EXPECT_EQ(tb.throughput().trade_n, 3);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,313 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "gtest/gtest.h"
+#include "journal.h"
+#include <unistd.h>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<tb::Command> generate(std::size_t n) {
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::QryBidAsk, 4);
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::PopTopBid, 3);
+  bg.push_back(tb::Opcode::PopTopAsk, 3);
+  bg.push_back(tb::Opcode::Cancel, 3);
+  bg.push_back(tb::Opcode::BuyMarket, 1);
+  bg.push_back(tb::Opcode::SellMarket, 1);
+  bg.push_back(tb::Opcode::Replace, 2);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+  const std::deque<tb::Command> d = gen.generate(n);
+  return std::vector<tb::Command>(d.begin(), d.end());
+}
+
+std::string dump(const tb::Model& m) {
+  std::stringstream ss;
+  m.dump(ss);
+  return ss.str();
+}
+
+std::string journal_path() {
+  return "/tmp/tb_journal." + std::to_string(::getpid());
+}
+
+} // namespace
+
+TEST(TbJournal, Record) {
+  tb::Command cmd;
+  cmd.valid = true;
+  cmd.opcode = tb::Opcode::SellLimit;
+  cmd.uid = 0x12345678;
+  cmd.quantity = 100;
+  cmd.price = 0x10050;
+  cmd.was_cn = true;
+
+  tb::journal::Record r;
+  tb::journal::encode(7, cmd, r);
+  std::uint64_t seq = 0;
+  tb::Command actual;
+  ASSERT_TRUE(tb::journal::decode(r, seq, actual));
+  EXPECT_EQ(seq, 7);
+  EXPECT_EQ(actual.opcode, cmd.opcode);
+  EXPECT_EQ(actual.uid, cmd.uid);
+  EXPECT_EQ(actual.quantity, cmd.quantity);
+  EXPECT_EQ(actual.price, cmd.price);
+  EXPECT_TRUE(actual.was_cn);
+
+  // Corruption is detected.
+  r.b[20] ^= std::byte{0x1};
+  EXPECT_FALSE(tb::journal::decode(r, seq, actual));
+}
+
+TEST(TbJournal, Recover) {
+  const std::vector<tb::Command> cmds = generate(10000);
+  tb::journal::JournalOptions opts;
+  opts.path = journal_path();
+  ::unlink(opts.path.c_str());
+
+  tb::Model expected(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  {
+    tb::journal::Journal j{opts};
+    ASSERT_TRUE(j.ok());
+    std::uint64_t seq = 0;
+    for (const tb::Command& cmd : cmds) {
+      seq = j.append(cmd);
+      expected.apply(cmd);
+    }
+    EXPECT_EQ(seq, cmds.size());
+    EXPECT_TRUE(j.sync(seq));
+    j.close();
+    EXPECT_EQ(j.stats().records, cmds.size());
+    EXPECT_LE(j.stats().commits, cmds.size());
+  }
+
+  tb::Model actual(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  tb::journal::RecoveryStats stats;
+  ASSERT_TRUE(tb::journal::recover(opts.path, actual, stats));
+  EXPECT_EQ(stats.records, cmds.size());
+  EXPECT_EQ(stats.torn_bytes, 0);
+  EXPECT_EQ(stats.seq, cmds.size() + 1);
+  EXPECT_EQ(dump(actual), dump(expected));
+  EXPECT_EQ(actual.stats(), expected.stats());
+  ::unlink(opts.path.c_str());
+}
+
+TEST(TbJournal, TornTail) {
+  const std::vector<tb::Command> cmds = generate(1000);
+  tb::journal::JournalOptions opts;
+  opts.path = journal_path();
+  ::unlink(opts.path.c_str());
+  {
+    tb::journal::Journal j{opts};
+    for (std::size_t i = 0; i < 600; i++) j.append(cmds[i]);
+  }
+  {
+    // Partially written record.
+    std::FILE* f = std::fopen(opts.path.c_str(), "ab");
+    ASSERT_NE(f, nullptr);
+    const char torn[20] = {1, 2, 3};
+    std::fwrite(torn, sizeof(torn), 1, f);
+    std::fclose(f);
+  }
+  tb::Model m0(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  tb::journal::RecoveryStats stats;
+  ASSERT_TRUE(tb::journal::recover(opts.path, m0, stats));
+  EXPECT_EQ(stats.records, 600);
+  EXPECT_EQ(stats.torn_bytes, 20);
+
+  // Journal resumed from the point of recovery.
+  opts.seq = stats.seq;
+  {
+    tb::journal::Journal j{opts};
+    ASSERT_TRUE(j.ok());
+    for (std::size_t i = 600; i < cmds.size(); i++) j.append(cmds[i]);
+  }
+  tb::Model expected(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  for (const tb::Command& cmd : cmds) expected.apply(cmd);
+  tb::Model m1(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  ASSERT_TRUE(tb::journal::recover(opts.path, m1, stats));
+  EXPECT_EQ(stats.records, cmds.size());
+  EXPECT_EQ(stats.torn_bytes, 0);
+  EXPECT_EQ(dump(m1), dump(expected));
+  ::unlink(opts.path.c_str());
+}
+
+TEST(TbJournal, Reopen) {
+  const std::vector<tb::Command> cmds = generate(1000);
+  tb::journal::JournalOptions opts;
+  opts.path = journal_path();
+  ::unlink(opts.path.c_str());
+  {
+    tb::journal::Journal j{opts};
+    ASSERT_TRUE(j.ok());
+    for (std::size_t i = 0; i < 600; i++) j.append(cmds[i]);
+  }
+
+  // Reopened with default options; appends continue the sequence.
+  {
+    tb::journal::Journal j{opts};
+    ASSERT_TRUE(j.ok());
+    EXPECT_EQ(j.durable(), 600);
+    std::uint64_t seq = 0;
+    for (std::size_t i = 600; i < cmds.size(); i++) seq = j.append(cmds[i]);
+    EXPECT_EQ(seq, cmds.size());
+    EXPECT_TRUE(j.sync(seq));
+  }
+
+  // A sequence number which does not follow the journal is refused.
+  opts.seq = 1;
+  {
+    tb::journal::Journal j{opts};
+    EXPECT_FALSE(j.ok());
+  }
+
+  tb::Model expected(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  for (const tb::Command& cmd : cmds) expected.apply(cmd);
+  tb::Model m(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  tb::journal::RecoveryStats stats;
+  ASSERT_TRUE(tb::journal::recover(opts.path, m, stats));
+  EXPECT_EQ(stats.records, cmds.size());
+  EXPECT_EQ(stats.torn_bytes, 0);
+  EXPECT_EQ(stats.seq, cmds.size() + 1);
+  EXPECT_EQ(dump(m), dump(expected));
+  ::unlink(opts.path.c_str());
+}
+
+TEST(TbJournal, ZeroTail) {
+  const std::vector<tb::Command> cmds = generate(100);
+  tb::journal::JournalOptions opts;
+  opts.path = journal_path();
+  ::unlink(opts.path.c_str());
+  {
+    tb::journal::Journal j{opts};
+    for (const tb::Command& cmd : cmds) j.append(cmd);
+  }
+  {
+    // Whole, but zero-filled, record (as a page not written back).
+    std::FILE* f = std::fopen(opts.path.c_str(), "ab");
+    ASSERT_NE(f, nullptr);
+    const char zero[tb::journal::RECORD_BYTES] = {};
+    std::fwrite(zero, sizeof(zero), 1, f);
+    std::fclose(f);
+  }
+  {
+    tb::journal::Journal j{opts};
+    EXPECT_FALSE(j.ok());
+  }
+  tb::Model m(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  tb::journal::RecoveryStats stats;
+  ASSERT_TRUE(tb::journal::recover(opts.path, m, stats));
+  EXPECT_EQ(stats.records, cmds.size());
+  EXPECT_EQ(stats.torn_bytes, tb::journal::RECORD_BYTES);
+
+  // Resumed once recovered.
+  tb::journal::Journal j{opts};
+  EXPECT_TRUE(j.ok());
+  j.close();
+  ::unlink(opts.path.c_str());
+}
+
+TEST(TbJournal, TornTailUnrecovered) {
+  const std::vector<tb::Command> cmds = generate(1000);
+  tb::journal::JournalOptions opts;
+  opts.path = journal_path();
+  ::unlink(opts.path.c_str());
+  {
+    tb::journal::Journal j{opts};
+    for (std::size_t i = 0; i < 600; i++) j.append(cmds[i]);
+  }
+  {
+    // Partially written record.
+    std::FILE* f = std::fopen(opts.path.c_str(), "ab");
+    ASSERT_NE(f, nullptr);
+    const char torn[20] = {1, 2, 3};
+    std::fwrite(torn, sizeof(torn), 1, f);
+    std::fclose(f);
+  }
+
+  // Reopened without recovery; appends, in excess of the queue capacity,
+  // neither block nor are acknowledged.
+  opts.seq = 601;
+  opts.queue_n = 64;
+  std::uint64_t acked = 600;
+  {
+    tb::journal::Journal j{opts};
+    EXPECT_FALSE(j.ok());
+    for (std::size_t i = 600; i < cmds.size(); i++) {
+      const std::uint64_t seq = j.append(cmds[i]);
+      if (j.sync(seq)) acked = seq;
+    }
+    j.close();
+    EXPECT_EQ(j.stats().discards, cmds.size() - 600);
+  }
+  EXPECT_EQ(acked, 600);
+
+  // No acknowledged record is lost.
+  tb::Model expected(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  for (std::size_t i = 0; i < acked; i++) expected.apply(cmds[i]);
+  tb::Model m(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  tb::journal::RecoveryStats stats;
+  ASSERT_TRUE(tb::journal::recover(opts.path, m, stats));
+  EXPECT_EQ(stats.records, acked);
+  EXPECT_EQ(stats.torn_bytes, 20);
+  EXPECT_EQ(stats.seq, acked + 1);
+  EXPECT_EQ(dump(m), dump(expected));
+  ::unlink(opts.path.c_str());
+}
+
+TEST(TbJournal, NotJournal) {
+  const std::string path = journal_path();
+  ::unlink(path.c_str());
+  tb::Model m(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  tb::journal::RecoveryStats stats;
+  // Absent journal is empty.
+  EXPECT_TRUE(tb::journal::recover(path, m, stats));
+  EXPECT_EQ(stats.records, 0);
+
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  ASSERT_NE(f, nullptr);
+  std::fputs("not a journal, not a journal", f);
+  std::fclose(f);
+  EXPECT_FALSE(tb::journal::recover(path, m, stats));
+
+  tb::journal::JournalOptions opts;
+  opts.path = path;
+  tb::journal::Journal j{opts};
+  EXPECT_FALSE(j.ok());
+  ::unlink(path.c_str());
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
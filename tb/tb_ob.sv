@@ -29,6 +29,7 @@
 `timescale 1ns/1ps
 
 `include "ob_pkg.vh"
+`include "cfg_pkg.vh"
 
 module tb_ob (
 
@@ -36,6 +37,7 @@ module tb_ob (
   // Command Interface
     input                                         cmd_vld_r
   , input ob_pkg::opcode_t                        cmd_opcode_r
+  , input ob_pkg::tif_t                           cmd_tif_r
   , input ob_pkg::uid_t                           cmd_uid_r
   , input ob_pkg::quantity_t                      cmd_quantity_r
   , input bcd_pkg::price_t                        cmd_price_r
@@ -46,28 +48,76 @@ module tb_ob (
 
   // ======================================================================== //
   // Response Interface
+  //
+  // Response lanes are presented as packed arrays with each field padded to
+  // 32b such that lane 'i' of a field is word 'i' of the associated signal.
+  //
   , input                                         rsp_accept
   //
-  , output logic                                  rsp_vld
-  , output ob_pkg::uid_t                          rsp_uid
-  , output ob_pkg::status_t                       rsp_status
+  , output logic [31:0]                           rsp_vld
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_uid
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_status
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_ts_accept
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_ts_emit
 
   // Query Bid/Ask:
-  , output bcd_pkg::price_t                       rsp_qry_bid
-  , output bcd_pkg::price_t                       rsp_qry_ask
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_qry_bid
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_qry_ask
 
   // Pop top Bid/Ask:
-  , output bcd_pkg::price_t                       rsp_pop_price
-  , output ob_pkg::quantity_t                     rsp_pop_quantity
-  , output ob_pkg::uid_t                          rsp_pop_uid
-
-  // Trade:
-  , output ob_pkg::uid_t                          rsp_trade_bid_uid
-  , output ob_pkg::uid_t                          rsp_trade_ask_uid
-  , output ob_pkg::quantity_t                     rsp_trade_quantity
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_pop_price
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_pop_quantity
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_pop_uid
 
   // Qry:
-  , output ob_pkg::accum_quantity_t               rsp_qry_accum
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_qry_accum
+
+  // Depth:
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_depth_last
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_depth_level
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_depth_price
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_depth_accum
+
+  // Stats:
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_stats_last
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_stats_id
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_stats_value
+
+  // Snapshot:
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_snap_last
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_snap_tbl
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_snap_ext
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_snap_price
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_snap_quantity
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] rsp_snap_uid
+
+  // ======================================================================== //
+  // Trade Interface
+  //
+  // Trade lanes are presented as per the response lanes.
+  //
+  , input                                         trd_accept
+  //
+  , output logic [31:0]                           trd_vld
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] trd_uid
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] trd_status
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] trd_ts_accept
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] trd_ts_emit
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] trd_bid_uid
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] trd_ask_uid
+  , output logic [cfg_pkg::RSP_LANES_N - 1:0][31:0] trd_quantity
+
+  // ======================================================================== //
+  // Market Data (Top-of-Book) Interface
+  , input                                         md_accept
+  //
+  , output logic                                  md_vld_r
+  , output logic                                  md_bid_vld
+  , output bcd_pkg::price_t                       md_bid_price
+  , output ob_pkg::quantity_t                     md_bid_quantity
+  , output logic                                  md_ask_vld
+  , output bcd_pkg::price_t                       md_ask_price
+  , output ob_pkg::quantity_t                     md_ask_quantity
 
   // ======================================================================== //
   // TB support
@@ -77,6 +127,10 @@ module tb_ob (
   , output ob_pkg::uid_t                          tb_cmdl_uid
   , output logic                                  tb_cn_mtr_vld
   , output ob_pkg::uid_t                          tb_cn_mtr_uid
+  , output logic [63:0]                           tb_ingress_byp_n
+  // Widths of the packed command/response structures (see wire.h).
+  , output logic [31:0]                           tb_cmd_w
+  , output logic [31:0]                           tb_rsp_w
 
   // ======================================================================== //
   // Clk/Reset
@@ -91,6 +145,13 @@ module tb_ob (
   always_ff @(posedge clk)
     tb_cycle += 'b1;
 
+  // Count of commands forwarded through the ingress queue bypass.
+  initial tb_ingress_byp_n  = '0;
+
+  always_ff @(posedge clk)
+    if (u_ob.ingress_byp)
+      tb_ingress_byp_n += 'b1;
+
   // ------------------------------------------------------------------------ //
   //
   ob_pkg::cmd_t                         cmd_r;
@@ -99,6 +160,7 @@ module tb_ob (
 
     cmd_r          = '0;
     cmd_r.opcode   = cmd_opcode_r;
+    cmd_r.tif      = cmd_tif_r;
     cmd_r.uid      = cmd_uid_r;
     cmd_r.quantity = cmd_quantity_r;
     cmd_r.price    = cmd_price_r;
@@ -109,32 +171,102 @@ module tb_ob (
 
   // ------------------------------------------------------------------------ //
   //
-  ob_pkg::rsp_t                         rsp;
+  logic [cfg_pkg::RSP_LANES_N - 1:0]    rsp_lane_vld;
+  ob_pkg::rsp_t [cfg_pkg::RSP_LANES_N - 1:0] rsp;
 
   always_comb begin : rsp_PROC
 
-    //
-    rsp_uid            = rsp.uid;
-    rsp_status         = rsp.status;
+    rsp_vld                = '0;
+    rsp_vld [cfg_pkg::RSP_LANES_N - 1:0] = rsp_lane_vld;
+
+    for (int i = 0; i < cfg_pkg::RSP_LANES_N; i++) begin
+      //
+      rsp_uid [i]            = 32'(rsp [i].uid);
+      rsp_status [i]         = 32'(rsp [i].status);
+`ifdef OB_CFG_RSP_TIMESTAMP_EN
+      rsp_ts_accept [i]      = 32'(rsp [i].ts_accept);
+      rsp_ts_emit [i]        = 32'(rsp [i].ts_emit);
+`else
+      rsp_ts_accept [i]      = '0;
+      rsp_ts_emit [i]        = '0;
+`endif
+
+      // Query Bid/Ask:
+      rsp_qry_bid [i]        = 32'(rsp [i].result.qrybidask.bid);
+      rsp_qry_ask [i]        = 32'(rsp [i].result.qrybidask.ask);
+
+      // Pop top Bid/Ask:
+      rsp_pop_price [i]      = 32'(rsp [i].result.poptop.price);
+      rsp_pop_quantity [i]   = 32'(rsp [i].result.poptop.quantity);
+      rsp_pop_uid [i]        = 32'(rsp [i].result.poptop.uid);
+
+      // Qry accumulation
+      rsp_qry_accum [i]      = 32'(rsp [i].result.qry.accum);
+
+      // Depth
+      rsp_depth_last [i]     = 32'(rsp [i].result.depth.last);
+      rsp_depth_level [i]    = 32'(rsp [i].result.depth.level);
+      rsp_depth_price [i]    = 32'(rsp [i].result.depth.price);
+      rsp_depth_accum [i]    = 32'(rsp [i].result.depth.accum);
+
+      // Stats
+      rsp_stats_last [i]     = 32'(rsp [i].result.stats.last);
+      rsp_stats_id [i]       = 32'(rsp [i].result.stats.id);
+      rsp_stats_value [i]    = 32'(rsp [i].result.stats.value);
+
+      // Snapshot
+      rsp_snap_last [i]      = 32'(rsp [i].result.snapshot.last);
+      rsp_snap_tbl [i]       = 32'(rsp [i].result.snapshot.tbl);
+      rsp_snap_ext [i]       = 32'(rsp [i].result.snapshot.ext);
+      rsp_snap_price [i]     = 32'(rsp [i].result.snapshot.price);
+      rsp_snap_quantity [i]  = 32'(rsp [i].result.snapshot.quantity);
+      rsp_snap_uid [i]       = 32'(rsp [i].result.snapshot.uid);
+    end
+
+  end // block: rsp_PROC
 
-    // Query Bid/Ask:
-    rsp_qry_bid        = rsp.result.qrybidask.bid;
-    rsp_qry_ask        = rsp.result.qrybidask.ask;
+  // ------------------------------------------------------------------------ //
+  //
+  logic [cfg_pkg::RSP_LANES_N - 1:0]    trd_lane_vld;
+  ob_pkg::rsp_t [cfg_pkg::RSP_LANES_N - 1:0] trd;
+
+  always_comb begin : trd_PROC
+
+    trd_vld                = '0;
+    trd_vld [cfg_pkg::RSP_LANES_N - 1:0] = trd_lane_vld;
+
+    for (int i = 0; i < cfg_pkg::RSP_LANES_N; i++) begin
+      //
+      trd_uid [i]            = 32'(trd [i].uid);
+      trd_status [i]         = 32'(trd [i].status);
+`ifdef OB_CFG_RSP_TIMESTAMP_EN
+      trd_ts_accept [i]      = 32'(trd [i].ts_accept);
+      trd_ts_emit [i]        = 32'(trd [i].ts_emit);
+`else
+      trd_ts_accept [i]      = '0;
+      trd_ts_emit [i]        = '0;
+`endif
+      trd_bid_uid [i]        = 32'(trd [i].result.trade.bid_uid);
+      trd_ask_uid [i]        = 32'(trd [i].result.trade.ask_uid);
+      trd_quantity [i]       = 32'(trd [i].result.trade.quantity);
+    end
+
+  end // block: trd_PROC
 
-    // Pop top Bid/Ask:
-    rsp_pop_price      = rsp.result.poptop.price;
-    rsp_pop_quantity   = rsp.result.poptop.quantity;
-    rsp_pop_uid        = rsp.result.poptop.uid;
+  // ------------------------------------------------------------------------ //
+  //
+  ob_pkg::md_t                          md_r;
 
-    // Trade:
-    rsp_trade_bid_uid  = rsp.result.trade.bid_uid;
-    rsp_trade_ask_uid  = rsp.result.trade.ask_uid;
-    rsp_trade_quantity = rsp.result.trade.quantity;
+  always_comb begin : md_PROC
 
-    // Qry accumulation
-    rsp_qry_accum      = rsp.result.qry.accum;
+    md_bid_vld      = md_r.bid_vld;
+    md_bid_price    = md_r.bid_price;
+    md_bid_quantity = md_r.bid_quantity;
+    md_ask_vld      = md_r.ask_vld;
+    md_ask_price    = md_r.ask_price;
+    md_ask_quantity = md_r.ask_quantity;
 
-  end // block: rsp_PROC
+  end // block: md_PROC
 
   // ------------------------------------------------------------------------ //
   //
@@ -145,9 +277,17 @@ module tb_ob (
     , .cmd_full_r             (cmd_full_r              )
     //
     , .rsp_accept             (rsp_accept              )
-    , .rsp_vld                (rsp_vld                 )
+    , .rsp_vld                (rsp_lane_vld            )
     , .rsp                    (rsp                     )
     //
+    , .trd_accept             (trd_accept              )
+    , .trd_vld                (trd_lane_vld            )
+    , .trd                    (trd                     )
+    //
+    , .md_accept              (md_accept               )
+    , .md_vld_r               (md_vld_r                )
+    , .md_r                   (md_r                    )
+    //
     , .clk                    (clk                     )
     , .rst                    (rst                     )
   );
@@ -164,6 +304,10 @@ module tb_ob (
     tb_cn_mtr_vld  = u_ob.u_ob_cn_table.mtr_en;
     tb_cn_mtr_uid  = u_ob.u_ob_cn_table.mtr_w.uid;
 
+    // Packed structure widths
+    tb_cmd_w       = $bits(ob_pkg::cmd_t);
+    tb_rsp_w       = $bits(ob_pkg::rsp_t);
+
   end // block: tb_PROC
 
 endmodule // ob
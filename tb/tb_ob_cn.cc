@@ -27,6 +27,7 @@
 
 #include "gtest/gtest.h"
 #include "tb.h"
+#include <algorithm>
 
 
 const std::size_t LONG_N = (1 << 15);
@@ -102,6 +103,10 @@ TEST(TbObCn, ConditionalReject) {
 
   // Run simulation
   tb.run();
+
+  // Commands in excess of the table capacity are rejected.
+  EXPECT_EQ(tb.cn_issue_n(), 100u);
+  EXPECT_EQ(tb.cn_reject_n(), 100u - std::min<std::size_t>(100, tb::CN_DEPTH_N));
 }
 TEST(TbObCn, ConditionalBuyStopLoss1) {
   tb::Options opts;
@@ -391,6 +396,55 @@ TEST(TbObCn, ConditionalRegressLmMkN) {
   tb.run();
 }
 
+TEST(TbObCn, ConditionalRegressStopHeavy) {
+  // Initialization randomisation seed.
+  tb::Random::init(1);
+
+  // Stop-order heavy flow; the conditional tables are occupied for
+  // prolonged periods and commands are rejected once a table has filled.
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::BuyMarket, 1);
+  bg.push_back(tb::Opcode::SellMarket, 1);
+  bg.push_back(tb::Opcode::BuyStopLoss, 5);
+  bg.push_back(tb::Opcode::SellStopLoss, 5);
+  bg.push_back(tb::Opcode::BuyStopLimit, 5);
+  bg.push_back(tb::Opcode::SellStopLimit, 5);
+  bg.push_back(tb::Opcode::Cancel, 2);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+
+  tb::Options opts;
+  tb::TB tb{opts};
+  // Conditional commands issued to each side.
+  std::size_t buy_n = 0, sell_n = 0;
+  for (const tb::Command& cmd : gen.generate(LONG_N)) {
+    switch (cmd.opcode) {
+      case tb::Opcode::BuyStopLoss:
+      case tb::Opcode::BuyStopLimit: ++buy_n; break;
+      case tb::Opcode::SellStopLoss:
+      case tb::Opcode::SellStopLimit: ++sell_n; break;
+      default: break;
+    }
+    tb.push_back(cmd);
+  }
+  // Run simulation
+  tb.run();
+
+  // A conditional command is rejected only once the table of its side has
+  // filled, therefore no fewer than CN_DEPTH_N commands per side are
+  // accepted; entries are otherwise released on maturity or cancellation.
+  ASSERT_EQ(tb.cn_issue_n(), buy_n + sell_n);
+  auto excess = [](std::size_t n) {
+    return (n > tb::CN_DEPTH_N) ? (n - tb::CN_DEPTH_N) : 0;
+  };
+  const double reject_rate =
+      static_cast<double>(tb.cn_reject_n()) / tb.cn_issue_n();
+  EXPECT_LE(reject_rate,
+            static_cast<double>(excess(buy_n) + excess(sell_n)) /
+            tb.cn_issue_n());
+}
+
 int main (int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,186 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "gtest/gtest.h"
+#include "gtest/gtest-spi.h"
+#include "tb.h"
+#include <string>
+
+namespace {
+
+tb::Bag<vluint8_t> opcodes() {
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::QryBidAsk, 4);
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::PopTopBid, 3);
+  bg.push_back(tb::Opcode::PopTopAsk, 3);
+  bg.push_back(tb::Opcode::Cancel, 1);
+  bg.push_back(tb::Opcode::QryTblAskLe, 1);
+  bg.push_back(tb::Opcode::QryTblBidGe, 1);
+  bg.push_back(tb::Opcode::QryDepthBid, 1);
+  bg.push_back(tb::Opcode::QryDepthAsk, 1);
+  bg.push_back(tb::Opcode::MassCancel, 1);
+  bg.push_back(tb::Opcode::QryStats, 1);
+  bg.push_back(tb::Opcode::BuyMarket, 1);
+  bg.push_back(tb::Opcode::SellMarket, 1);
+  bg.push_back(tb::Opcode::BuyStopLoss, 1);
+  bg.push_back(tb::Opcode::SellStopLoss, 1);
+  bg.push_back(tb::Opcode::BuyStopLimit, 1);
+  bg.push_back(tb::Opcode::SellStopLimit, 1);
+  return bg;
+}
+
+tb::Response make_rsp(vluint32_t uid, vluint8_t status) {
+  tb::Response rsp;
+  rsp.valid = true;
+  rsp.uid = uid;
+  rsp.status = status;
+  return rsp;
+}
+
+} // namespace
+
+TEST(TbObDigest, Fold) {
+  tb::Command cmd;
+  cmd.opcode = tb::Opcode::QryTblBidGe;
+  tb::Response a = make_rsp(1, tb::Status::Okay);
+  a.result.qry.accum = 10;
+  tb::Response b = make_rsp(2, tb::Status::Okay);
+  b.result.qry.accum = 20;
+
+  // Order sensitive.
+  tb::Digest ab, ba;
+  ab.add(cmd, a);
+  ab.add(cmd, b);
+  ba.add(cmd, b);
+  ba.add(cmd, a);
+  EXPECT_EQ(ab.n(), 2);
+  EXPECT_NE(ab, ba);
+
+  // Fields compared by the opcode are folded...
+  tb::Digest x, y;
+  x.add(cmd, a);
+  a.result.qry.accum++;
+  y.add(cmd, a);
+  EXPECT_NE(x, y);
+
+  // ... whereas those not predicted are not.
+  tb::Digest u, v;
+  u.add(cmd, a);
+  a.ts_accept = 100;
+  a.ts_emit = 200;
+  v.add(cmd, a);
+  EXPECT_EQ(u, v);
+
+  cmd.opcode = tb::Opcode::QryStats;
+  tb::Response s = make_rsp(3, tb::Status::Okay);
+  s.result.stats.id = tb::stats::EgressStall;
+  s.result.stats.value = 1;
+  tb::Digest p, q;
+  p.add(cmd, s);
+  s.result.stats.value = 2;
+  q.add(cmd, s);
+  EXPECT_EQ(p, q);
+}
+
+TEST(TbObDigest, Regress) {
+  tb::Random::init(1);
+  tb::StimulusGenerator gen(opcodes(), 100.0, 10.0);
+  const std::deque<tb::Command> cmds = gen.generate(1 << 16);
+
+  // Full checking.
+  tb::TB full;
+  for (const tb::Command& cmd : cmds) full.push_back(cmd);
+  full.run();
+
+  // Digest checking; a checkpoint per window, and one upon completion.
+  tb::Options opts;
+  opts.digest_window = 1024;
+  tb::TB tb{opts};
+  for (const tb::Command& cmd : cmds) tb.push_back(cmd);
+  tb.run();
+
+  const tb::DigestStats& ds = tb.digest();
+  EXPECT_EQ(ds.checkpoint_n, cmds.size() / opts.digest_window + 1);
+  EXPECT_EQ(ds.mismatch_n, 0);
+  EXPECT_EQ(ds.replay_n, 0);
+  EXPECT_EQ(tb.throughput().cmd_n, full.throughput().cmd_n);
+}
+
+TEST(TbObDigest, Mismatch) {
+  tb::Random::init(1);
+  tb::StimulusGenerator gen(opcodes(), 100.0, 10.0);
+  const std::deque<tb::Command> cmds = gen.generate(1 << 14);
+
+  // Corrupt the response to a query in the third window.
+  tb::Options opts;
+  opts.digest_window = 1024;
+  const std::size_t k = 2;
+  std::size_t i = k * opts.digest_window;
+  while (cmds[i].opcode != tb::Opcode::QryBidAsk) ++i;
+  ASSERT_LT(i, (k + 1) * opts.digest_window);
+  const vluint32_t corrupt_uid = cmds[i].uid;
+
+  tb::TB tb{opts};
+  tb.set_rsp_filter([=](tb::Response& rsp) {
+    if (rsp.uid == corrupt_uid) rsp.status ^= 0x1;
+  });
+  for (const tb::Command& cmd : cmds) tb.push_back(cmd);
+  // Failures are expected; retain them for inspection.
+  ::testing::TestPartResultArray failures;
+  {
+    ::testing::ScopedFakeTestPartResultReporter reporter(
+        ::testing::ScopedFakeTestPartResultReporter::INTERCEPT_ALL_THREADS,
+        &failures);
+    tb.run();
+  }
+
+  // The state of the preceding checkpoint is restored, and the failing
+  // window replayed.
+  tb::Model model(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  for (std::size_t j = 0; j < k * opts.digest_window; j++) {
+    model.apply(cmds[j]);
+  }
+  const tb::DigestStats& ds = tb.digest();
+  EXPECT_EQ(ds.checkpoint_n, k);
+  EXPECT_EQ(ds.mismatch_n, 1);
+  EXPECT_EQ(ds.replay_n, model.snapshot().size() + opts.digest_window);
+
+  // The replay reports the corrupted response.
+  const std::string uid = "Uid: " + std::to_string(corrupt_uid);
+  bool reported = false;
+  for (int j = 0; j < failures.size(); j++) {
+    const std::string msg = failures.GetTestPartResult(j).message();
+    reported = reported || (msg.find(uid) != std::string::npos);
+  }
+  EXPECT_TRUE(reported);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
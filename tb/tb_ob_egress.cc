@@ -0,0 +1,124 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "cmd.h"
+
+const std::size_t LONG_N = (1 << 15);
+
+namespace {
+
+// Number of resting asks swept by a single bid.
+const std::size_t SWEEP_N = 8;
+
+// Resting asks swept by a single bid, followed by a stream of acknowledged
+// commands.
+void push_sweep(tb::TB& tb) {
+  const char* asks[SWEEP_N] = {"100.00", "100.25", "100.50", "100.75",
+                               "101.00", "101.25", "101.50", "101.75"};
+  vluint32_t uid = 0;
+  for (const char* price : asks) {
+    tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, price, 10));
+  }
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "102.00",
+                              10 * SWEEP_N));
+  for (int i = 0; i < 32; i++) {
+    tb.push_back(tb::make_nop(uid++));
+  }
+}
+
+// Command (acknowledgement) latency of the sweep under 'opts'.
+tb::LatencyStats sweep_latency(const tb::Options& opts) {
+  tb::TB tb{opts};
+  push_sweep(tb);
+  tb.run();
+  EXPECT_EQ(tb.throughput().trade_n, SWEEP_N);
+  return tb.latency();
+}
+
+tb::Bag<vluint8_t> regress_bag() {
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::Nop, 1);
+  bg.push_back(tb::Opcode::QryBidAsk, 4);
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::PopTopBid, 3);
+  bg.push_back(tb::Opcode::PopTopAsk, 3);
+  bg.push_back(tb::Opcode::Cancel, 1);
+  bg.push_back(tb::Opcode::BuyMarket, 1);
+  bg.push_back(tb::Opcode::SellMarket, 1);
+  return bg;
+}
+
+} // namespace
+
+TEST(TbObEgress, TradeStalled) {
+  // Trades backpressured; acknowledgements continue to be emitted behind
+  // the stalled trades, therefore their latency is unaffected.
+  const tb::LatencyStats unthrottled = sweep_latency(tb::Options{});
+
+  tb::Options opts;
+  opts.trd_accept_n = 16;
+  const tb::LatencyStats throttled = sweep_latency(opts);
+
+  EXPECT_EQ(throttled.n, unthrottled.n);
+  EXPECT_EQ(throttled.min, unthrottled.min);
+  EXPECT_EQ(throttled.max, unthrottled.max);
+  EXPECT_EQ(throttled.sum, unthrottled.sum);
+}
+
+TEST(TbObEgress, AckStalled) {
+  // Acknowledgements backpressured; trades are received ahead of the
+  // acknowledgement of the command from which they originate.
+  tb::Options opts;
+  opts.rsp_accept_n = 16;
+  sweep_latency(opts);
+}
+
+TEST(TbObEgress, Regress) {
+  // Initialization randomisation seed.
+  tb::Random::init(1);
+
+  tb::StimulusGenerator gen(regress_bag(), 100.0, 10.0);
+
+  // Independent random backpressure on each channel.
+  tb::Options opts;
+  opts.rsp_accept_p = 0.5;
+  opts.trd_accept_p = 0.25;
+  tb::TB tb{opts};
+  for (const tb::Command& cmd : gen.generate(LONG_N)) {
+    tb.push_back(cmd);
+  }
+  // Run simulation
+  tb.run();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,120 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "cmd.h"
+
+TEST(TbObIngress, Idle) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  // Commands are issued to an idle engine.
+  for (vluint32_t uid = 0; uid < 16; uid++) {
+    tb.push_back(tb::make_nop(uid));
+    for (std::size_t i = 0; i < 8; i++) {
+      tb.push_back(tb::make_bubble());
+    }
+  }
+
+  // Run simulation.
+  tb.run();
+
+  const tb::LatencyStats& stats = tb.latency();
+  EXPECT_EQ(stats.n, 16u);
+  // Each command observes an idle engine, therefore latency is constant.
+  EXPECT_EQ(stats.min, stats.max);
+  // All commands are forwarded through the bypass (when enabled).
+  EXPECT_EQ(stats.bypassed, tb::INGRESS_BYPASS_EN ? stats.n : 0);
+}
+
+TEST(TbObIngress, Burst) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  // Back-to-back commands; all but the first are retained in the ingress
+  // queue whilst the controller is busy.
+  for (vluint32_t uid = 0; uid < 16; uid++) {
+    tb.push_back(tb::make_nop(uid));
+  }
+
+  // Run simulation.
+  tb.run();
+
+  const tb::LatencyStats& stats = tb.latency();
+  EXPECT_EQ(stats.n, 16u);
+  EXPECT_LT(stats.min, stats.max);
+  EXPECT_LT(stats.bypassed, stats.n);
+}
+
+TEST(TbObIngress, Regress) {
+  // Initialization randomisation seed.
+  tb::Random::init(1);
+
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::Nop, 1);
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::PopTopBid, 3);
+  bg.push_back(tb::Opcode::PopTopAsk, 3);
+  bg.push_back(tb::Opcode::Cancel, 1);
+  bg.push_back(tb::Opcode::BuyMarket, 1);
+  bg.push_back(tb::Opcode::SellMarket, 1);
+  bg.push_back(tb::Opcode::BuyStopLoss, 1);
+  bg.push_back(tb::Opcode::SellStopLoss, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+
+  tb::TB tb;
+  for (const tb::Command& cmd : gen.generate(1 << 12)) {
+    tb.push_back(cmd);
+    // Intersperse idle periods such that the bypass is exercised against
+    // a mixed population of commands.
+    if (tb::Random::uniform<int>(3, 0) == 0) {
+      tb.push_back(tb::make_bubble());
+      tb.push_back(tb::make_bubble());
+      tb.push_back(tb::make_bubble());
+    }
+  }
+
+  // Run simulation.
+  tb.run();
+
+  const tb::LatencyStats& stats = tb.latency();
+  if (tb::INGRESS_BYPASS_EN) {
+    // Idle periods are exercised through the bypass, and commands so
+    // forwarded observe lower latency than those retained in the queue.
+    EXPECT_GT(stats.bypassed, 0u);
+    EXPECT_LT(stats.bypassed, stats.n);
+    EXPECT_LT(stats.bypassed_mean(), stats.queued_mean());
+  } else {
+    EXPECT_EQ(stats.bypassed, 0u);
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
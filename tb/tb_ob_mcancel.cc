@@ -0,0 +1,164 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "cmd.h"
+
+const std::size_t LONG_N = (1 << 15);
+
+namespace {
+
+// Populate both sides of the book with non-crossing limit orders.
+void build_book(tb::TB& tb, vluint32_t& uid) {
+  const char* bids[] = {"99.00", "98.50", "99.50", "98.00", "99.00"};
+  for (const char* price : bids) {
+    tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, price, 10));
+  }
+  const char* asks[] = {"101.00", "100.50", "102.00", "101.00", "101.50"};
+  for (const char* price : asks) {
+    tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, price, 10));
+  }
+}
+
+} // namespace
+
+TEST(TbObMassCancel, Empty) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  tb.push_back(tb::make_mass_cancel(uid++, tb::mass_cancel::Bid |
+                                           tb::mass_cancel::Ask |
+                                           tb::mass_cancel::All));
+  tb.push_back(tb::make_nop(uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObMassCancel, All) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  build_book(tb, uid);
+  // Flatten the book.
+  tb.push_back(tb::make_mass_cancel(uid++, tb::mass_cancel::Bid |
+                                           tb::mass_cancel::Ask |
+                                           tb::mass_cancel::All));
+  tb.push_back(tb::make_nop(uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObMassCancel, Side) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  build_book(tb, uid);
+  tb.push_back(tb::make_mass_cancel(uid++, tb::mass_cancel::Bid |
+                                           tb::mass_cancel::All));
+  tb.push_back(tb::make_mass_cancel(uid++, tb::mass_cancel::Ask |
+                                           tb::mass_cancel::All));
+  tb.push_back(tb::make_nop(uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObMassCancel, Range) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  build_book(tb, uid);
+  // Bids at, or above, 99.00 (a run from the head).
+  tb.push_back(tb::make_mass_cancel(uid++, tb::mass_cancel::Bid |
+                                           tb::mass_cancel::Ge, "99.00"));
+  // Asks at, or above, 101.00 (a run to the tail).
+  tb.push_back(tb::make_mass_cancel(uid++, tb::mass_cancel::Ask |
+                                           tb::mass_cancel::Ge, "101.00"));
+  // Both sides at, or below, 100.50.
+  tb.push_back(tb::make_mass_cancel(uid++, tb::mass_cancel::Bid |
+                                           tb::mass_cancel::Ask |
+                                           tb::mass_cancel::Le, "100.50"));
+  tb.push_back(tb::make_nop(uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObMassCancel, Market) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  // Market orders rest in the absence of opposing liquidity.
+  tb.push_back(tb::make_market(tb::Opcode::BuyMarket, uid++, 10));
+  tb.push_back(tb::make_market(tb::Opcode::BuyMarket, uid++, 20));
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "50.00", 10));
+  // Ranged cancel retains market orders.
+  tb.push_back(tb::make_mass_cancel(uid++, tb::mass_cancel::Bid |
+                                           tb::mass_cancel::Ge, "10.00"));
+  tb.push_back(tb::make_mass_cancel(uid++, tb::mass_cancel::Bid |
+                                           tb::mass_cancel::Ask |
+                                           tb::mass_cancel::All));
+  tb.push_back(tb::make_nop(uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObMassCancel, Regress) {
+  // Initialization randomisation seed.
+  tb::Random::init(1);
+
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::Nop, 1);
+  bg.push_back(tb::Opcode::BuyLimit, 20);
+  bg.push_back(tb::Opcode::SellLimit, 20);
+  bg.push_back(tb::Opcode::BuyMarket, 2);
+  bg.push_back(tb::Opcode::SellMarket, 2);
+  bg.push_back(tb::Opcode::Cancel, 2);
+  bg.push_back(tb::Opcode::MassCancel, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+
+  tb::Options opts;
+  tb::TB tb{opts};
+  for (const tb::Command& cmd : gen.generate(LONG_N)) {
+    tb.push_back(cmd);
+  }
+  // Run simulation
+  tb.run();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,113 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "cmd.h"
+
+const std::size_t LONG_N = (1 << 15);
+
+TEST(TbObMd, Basic) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  // Build book; each improves the top-of-book.
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "99.00", 10));
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "101.00", 20));
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "99.50", 30));
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "100.50", 40));
+  // Partial execution updates quantity at the head of the ask.
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "100.50", 15));
+  // Pop head of bid; top-of-book reverts to the prior bid.
+  tb.push_back(tb::make_cmd(tb::Opcode::PopTopBid, uid++));
+  tb.push_back(tb::make_nop(uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObMd, Empty) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "100.00", 10));
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "100.00", 10));
+  // Book is empty once both orders have traded.
+  tb.push_back(tb::make_nop(uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObMd, Conflated) {
+  // Throttle market data accept such that updates are conflated.
+  tb::Options opts;
+  opts.md_accept_n = 16;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  const char* prices[] = {"99.00", "99.25", "99.50", "99.75"};
+  for (const char* price : prices) {
+    tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, price, 10));
+  }
+  tb.push_back(tb::make_nop(uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObMd, Regress) {
+  // Initialization randomisation seed.
+  tb::Random::init(1);
+
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::Nop, 1);
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::PopTopBid, 3);
+  bg.push_back(tb::Opcode::PopTopAsk, 3);
+  bg.push_back(tb::Opcode::Cancel, 1);
+  bg.push_back(tb::Opcode::BuyMarket, 1);
+  bg.push_back(tb::Opcode::SellMarket, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+
+  tb::Options opts;
+  opts.md_accept_n = 5;
+  tb::TB tb{opts};
+  for (const tb::Command& cmd : gen.generate(LONG_N)) {
+    tb.push_back(cmd);
+  }
+  // Run simulation
+  tb.run();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
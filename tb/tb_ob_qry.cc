@@ -154,6 +154,125 @@ TEST(Qry, Bid) {
   tb.run();
 }
 
+TEST(Qry, DepthBid) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+
+  tb::Command cmd;
+
+  // Populate Bid table with 3 levels: $100.00 (30), $99.50 (15), $99.00 (50)
+  const std::pair<const char*, vluint16_t> bids[] = {
+    {"100.00", 10}, {"99.00", 50}, {"99.50", 15}, {"100.00", 20}
+  };
+  for (const auto& bid : bids) {
+    cmd.valid = true;
+    cmd.uid = uid++;
+    cmd.opcode = tb::Opcode::BuyLimit;
+    cmd.quantity = bid.second;
+    cmd.price = tb::Bcd::from_string(bid.first).pack();
+    tb.push_back(cmd);
+  }
+
+  // Issue Depth for all levels -> Expect: 3 levels
+  cmd.valid = true;
+  cmd.uid = uid++;
+  cmd.opcode = tb::Opcode::QryDepthBid;
+  cmd.quantity = 0;
+  tb.push_back(cmd);
+
+  // Issue Depth for top 2 levels -> Expect: 2 levels
+  cmd.valid = true;
+  cmd.uid = uid++;
+  cmd.opcode = tb::Opcode::QryDepthBid;
+  cmd.quantity = 2;
+  tb.push_back(cmd);
+
+  // Issue Depth for top 8 levels -> Expect: 3 levels
+  cmd.valid = true;
+  cmd.uid = uid++;
+  cmd.opcode = tb::Opcode::QryDepthBid;
+  cmd.quantity = 8;
+  tb.push_back(cmd);
+
+  // Issue Depth on (empty) Ask table -> Expect: Bad
+  cmd.valid = true;
+  cmd.uid = uid++;
+  cmd.opcode = tb::Opcode::QryDepthAsk;
+  cmd.quantity = 0;
+  tb.push_back(cmd);
+
+  tb.run();
+}
+
+
+TEST(Qry, DepthAsk) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+
+  tb::Command cmd;
+
+  // Populate Ask table; one entry per level.
+  const char* asks[] = {"101.00", "100.75", "100.50", "100.25"};
+  for (const char* ask : asks) {
+    cmd.valid = true;
+    cmd.uid = uid++;
+    cmd.opcode = tb::Opcode::SellLimit;
+    cmd.quantity = 25;
+    cmd.price = tb::Bcd::from_string(ask).pack();
+    tb.push_back(cmd);
+  }
+
+  // Issue Depth for top level -> Expect: 25 @ $100.25
+  cmd.valid = true;
+  cmd.uid = uid++;
+  cmd.opcode = tb::Opcode::QryDepthAsk;
+  cmd.quantity = 1;
+  tb.push_back(cmd);
+
+  // Issue Depth for all levels -> Expect: 4 levels
+  cmd.valid = true;
+  cmd.uid = uid++;
+  cmd.opcode = tb::Opcode::QryDepthAsk;
+  cmd.quantity = 0;
+  tb.push_back(cmd);
+
+  // Issue Nop to drain.
+  cmd.valid = true;
+  cmd.uid = uid++;
+  cmd.opcode = tb::Opcode::Nop;
+  tb.push_back(cmd);
+
+  tb.run();
+}
+
+
+TEST(Qry, DepthRegress) {
+  // Initialization randomisation seed.
+  tb::Random::init(1);
+
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::PopTopBid, 2);
+  bg.push_back(tb::Opcode::PopTopAsk, 2);
+  bg.push_back(tb::Opcode::Cancel, 1);
+  bg.push_back(tb::Opcode::QryDepthBid, 2);
+  bg.push_back(tb::Opcode::QryDepthAsk, 2);
+  tb::StimulusGenerator gen(bg, 100.0, 1.0);
+
+  tb::Options opts;
+  tb::TB tb{opts};
+  for (const tb::Command& cmd : gen.generate(1 << 15)) {
+    tb.push_back(cmd);
+  }
+
+  tb.run();
+}
+
 
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
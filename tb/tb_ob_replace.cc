@@ -0,0 +1,121 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "cmd.h"
+
+const std::size_t LONG_N = (1 << 15);
+
+TEST(TbObReplace, InPlace) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  // Two orders at the same level; the first retains priority after its
+  // quantity is reduced.
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "100.00", 50));
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "100.00", 50));
+  tb.push_back(tb::make_replace(uid++, 0, "100.00", 20));
+  tb.push_back(tb::make_cmd(tb::Opcode::PopTopBid, uid++));
+  tb.push_back(tb::make_cmd(tb::Opcode::PopTopBid, uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObReplace, QuantityUp) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  // Increase in quantity forfeits priority.
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "100.00", 50));
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "100.00", 50));
+  tb.push_back(tb::make_replace(uid++, 0, "100.00", 80));
+  tb.push_back(tb::make_cmd(tb::Opcode::PopTopAsk, uid++));
+  tb.push_back(tb::make_cmd(tb::Opcode::PopTopAsk, uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObReplace, PriceTrade) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "99.00", 50));
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "101.00", 30));
+  // Move bid through the ask; trade against the resting ask.
+  tb.push_back(tb::make_replace(uid++, 0, "101.00", 50));
+  tb.push_back(tb::make_cmd(tb::Opcode::PopTopBid, uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObReplace, Miss) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "99.00", 50));
+  // Unknown UID.
+  tb.push_back(tb::make_replace(uid++, 100, "99.00", 10));
+  // Zero quantity cancels the order; subsequent amend misses.
+  tb.push_back(tb::make_replace(uid++, 0, "99.00", 0));
+  tb.push_back(tb::make_replace(uid++, 0, "99.00", 10));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObReplace, Regress) {
+  // Initialization randomisation seed.
+  tb::Random::init(1);
+
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::Nop, 1);
+  bg.push_back(tb::Opcode::BuyLimit, 20);
+  bg.push_back(tb::Opcode::SellLimit, 20);
+  bg.push_back(tb::Opcode::Cancel, 2);
+  bg.push_back(tb::Opcode::Replace, 10);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+
+  tb::Options opts;
+  tb::TB tb{opts};
+  for (const tb::Command& cmd : gen.generate(LONG_N)) {
+    tb.push_back(cmd);
+  }
+  // Run simulation
+  tb.run();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,107 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "cmd.h"
+
+const std::size_t LONG_N = (1 << 15);
+
+TEST(TbObRsp, TradeBurst) {
+  // Throttle response and trade accept such that responses accumulate in
+  // the egress buffers and are presented across multiple lanes of each beat.
+  tb::Options opts;
+  opts.rsp_accept_n = 8;
+  opts.trd_accept_n = 8;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  // Resting asks at ascending prices.
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "100.00", 10));
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "100.25", 10));
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "100.50", 10));
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "100.75", 10));
+  // Bid sweeps all asks; emitting one trade per resting order.
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "101.00", 40));
+  for (int i = 0; i < 16; i++) {
+    tb.push_back(tb::make_nop(uid++));
+  }
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObRsp, Lanes) {
+  // The controller emits at most one response per cycle; W lanes allow a
+  // consumer accepting once every W cycles to keep pace (see ob_egress).
+  if (tb::RSP_LANES_N == 1) return;
+
+  auto cycles = [](std::size_t rsp_accept_n) {
+    tb::Options opts;
+    opts.rsp_accept_n = rsp_accept_n;
+    tb::TB tb{opts};
+    for (vluint32_t uid = 0; uid < LONG_N; uid++) {
+      tb.push_back(tb::make_nop(uid));
+    }
+    tb.run();
+    return tb.throughput().cycles;
+  };
+  const vluint64_t unthrottled = cycles(1);
+  const vluint64_t throttled = cycles(tb::RSP_LANES_N);
+  EXPECT_LE(throttled, unthrottled + unthrottled / 8);
+}
+
+TEST(TbObRsp, Regress) {
+  // Initialization randomisation seed.
+  tb::Random::init(1);
+
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::Nop, 1);
+  bg.push_back(tb::Opcode::QryBidAsk, 4);
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::PopTopBid, 3);
+  bg.push_back(tb::Opcode::PopTopAsk, 3);
+  bg.push_back(tb::Opcode::Cancel, 1);
+  bg.push_back(tb::Opcode::BuyMarket, 1);
+  bg.push_back(tb::Opcode::SellMarket, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+
+  tb::Options opts;
+  opts.rsp_accept_n = 3;
+  tb::TB tb{opts};
+  for (const tb::Command& cmd : gen.generate(LONG_N)) {
+    tb.push_back(cmd);
+  }
+  // Run simulation
+  tb.run();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
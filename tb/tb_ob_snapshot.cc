@@ -0,0 +1,205 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "cmd.h"
+
+const std::size_t LONG_N = (1 << 15);
+
+namespace {
+
+// Book with resting limit bids (some at equal price), market bids and
+// conditional commands on both sides. The Ask side is empty, such that the
+// market bids rest.
+std::vector<tb::Command> make_book(vluint32_t& uid) {
+  std::vector<tb::Command> cmds;
+  cmds.push_back(tb::make_market(tb::Opcode::BuyMarket, uid++, 20));
+  cmds.push_back(tb::make_market(tb::Opcode::BuyMarket, uid++, 30));
+  const char* bids[] = {"99.00", "98.50", "99.50", "98.00", "99.00"};
+  for (const char* price : bids) {
+    cmds.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, price, 10));
+  }
+  cmds.push_back(
+      tb::make_stop(tb::Opcode::BuyStopLoss, uid++, "0.00", "101.00", 5));
+  cmds.push_back(
+      tb::make_stop(tb::Opcode::BuyStopLimit, uid++, "102.00", "103.00", 5));
+  cmds.push_back(
+      tb::make_stop(tb::Opcode::BuyStopLoss, uid++, "0.00", "101.00", 7));
+  cmds.push_back(
+      tb::make_stop(tb::Opcode::SellStopLoss, uid++, "0.00", "97.00", 5));
+  cmds.push_back(
+      tb::make_stop(tb::Opcode::SellStopLimit, uid++, "96.00", "96.50", 5));
+  return cmds;
+}
+
+void expect_eq(const std::vector<tb::Command>& actual,
+               const std::vector<tb::Command>& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (std::size_t i = 0; i < actual.size(); i++) {
+    EXPECT_EQ(actual[i].opcode, expected[i].opcode) << " Entry: " << i;
+    EXPECT_EQ(actual[i].tif, expected[i].tif) << " Entry: " << i;
+    EXPECT_EQ(actual[i].uid, expected[i].uid) << " Entry: " << i;
+    EXPECT_EQ(actual[i].quantity, expected[i].quantity) << " Entry: " << i;
+    EXPECT_EQ(actual[i].price, expected[i].price) << " Entry: " << i;
+    EXPECT_EQ(actual[i].price1, expected[i].price1) << " Entry: " << i;
+  }
+}
+
+} // namespace
+
+TEST(TbObSnapshot, Empty) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  // Only the final response is emitted.
+  tb.push_back(tb::make_cmd(tb::Opcode::QrySnapshot, 0));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObSnapshot, Basic) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  for (const tb::Command& cmd : make_book(uid)) {
+    tb.push_back(cmd);
+  }
+  tb.push_back(tb::make_cmd(tb::Opcode::QrySnapshot, uid++));
+  // Snapshot does not disturb the book.
+  tb.push_back(tb::make_cmd(tb::Opcode::QrySnapshot, uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObSnapshot, Load) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  // Overfill the Bid limit table; excess entries are rejected.
+  for (int i = 0; i < tb::BID_TABLE_DEPTH_N + 2; i++) {
+    tb.push_back(tb::make_limit(tb::Opcode::LoadBid, uid++, "99.00", 10));
+  }
+  tb.push_back(tb::make_limit(tb::Opcode::LoadAsk, uid++, "101.00", 10));
+  tb.push_back(tb::make_limit(tb::Opcode::LoadAsk, uid++, "100.50", 10));
+  tb.push_back(tb::make_limit(tb::Opcode::LoadAsk, uid++, "101.00", 10));
+  tb.push_back(tb::make_cmd(tb::Opcode::QryBidAsk, uid++));
+  tb.push_back(tb::make_cmd(tb::Opcode::QrySnapshot, uid++));
+  // Loaded entries trade as any other.
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "99.00", 25));
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "101.00", 15));
+  tb.push_back(tb::make_cmd(tb::Opcode::QrySnapshot, uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObSnapshot, Restore) {
+  vluint32_t uid = 0;
+  const std::vector<tb::Command> book = make_book(uid);
+
+  tb::Model model(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  for (const tb::Command& cmd : book) {
+    model.apply(cmd);
+  }
+  const std::vector<tb::Command> restore = model.snapshot();
+
+  // The response stream of the snapshot reproduces the restore sequence.
+  const std::deque<tb::Response> rsps =
+      model.apply(tb::make_cmd(tb::Opcode::QrySnapshot, uid++));
+  std::vector<tb::Command> cmds;
+  EXPECT_TRUE(tb::snapshot::to_commands({rsps.begin(), rsps.end()}, cmds));
+  expect_eq(cmds, restore);
+
+  // A truncated stream is rejected.
+  EXPECT_FALSE(
+      tb::snapshot::to_commands({rsps.begin(), rsps.end() - 1}, cmds));
+
+  // Restoring onto an empty book reproduces the original state.
+  tb::Model restored(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  for (const tb::Command& cmd : restore) {
+    restored.apply(cmd);
+  }
+  expect_eq(restored.snapshot(), restore);
+
+  // As above, on the UUT: the snapshot streamed by the UUT is converted to
+  // its restore sequence...
+  tb::Options opts;
+  tb::TB tb{opts};
+  for (const tb::Command& cmd : book) {
+    tb.push_back(cmd);
+  }
+  tb.push_back(tb::make_cmd(tb::Opcode::QrySnapshot, uid++));
+  tb.run();
+  ASSERT_TRUE(tb::snapshot::to_commands(tb.snapshot(), cmds));
+  expect_eq(cmds, restore);
+
+  // ... which is replayed onto the (reset) UUT, reproducing the original
+  // state.
+  for (const tb::Command& cmd : cmds) {
+    tb.push_back(cmd);
+  }
+  tb.push_back(tb::make_cmd(tb::Opcode::QrySnapshot, uid++));
+  tb.run();
+  std::vector<tb::Command> restored_cmds;
+  ASSERT_TRUE(tb::snapshot::to_commands(tb.snapshot(), restored_cmds));
+  expect_eq(restored_cmds, restore);
+}
+
+TEST(TbObSnapshot, Regress) {
+  // Initialization randomisation seed.
+  tb::Random::init(1);
+
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::BuyLimit, 20);
+  bg.push_back(tb::Opcode::SellLimit, 20);
+  bg.push_back(tb::Opcode::BuyMarket, 2);
+  bg.push_back(tb::Opcode::SellMarket, 2);
+  bg.push_back(tb::Opcode::Cancel, 4);
+  bg.push_back(tb::Opcode::BuyStopLoss, 2);
+  bg.push_back(tb::Opcode::SellStopLoss, 2);
+  bg.push_back(tb::Opcode::BuyStopLimit, 2);
+  bg.push_back(tb::Opcode::SellStopLimit, 2);
+  bg.push_back(tb::Opcode::QrySnapshot, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+
+  tb::Options opts;
+  tb::TB tb{opts};
+  for (const tb::Command& cmd : gen.generate(LONG_N)) {
+    tb.push_back(cmd);
+  }
+  // Run simulation
+  tb.run();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,133 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "cmd.h"
+
+const std::size_t LONG_N = (1 << 15);
+
+TEST(TbObStats, Empty) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  // Counters are cleared on reset; only the query itself is counted.
+  tb.push_back(tb::make_cmd(tb::Opcode::QryStats, 0));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObStats, Basic) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "100.00", 50));
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "99.00", 50));
+  // Trades against both resting bids.
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, uid++, "99.00", 80));
+  tb.push_back(tb::make_cmd(tb::Opcode::QryStats, uid++));
+  // Cancel hit (remainder of the second bid), then miss.
+  tb.push_back(tb::make_cancel(uid++, 1));
+  tb.push_back(tb::make_cancel(uid++, 1));
+  tb.push_back(tb::make_cmd(tb::Opcode::Nop, uid++));
+  tb.push_back(tb::make_cmd(tb::Opcode::QryStats, uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObStats, Reject) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  // Overfill the Bid limit and market tables.
+  for (int i = 0; i < tb::BID_TABLE_DEPTH_N + 2; i++) {
+    tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "100.00", 10));
+  }
+  for (int i = 0; i < tb::MARKET_BID_DEPTH_N + 2; i++) {
+    tb.push_back(tb::make_market(tb::Opcode::BuyMarket, uid++, 10));
+  }
+  tb.push_back(tb::make_cmd(tb::Opcode::QryStats, uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObStats, Stall) {
+  // Response interface is back-pressured; stalls are observed in the
+  // timing dependent counters.
+  tb::Options opts;
+  opts.rsp_accept_n = 4;
+  tb::TB tb{opts};
+
+  vluint32_t uid = 0;
+  for (int i = 0; i < 16; i++) {
+    tb.push_back(tb::make_cmd(tb::Opcode::Nop, uid++));
+  }
+  tb.push_back(tb::make_cmd(tb::Opcode::QryStats, uid++));
+  tb.push_back(tb::make_cmd(tb::Opcode::QryStats, uid++));
+
+  // Run simulation.
+  tb.run();
+
+  EXPECT_GT(tb.counter(tb::stats::EgressStall), 0u);
+}
+
+TEST(TbObStats, Regress) {
+  // Initialization randomisation seed.
+  tb::Random::init(1);
+
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::Nop, 1);
+  bg.push_back(tb::Opcode::BuyLimit, 20);
+  bg.push_back(tb::Opcode::SellLimit, 20);
+  bg.push_back(tb::Opcode::BuyMarket, 2);
+  bg.push_back(tb::Opcode::SellMarket, 2);
+  bg.push_back(tb::Opcode::Cancel, 4);
+  bg.push_back(tb::Opcode::BuyStopLoss, 2);
+  bg.push_back(tb::Opcode::SellStopLoss, 2);
+  bg.push_back(tb::Opcode::BuyStopLimit, 2);
+  bg.push_back(tb::Opcode::SellStopLimit, 2);
+  bg.push_back(tb::Opcode::QryStats, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+
+  tb::Options opts;
+  tb::TB tb{opts};
+  for (const tb::Command& cmd : gen.generate(LONG_N)) {
+    tb.push_back(cmd);
+  }
+  // Run simulation
+  tb.run();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,68 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "gtest/gtest.h"
+#include "tb.h"
+#include <iostream>
+
+TEST(TbObSweep, Trace) {
+  // Fixed trace for design-space exploration (see regress/sim_analysis.py);
+  // the seed, and the set of opcodes, are chosen such that the trace is
+  // independent of the configured table depths.
+  tb::Random::init(1);
+
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::Nop, 1);
+  bg.push_back(tb::Opcode::QryBidAsk, 1);
+  bg.push_back(tb::Opcode::BuyLimit, 20);
+  bg.push_back(tb::Opcode::SellLimit, 20);
+  bg.push_back(tb::Opcode::PopTopBid, 2);
+  bg.push_back(tb::Opcode::PopTopAsk, 2);
+  bg.push_back(tb::Opcode::BuyMarket, 2);
+  bg.push_back(tb::Opcode::SellMarket, 2);
+  bg.push_back(tb::Opcode::BuyStopLoss, 1);
+  bg.push_back(tb::Opcode::SellStopLoss, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+
+  tb::TB tb;
+  for (const tb::Command& cmd : gen.generate(1 << 14)) {
+    tb.push_back(cmd);
+  }
+
+  // Run simulation.
+  tb.run();
+
+  // Emit results in a form consumed by the sweep driver.
+  std::cout << "[SWEEP] bid_n:" << tb::BID_TABLE_DEPTH_N
+            << " ask_n:" << tb::ASK_TABLE_DEPTH_N
+            << " cn_n:" << tb::CN_DEPTH_N
+            << " " << tb.throughput().to_string() << "\n";
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
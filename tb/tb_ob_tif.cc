@@ -0,0 +1,235 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "cmd.h"
+#include <vector>
+
+const std::size_t LONG_N = (1 << 15);
+
+TEST(TbObTif, IocPartial) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  // Resting ask of 50 shares.
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, 0, "100.00", 50));
+  // IOC bid of 80 shares; 50 execute and the remaining 30 are killed.
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, 1, "100.00", 80,
+                              tb::Tif::ImmediateOrCancel));
+  // Subsequent ask must not trade with the killed remainder.
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, 2, "100.00", 10));
+  tb.push_back(tb::make_nop(3));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObTif, IocNoFill) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, 0, "101.00", 50));
+  // Neither IOC order crosses, therefore both are killed in their entirety.
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, 1, "102.00", 50,
+                              tb::Tif::ImmediateOrCancel));
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, 2, "100.00", 50,
+                              tb::Tif::ImmediateOrCancel));
+  tb.push_back(tb::make_nop(3));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObTif, IocFullFill) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, 0, "100.00", 50));
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, 1, "100.50", 50));
+  // IOC bid executes in its entirety; no kill notification.
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, 2, "101.00", 100,
+                              tb::Tif::ImmediateOrCancel));
+  tb.push_back(tb::make_nop(3));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObTif, FokKill) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, 0, "100.00", 50));
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, 1, "102.00", 50));
+  // Only 50 shares available at or below 101.00; killed without execution.
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, 2, "101.00", 80,
+                              tb::Tif::FillOrKill));
+  // Asks remain intact.
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, 3, "102.00", 100));
+  tb.push_back(tb::make_nop(4));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObTif, FokFill) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, 0, "100.00", 50));
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, 1, "99.00", 50));
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, 2, "98.00", 50));
+  // Sufficient quantity at or above 99.00; executes across two bids.
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, 3, "99.00", 80,
+                              tb::Tif::FillOrKill));
+  tb.push_back(tb::make_nop(4));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObTif, FokMarket) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  tb::Command cmd;
+
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, 0, "100.00", 50));
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, 1, "150.00", 50));
+
+  // Market buy for more than is available is killed.
+  cmd = tb::make_limit(tb::Opcode::BuyMarket, 2, "100.00", 200,
+                       tb::Tif::FillOrKill);
+  tb.push_back(cmd);
+
+  // Market buy for all that is available executes.
+  cmd = tb::make_limit(tb::Opcode::BuyMarket, 3, "100.00", 100,
+                       tb::Tif::FillOrKill);
+  tb.push_back(cmd);
+  tb.push_back(tb::make_nop(4));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObTif, AonAsFok) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  tb.push_back(tb::make_limit(tb::Opcode::SellLimit, 0, "100.00", 50));
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, 1, "100.00", 60,
+                              tb::Tif::AllOrNone));
+  tb.push_back(tb::make_limit(tb::Opcode::BuyLimit, 2, "100.00", 50,
+                              tb::Tif::AllOrNone));
+  tb.push_back(tb::make_nop(3));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObTif, IocFullTable) {
+  tb::Options opts;
+  tb::TB tb{opts};
+
+  std::vector<tb::Command> cmds;
+  vluint32_t uid = 0;
+
+  // Fill the bid table with resting orders; there are no asks.
+  for (std::size_t i = 0; i < tb::BID_TABLE_DEPTH_N; i++) {
+    cmds.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "100.00", 10));
+  }
+  // An IOC bid ahead of the resting orders, and another behind them, are
+  // each killed without displacing a resting order.
+  const vluint32_t ioc_head = uid++;
+  cmds.push_back(tb::make_limit(tb::Opcode::BuyLimit, ioc_head, "101.00", 10,
+                                tb::Tif::ImmediateOrCancel));
+  const vluint32_t ioc_tail = uid++;
+  cmds.push_back(tb::make_limit(tb::Opcode::BuyLimit, ioc_tail, "99.00", 10,
+                                tb::Tif::ImmediateOrCancel));
+  // A GUC bid ahead of the resting orders continues to displace the last.
+  cmds.push_back(tb::make_limit(tb::Opcode::BuyLimit, uid++, "101.00", 10));
+  // Every remaining entry is present.
+  for (std::size_t i = 0; i < tb::BID_TABLE_DEPTH_N; i++) {
+    cmds.push_back(tb::make_cmd(tb::Opcode::PopTopBid, uid++));
+  }
+
+  tb::Model model(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  std::size_t rejects = 0;
+  for (const tb::Command& cmd : cmds) {
+    for (const tb::Response& rsp : model.apply(cmd)) {
+      if (rsp.status == tb::Status::Reject) {
+        // Only the GUC bid may displace the last resting order.
+        EXPECT_EQ(cmd.tif, tb::Tif::GoodUntilCancelled);
+        EXPECT_EQ(rsp.uid, tb::BID_TABLE_DEPTH_N - 1);
+        rejects++;
+      }
+      if (rsp.status == tb::Status::Killed) {
+        EXPECT_TRUE((rsp.uid == ioc_head) || (rsp.uid == ioc_tail));
+      }
+      EXPECT_NE(rsp.status, tb::Status::BadPop);
+    }
+    tb.push_back(cmd);
+  }
+  EXPECT_EQ(rejects, 1);
+  tb.push_back(tb::make_nop(uid++));
+
+  // Run simulation.
+  tb.run();
+}
+
+TEST(TbObTif, Regress) {
+  // Initialization randomisation seed.
+  tb::Random::init(1);
+
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::BuyMarket, 1);
+  bg.push_back(tb::Opcode::SellMarket, 1);
+  bg.push_back(tb::Opcode::Cancel, 1);
+
+  tb::Bag<vluint8_t> tifs;
+  tifs.push_back(tb::Tif::GoodUntilCancelled, 4);
+  tifs.push_back(tb::Tif::ImmediateOrCancel, 2);
+  tifs.push_back(tb::Tif::FillOrKill, 1);
+  tifs.push_back(tb::Tif::AllOrNone, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0, tifs);
+
+  tb::Options opts;
+  tb::TB tb{opts};
+  for (const tb::Command& cmd : gen.generate(LONG_N)) {
+    tb.push_back(cmd);
+  }
+  // Run simulation
+  tb.run();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,93 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "gtest/gtest.h"
+#include "tb.h"
+#include <set>
+
+TEST(TbUniquePool, Exhaust) {
+  // Domains which are not a multiple of the word/page size.
+  for (vluint32_t hi : {0u, 1u, 63u, 64u, 65u, 300000u}) {
+    tb::UniquePool<vluint32_t> pool(hi, 0);
+    std::set<vluint32_t> s;
+    vluint32_t t;
+    while (pool.generate(t)) {
+      ASSERT_LE(t, hi);
+      ASSERT_TRUE(s.insert(t).second);
+    }
+    EXPECT_EQ(s.size(), hi + 1ull);
+    EXPECT_EQ(pool.size(), hi + 1ull);
+
+    // Retire every third value; exactly those are subsequently generated.
+    for (vluint32_t v = 0; v <= hi; v += 3) {
+      pool.retire(v);
+    }
+    std::set<vluint32_t> r;
+    while (pool.generate(t)) {
+      ASSERT_EQ(t % 3, 0);
+      ASSERT_TRUE(r.insert(t).second);
+    }
+    EXPECT_EQ(r.size(), (hi / 3) + 1ull);
+  }
+}
+
+TEST(TbUniquePool, Insert) {
+  tb::UniquePool<int> pool(5, -5);
+  pool.insert(0);
+  pool.insert(-5);
+  std::set<int> s;
+  int t;
+  while (pool.generate(t)) {
+    ASSERT_TRUE(s.insert(t).second);
+  }
+  EXPECT_EQ(s.size(), 9);
+  EXPECT_EQ(s.count(0), 0);
+  EXPECT_EQ(s.count(-5), 0);
+}
+
+TEST(TbUniquePool, Population) {
+  // Millions of live values (a realistic resting-order population).
+  tb::UniquePool<vluint32_t> pool((1 << 24) - 1, 0);
+  tb::Xoshiro256pp rng{1};
+  std::vector<vluint32_t> live;
+  vluint32_t t;
+  for (std::size_t i = 0; i < (1 << 22); i++) {
+    ASSERT_TRUE(pool.generate(t, rng));
+    live.push_back(t);
+  }
+  // Churn: retire and replace.
+  for (std::size_t i = 0; i < (1 << 20); i++) {
+    const std::size_t j = rng.bounded(live.size());
+    pool.retire(live[j]);
+    ASSERT_TRUE(pool.generate(live[j], rng));
+  }
+  EXPECT_EQ(pool.size(), live.size());
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
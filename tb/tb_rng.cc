@@ -0,0 +1,130 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "gtest/gtest.h"
+#include "tb.h"
+#include <cmath>
+#include <thread>
+#include <vector>
+
+TEST(TbRng, Reproducible) {
+  tb::Xoshiro256pp a{1}, b{1};
+  for (std::size_t i = 0; i < 1024; i++) {
+    ASSERT_EQ(a(), b());
+  }
+
+  // Per-thread state; each thread observes the same stream for the same
+  // seed, independent of the other.
+  std::vector<std::uint64_t> rs(4);
+  std::vector<std::thread> ts;
+  for (std::size_t i = 0; i < rs.size(); i++) {
+    ts.emplace_back([&rs, i]() {
+      tb::Random::init(1);
+      for (std::size_t j = 0; j < 1000; j++) {
+        rs[i] = tb::Random::uniform<int>();
+      }
+    });
+  }
+  for (std::thread& t : ts) t.join();
+  for (std::uint64_t r : rs) {
+    EXPECT_EQ(r, rs.front());
+  }
+}
+
+TEST(TbRng, Jump) {
+  tb::Xoshiro256pp a{1}, b{1};
+  b.jump();
+  // Streams diverge.
+  std::size_t eq_n = 0;
+  for (std::size_t i = 0; i < 1024; i++) {
+    eq_n += (a() == b());
+  }
+  EXPECT_EQ(eq_n, 0);
+}
+
+TEST(TbRng, Uniform) {
+  tb::Xoshiro256pp rng{1};
+  std::vector<std::size_t> h(11);
+  const std::size_t n = 110000;
+  for (std::size_t i = 0; i < n; i++) {
+    const int r = rng.uniform<int>(10, 0);
+    ASSERT_GE(r, 0);
+    ASSERT_LE(r, 10);
+    ++h[r];
+  }
+  for (std::size_t c : h) {
+    EXPECT_NEAR(static_cast<double>(c), n / 11.0, n / 11.0 * 0.05);
+  }
+  // Full range of the type.
+  std::vector<std::size_t> h8(256);
+  for (std::size_t i = 0; i < (256 << 8); i++) {
+    ++h8[rng.uniform<vluint8_t>(255, 0)];
+  }
+  for (std::size_t c : h8) {
+    EXPECT_GT(c, 0);
+  }
+}
+
+TEST(TbRng, Normal) {
+  tb::Xoshiro256pp rng{1};
+  tb::NormalBatch prices{100.0, 10.0};
+  const std::size_t n = 1 << 18;
+  double sum = 0.0, sum2 = 0.0;
+  for (std::size_t i = 0; i < n; i++) {
+    const double x = prices(rng);
+    sum += x;
+    sum2 += x * x;
+  }
+  const double mean = sum / n;
+  EXPECT_NEAR(mean, 100.0, 0.1);
+  EXPECT_NEAR(std::sqrt((sum2 / n) - (mean * mean)), 10.0, 0.1);
+}
+
+TEST(TbRng, Alias) {
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::Nop, 1);
+  bg.push_back(tb::Opcode::BuyLimit, 20);
+  bg.push_back(tb::Opcode::SellLimit, 20);
+  bg.push_back(tb::Opcode::Cancel, 0);
+  bg.push_back(tb::Opcode::PopTopBid, 3);
+
+  tb::Xoshiro256pp rng{1};
+  std::vector<std::size_t> h(256);
+  const std::size_t n = 44 << 12;
+  for (std::size_t i = 0; i < n; i++) {
+    ++h[bg(rng)];
+  }
+  EXPECT_EQ(h[tb::Opcode::Cancel], 0);
+  EXPECT_NEAR(h[tb::Opcode::Nop], n * 1 / 44.0, n * 1 / 44.0 * 0.1);
+  EXPECT_NEAR(h[tb::Opcode::BuyLimit], n * 20 / 44.0, n * 20 / 44.0 * 0.05);
+  EXPECT_NEAR(h[tb::Opcode::SellLimit], n * 20 / 44.0, n * 20 / 44.0 * 0.05);
+  EXPECT_NEAR(h[tb::Opcode::PopTopBid], n * 3 / 44.0, n * 3 / 44.0 * 0.1);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,148 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "gtest/gtest.h"
+#include "seqlock.h"
+#include "tb.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Record spanning several words; each word carries the same value such that
+// a torn copy is detectable.
+struct Record {
+  std::uint64_t w[5];
+};
+
+} // namespace
+
+TEST(TbSeqLock, Basic) {
+  tb::SeqLock<Record> sl;
+  std::uint64_t version = 1;
+  Record r = sl.load(&version);
+  EXPECT_EQ(version, 0);
+  for (std::uint64_t w : r.w) EXPECT_EQ(w, 0);
+
+  for (std::uint64_t i = 1; i < 4; i++) {
+    Record s;
+    for (std::uint64_t& w : s.w) w = i;
+    sl.store(s);
+    EXPECT_EQ(sl.version(), i);
+    EXPECT_TRUE(sl.try_load(r, &version));
+    EXPECT_EQ(version, i);
+    for (std::uint64_t w : r.w) EXPECT_EQ(w, i);
+  }
+}
+
+TEST(TbSeqLock, Concurrent) {
+  tb::SeqLock<Record> sl;
+  const std::uint64_t n = 1 << 20;
+  std::atomic<bool> done{false};
+  std::atomic<std::size_t> errors{0};
+
+  // Readers only ever observe complete records, and their versions never
+  // regress.
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 3; i++) {
+    readers.emplace_back([&]() {
+      std::uint64_t last = 0;
+      Record r;
+      std::uint64_t version;
+      while (!done.load(std::memory_order_acquire)) {
+        if (!sl.try_load(r, &version)) continue;
+        for (std::uint64_t w : r.w) {
+          if (w != version) errors++;
+        }
+        if (version < last) errors++;
+        last = version;
+      }
+    });
+  }
+  Record s;
+  for (std::uint64_t i = 1; i <= n; i++) {
+    for (std::uint64_t& w : s.w) w = i;
+    sl.store(s);
+  }
+  done.store(true, std::memory_order_release);
+  for (std::thread& t : readers) t.join();
+  EXPECT_EQ(errors.load(), 0);
+  EXPECT_EQ(sl.version(), n);
+}
+
+TEST(TbSeqLock, Model) {
+  tb::Random::init(1);
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::QryBidAsk, 4);
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::PopTopBid, 3);
+  bg.push_back(tb::Opcode::PopTopAsk, 3);
+  bg.push_back(tb::Opcode::Cancel, 3);
+  bg.push_back(tb::Opcode::BuyMarket, 1);
+  bg.push_back(tb::Opcode::SellMarket, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+
+  tb::TopOfBook tob;
+  tb::Model model(tb::BID_TABLE_DEPTH_N, tb::ASK_TABLE_DEPTH_N);
+  model.publish(&tob);
+  EXPECT_EQ(tob.version(), 1);
+
+  // The publication tracks the top-of-book, and is only revised when the
+  // top-of-book changes.
+  std::size_t changes = 0;
+  for (const tb::Command& cmd : gen.generate(10000)) {
+    const tb::MarketData prior = model.top_of_book();
+    const std::uint64_t version = tob.version();
+    model.apply(cmd);
+    const tb::MarketData md = model.top_of_book();
+    const bool changed = !(md == prior);
+    changes += changed;
+    EXPECT_EQ(tob.version(), version + changed);
+    const tb::MarketData published = tob.load();
+    EXPECT_TRUE(published.valid);
+    EXPECT_EQ(published, md);
+  }
+  EXPECT_GT(changes, 0);
+
+  // Publication ceases.
+  model.publish(nullptr);
+  const std::uint64_t version = tob.version();
+  tb::Command cmd;
+  cmd.valid = true;
+  cmd.opcode = tb::Opcode::BuyLimit;
+  cmd.uid = 0xFFFF0000;
+  cmd.quantity = 1;
+  cmd.price = 1000000;
+  model.apply(cmd);
+  EXPECT_EQ(tob.version(), version);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,64 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+#include "gtest/gtest.h"
+#include "spsc.h"
+#include <thread>
+
+TEST(TbSpsc, Bounded) {
+  tb::SpscQueue<int> q{3};
+  // Capacity rounded up to a power of two.
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(q.try_push(i));
+  }
+  EXPECT_FALSE(q.try_push(4));
+  int t;
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(q.try_pop(t));
+    EXPECT_EQ(t, i);
+  }
+  EXPECT_FALSE(q.try_pop(t));
+}
+
+TEST(TbSpsc, Concurrent) {
+  tb::SpscQueue<std::size_t> q{64};
+  const std::size_t n = 1 << 20;
+  std::thread producer([&]() {
+    for (std::size_t i = 0; i < n; i++) q.push(i);
+  });
+  // Values are received in order, without loss.
+  std::size_t t;
+  for (std::size_t i = 0; i < n; i++) {
+    q.pop(t);
+    ASSERT_EQ(t, i);
+  }
+  producer.join();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,201 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "gtest/gtest.h"
+#include "tb.h"
+#include "cmd.h"
+#include "wire.h"
+#include "Vtb_ob.h"
+#include <vector>
+
+TEST(TbWire, Layout) {
+  using tb::wire::Cmd;
+  using tb::wire::Rsp;
+  // ob_pkg::cmd_t
+  EXPECT_EQ(Cmd::W, 128);
+  EXPECT_EQ(Cmd::BYTES, 16);
+  EXPECT_EQ(Cmd::F[Cmd::Price1].lsb, 0);
+  EXPECT_EQ(Cmd::F[Cmd::Uid1].lsb, 20);
+  EXPECT_EQ(Cmd::F[Cmd::Quantity].lsb, 52);
+  EXPECT_EQ(Cmd::F[Cmd::Price].lsb, 68);
+  EXPECT_EQ(Cmd::F[Cmd::Tif].lsb, 88);
+  EXPECT_EQ(Cmd::F[Cmd::Opcode].lsb, 91);
+  EXPECT_EQ(Cmd::F[Cmd::Uid].lsb, 96);
+  // ob_pkg::rsp_t
+  EXPECT_EQ(Rsp::W, tb::RSP_TIMESTAMP_EN ? 179 : 115);
+  EXPECT_EQ(Rsp::BYTES, tb::RSP_TIMESTAMP_EN ? 24 : 16);
+  EXPECT_EQ(Rsp::F[Rsp::Result].lsb, 0);
+  EXPECT_EQ(Rsp::F[Rsp::Status].lsb, 80);
+  EXPECT_EQ(Rsp::F[Rsp::Uid].lsb, 83);
+  EXPECT_EQ(Rsp::F[Rsp::TsEmit].lsb, 115);
+  EXPECT_EQ(Rsp::F[Rsp::TsAccept].lsb, tb::RSP_TIMESTAMP_EN ? 147 : 115);
+  EXPECT_EQ(Rsp::Stats::F[Rsp::Stats::Last].lsb, 48);
+}
+
+TEST(TbWire, RtlWidth) {
+  // Layout must agree with the packed structures of the RTL.
+  Vtb_ob u;
+  u.eval();
+  EXPECT_EQ(u.tb_cmd_w, tb::wire::Cmd::W);
+  EXPECT_EQ(u.tb_rsp_w, tb::wire::Rsp::W);
+}
+
+TEST(TbWire, CmdBits) {
+  tb::Command cmd = tb::make_cmd(tb::Opcode::BuyLimit, 0x12345678);
+  cmd.tif = tb::Tif::FillOrKill;
+  cmd.price = 0x10025;
+  cmd.quantity = 0xBEEF;
+
+  std::byte rec[tb::wire::Cmd::BYTES];
+  tb::wire::encode(cmd, rec);
+  // UID occupies the most significant word.
+  EXPECT_EQ(rec[12], std::byte{0x78});
+  EXPECT_EQ(rec[15], std::byte{0x12});
+  // Opcode/TIF share byte 11.
+  EXPECT_EQ(rec[11], std::byte((tb::Opcode::BuyLimit << 3) | tb::Tif::FillOrKill));
+}
+
+TEST(TbWire, CmdRoundTrip) {
+  tb::Random::init(1);
+  for (int i = 0; i < 1024; i++) {
+    tb::Command cmd = tb::make_cmd(tb::Random::uniform<vluint8_t>(0x1F, 0),
+                                   tb::Random::uniform<vluint32_t>());
+    cmd.tif = tb::Random::uniform<vluint8_t>(0x7, 0);
+    cmd.price = tb::Random::uniform<vluint32_t>(0xFFFFF, 0);
+    cmd.quantity = tb::Random::uniform<vluint16_t>();
+    cmd.uid1 = tb::Random::uniform<vluint32_t>();
+    cmd.price1 = tb::Random::uniform<vluint32_t>(0xFFFFF, 0);
+
+    std::byte rec[tb::wire::Cmd::BYTES];
+    tb::wire::encode(cmd, rec);
+    tb::Command actual;
+    tb::wire::decode(rec, actual);
+    EXPECT_EQ(actual.uid, cmd.uid);
+    EXPECT_EQ(actual.opcode, cmd.opcode);
+    EXPECT_EQ(actual.tif, cmd.tif);
+    EXPECT_EQ(actual.price, cmd.price);
+    EXPECT_EQ(actual.quantity, cmd.quantity);
+    EXPECT_EQ(actual.uid1, cmd.uid1);
+    EXPECT_EQ(actual.price1, cmd.price1);
+  }
+}
+
+TEST(TbWire, RspRoundTrip) {
+  tb::Response rsp;
+  rsp.valid = true;
+  rsp.uid = 7;
+  rsp.status = tb::Status::Okay;
+  rsp.ts_accept = 100;
+  rsp.ts_emit = 0xFFFFFFFF;
+  rsp.result.depth.last = true;
+  rsp.result.depth.level = 3;
+  rsp.result.depth.price = 0x10050;
+  rsp.result.depth.accum = 12345;
+
+  std::byte rec[tb::wire::Rsp::BYTES];
+  tb::wire::encode(rsp, tb::Opcode::QryDepthBid, rec);
+  tb::Response actual;
+  tb::wire::decode(rec, actual);
+  EXPECT_EQ(actual.uid, rsp.uid);
+  EXPECT_EQ(actual.status, rsp.status);
+  // Timestamps are omitted from the record when disabled.
+  EXPECT_EQ(actual.ts_accept, tb::RSP_TIMESTAMP_EN ? rsp.ts_accept : 0u);
+  EXPECT_EQ(actual.ts_emit, tb::RSP_TIMESTAMP_EN ? rsp.ts_emit : 0u);
+  EXPECT_EQ(actual.result.depth.last, rsp.result.depth.last);
+  EXPECT_EQ(actual.result.depth.level, rsp.result.depth.level);
+  EXPECT_EQ(actual.result.depth.price, rsp.result.depth.price);
+  EXPECT_EQ(actual.result.depth.accum, rsp.result.depth.accum);
+
+  // Union members of a decoded response are consistent; re-encoding without
+  // the opcode reproduces the record exactly.
+  std::byte copy[tb::wire::Rsp::BYTES];
+  tb::wire::encode(actual, copy);
+  for (std::size_t i = 0; i < tb::wire::Rsp::BYTES; i++) {
+    EXPECT_EQ(copy[i], rec[i]);
+  }
+}
+
+TEST(TbWire, SnapshotRoundTrip) {
+  tb::Response rsp;
+  rsp.valid = true;
+  rsp.uid = 9;
+  rsp.status = tb::Status::Okay;
+  rsp.result.snapshot.table = tb::snapshot::CnSell;
+  rsp.result.snapshot.ext = true;
+  rsp.result.snapshot.price = 0x10050;
+  rsp.result.snapshot.quantity =
+      tb::snapshot::pack_ext(tb::Opcode::SellStopLimit, tb::Tif::AllOrNone);
+  rsp.result.snapshot.uid = 0x12345678;
+
+  std::byte rec[tb::wire::Rsp::BYTES];
+  tb::wire::encode(rsp, tb::Opcode::QrySnapshot, rec);
+  tb::Response actual;
+  tb::wire::decode(rec, actual);
+  EXPECT_EQ(actual.result.snapshot.last, rsp.result.snapshot.last);
+  EXPECT_EQ(actual.result.snapshot.table, rsp.result.snapshot.table);
+  EXPECT_EQ(actual.result.snapshot.ext, rsp.result.snapshot.ext);
+  EXPECT_EQ(actual.result.snapshot.price, rsp.result.snapshot.price);
+  EXPECT_EQ(actual.result.snapshot.quantity, rsp.result.snapshot.quantity);
+  EXPECT_EQ(actual.result.snapshot.uid, rsp.result.snapshot.uid);
+  // Entry occupies the same bits as result_poptop_t.
+  EXPECT_EQ(actual.result.poptop.uid, rsp.result.snapshot.uid);
+
+  std::byte copy[tb::wire::Rsp::BYTES];
+  tb::wire::encode(actual, copy);
+  for (std::size_t i = 0; i < tb::wire::Rsp::BYTES; i++) {
+    EXPECT_EQ(copy[i], rec[i]);
+  }
+}
+
+TEST(TbWire, Batch) {
+  // Stimulus is encoded into a contiguous buffer, and the batch pushed to
+  // the harness as a whole.
+  tb::Random::init(1);
+
+  tb::Bag<vluint8_t> bg;
+  bg.push_back(tb::Opcode::QryBidAsk, 4);
+  bg.push_back(tb::Opcode::BuyLimit, 10);
+  bg.push_back(tb::Opcode::SellLimit, 10);
+  bg.push_back(tb::Opcode::Cancel, 1);
+  tb::StimulusGenerator gen(bg, 100.0, 10.0);
+  const std::deque<tb::Command> cmds = gen.generate(1024);
+
+  std::vector<std::byte> buf(cmds.size() * tb::wire::Cmd::BYTES);
+  tb::wire::CmdBatch b(buf.data(), cmds.size());
+  EXPECT_EQ(tb::wire::encode(cmds.begin(), cmds.end(), b), cmds.size());
+  EXPECT_TRUE(b.full());
+  EXPECT_EQ(b.bytes(), buf.size());
+
+  tb::TB tb;
+  tb::wire::push_back(tb, b);
+  tb.run();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
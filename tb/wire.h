@@ -0,0 +1,453 @@
+//========================================================================== //
+// Copyright (c) 2020, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef M_TB_WIRE_H
+#define M_TB_WIRE_H
+
+#include "tb.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Host wire format of the ob_pkg::cmd_t and ob_pkg::rsp_t packed structures.
+//
+// A record is the packed structure rendered little-endian: bit 'i' of the
+// structure (bit 0 being the least significant bit of the final member) is
+// bit 'i % 8' of byte 'i / 8'. Records are padded to a multiple of 64b such
+// that each record in a contiguous batch is naturally aligned; padding bits
+// are zero. Field offsets are derived at compile time from the widths of
+// the structure members, in declaration order, as per SystemVerilog packing
+// rules.
+//
+namespace tb::wire {
+
+// Bit-field within a packed record.
+struct Field {
+  // Offset of the least significant bit.
+  std::size_t lsb;
+  // Width (in bits; <= 64).
+  std::size_t w;
+
+  constexpr std::size_t msb() const { return lsb + w - 1; }
+};
+
+// Derive the fields of a packed structure from the widths of its members,
+// in declaration order (most significant first), relative to bit 'base'.
+template<std::size_t N>
+constexpr std::array<Field, N> pack(const std::array<std::size_t, N>& ws,
+                                    std::size_t base = 0) {
+  std::array<Field, N> fs{};
+  std::size_t lsb = base;
+  for (std::size_t i = N; i-- > 0; ) {
+    fs[i] = Field{lsb, ws[i]};
+    lsb += ws[i];
+  }
+  return fs;
+}
+
+// Total width of a packed structure.
+template<std::size_t N>
+constexpr std::size_t width(const std::array<std::size_t, N>& ws) {
+  std::size_t w = 0;
+  for (std::size_t i = 0; i < N; i++) w += ws[i];
+  return w;
+}
+
+// Record size (in bytes) of a 'w' bit structure.
+constexpr std::size_t bytes(std::size_t w) { return ((w + 63) / 64) * 8; }
+
+constexpr std::size_t clog2(std::size_t n) {
+  std::size_t r = 0;
+  while ((std::size_t{1} << r) < n) ++r;
+  return r;
+}
+
+// Member widths (ob_pkg/bcd_pkg).
+constexpr std::size_t UID_W = 32;
+constexpr std::size_t OPCODE_W = 5;
+constexpr std::size_t TIF_W = 3;
+constexpr std::size_t PRICE_W = 20;
+constexpr std::size_t QUANTITY_W = 16;
+constexpr std::size_t STATUS_W = 3;
+// Timestamps are omitted from rsp_t when RSP_TIMESTAMP_EN is clear.
+constexpr std::size_t TS_W = RSP_TIMESTAMP_EN ? 32 : 0;
+constexpr std::size_t STATS_ID_W = 16;
+constexpr std::size_t STATS_CNT_W = 32;
+constexpr std::size_t SNAP_TABLE_W = 3;
+constexpr std::size_t RESULT_W = 80;
+// ob_pkg::accum_quantity_t; derived from the table depths.
+constexpr std::size_t ACCUM_W =
+    clog2(std::max(BID_TABLE_DEPTH_N, ASK_TABLE_DEPTH_N) *
+          (std::size_t{1} << QUANTITY_W));
+
+// ob_pkg::cmd_t
+struct Cmd {
+  enum : std::size_t { Uid, Opcode, Tif, Price, Quantity, Uid1, Price1, N };
+
+  static constexpr std::array<std::size_t, N> WS{
+    UID_W, OPCODE_W, TIF_W, PRICE_W, QUANTITY_W, UID_W, PRICE_W};
+
+  static constexpr std::array<Field, N> F = pack(WS);
+
+  static constexpr std::size_t W = width(WS);
+
+  static constexpr std::size_t BYTES = bytes(W);
+};
+
+// ob_pkg::rsp_t
+struct Rsp {
+  enum : std::size_t { TsAccept, TsEmit, Uid, Status, Result, N };
+
+  static constexpr std::array<std::size_t, N> WS{
+    TS_W, TS_W, UID_W, STATUS_W, RESULT_W};
+
+  static constexpr std::array<Field, N> F = pack(WS);
+
+  static constexpr std::size_t W = width(WS);
+
+  static constexpr std::size_t BYTES = bytes(W);
+
+  // Members of the result_t union; each spans the complete result.
+  static constexpr std::size_t R = F[Result].lsb;
+
+  // result_trade_t
+  struct Trade {
+    enum : std::size_t { BidUid, AskUid, Quantity, N };
+    static constexpr std::array<std::size_t, N> WS{UID_W, UID_W, QUANTITY_W};
+    static constexpr std::array<Field, N> F = pack(WS, R);
+  };
+
+  // result_qrybidask_t
+  struct QryBidAsk {
+    enum : std::size_t { Padding, Bid, Ask, N };
+    static constexpr std::array<std::size_t, N> WS{40, PRICE_W, PRICE_W};
+    static constexpr std::array<Field, N> F = pack(WS, R);
+  };
+
+  // result_poptop_t
+  struct PopTop {
+    enum : std::size_t { Padding, Price, Quantity, Uid, N };
+    static constexpr std::array<std::size_t, N> WS{
+      12, PRICE_W, QUANTITY_W, UID_W};
+    static constexpr std::array<Field, N> F = pack(WS, R);
+  };
+
+  // result_qry_t
+  struct Qry {
+    enum : std::size_t { Padding, Accum, N };
+    static constexpr std::array<std::size_t, N> WS{
+      RESULT_W - ACCUM_W, ACCUM_W};
+    static constexpr std::array<Field, N> F = pack(WS, R);
+  };
+
+  // result_depth_t
+  struct Depth {
+    enum : std::size_t { Padding, Last, Level, Price, Accum, N };
+    static constexpr std::array<std::size_t, N> WS{
+      RESULT_W - 37 - ACCUM_W, 1, QUANTITY_W, PRICE_W, ACCUM_W};
+    static constexpr std::array<Field, N> F = pack(WS, R);
+  };
+
+  // result_stats_t
+  struct Stats {
+    enum : std::size_t { Padding, Last, Id, Value, N };
+    static constexpr std::array<std::size_t, N> WS{
+      RESULT_W - 49, 1, STATS_ID_W, STATS_CNT_W};
+    static constexpr std::array<Field, N> F = pack(WS, R);
+  };
+
+  // result_snapshot_t
+  struct Snapshot {
+    enum : std::size_t { Padding, Last, Table, Ext, Price, Quantity, Uid, N };
+    static constexpr std::array<std::size_t, N> WS{
+      RESULT_W - 73, 1, SNAP_TABLE_W, 1, PRICE_W, QUANTITY_W, UID_W};
+    static constexpr std::array<Field, N> F = pack(WS, R);
+  };
+};
+
+// Union members are equally sized.
+static_assert(width(Rsp::Trade::WS) == RESULT_W);
+static_assert(width(Rsp::QryBidAsk::WS) == RESULT_W);
+static_assert(width(Rsp::PopTop::WS) == RESULT_W);
+static_assert(width(Rsp::Qry::WS) == RESULT_W);
+static_assert(width(Rsp::Depth::WS) == RESULT_W);
+static_assert(width(Rsp::Stats::WS) == RESULT_W);
+static_assert(width(Rsp::Snapshot::WS) == RESULT_W);
+// Record layout.
+static_assert(Cmd::F[Cmd::Uid].msb() == Cmd::W - 1);
+static_assert(Rsp::F[Rsp::TsAccept].msb() == Rsp::W - 1);
+static_assert(Rsp::Trade::F[Rsp::Trade::BidUid].msb() == Rsp::F[Rsp::Result].msb());
+
+// Extract field 'f' from the record at 'p'.
+inline std::uint64_t get(const std::byte* p, Field f) {
+  std::uint64_t v = 0;
+  for (std::size_t i = 0; i < f.w; ) {
+    const std::size_t bit = f.lsb + i;
+    const std::size_t off = bit % 8;
+    const std::size_t n = std::min<std::size_t>(8 - off, f.w - i);
+    const std::uint64_t b = std::to_integer<std::uint64_t>(p[bit / 8]) >> off;
+    v |= (b & ((std::uint64_t{1} << n) - 1)) << i;
+    i += n;
+  }
+  return v;
+}
+
+// Insert 'v' into field 'f' of the record at 'p'; bits of 'v' beyond the
+// field width are discarded.
+inline void set(std::byte* p, Field f, std::uint64_t v) {
+  for (std::size_t i = 0; i < f.w; ) {
+    const std::size_t bit = f.lsb + i;
+    const std::size_t off = bit % 8;
+    const std::size_t n = std::min<std::size_t>(8 - off, f.w - i);
+    const unsigned mask = ((1u << n) - 1) << off;
+    const unsigned b = static_cast<unsigned>((v >> i) << off) & mask;
+    p[bit / 8] = (p[bit / 8] & std::byte(~mask & 0xFF)) | std::byte(b);
+    i += n;
+  }
+}
+
+// Encode command into the (Cmd::BYTES) record at 'p'.
+inline void encode(const Command& cmd, std::byte* p) {
+  for (std::size_t i = 0; i < Cmd::BYTES; i++) p[i] = std::byte{0};
+  set(p, Cmd::F[Cmd::Uid], cmd.uid);
+  set(p, Cmd::F[Cmd::Opcode], cmd.opcode);
+  set(p, Cmd::F[Cmd::Tif], cmd.tif);
+  set(p, Cmd::F[Cmd::Price], cmd.price);
+  set(p, Cmd::F[Cmd::Quantity], cmd.quantity);
+  set(p, Cmd::F[Cmd::Uid1], cmd.uid1);
+  set(p, Cmd::F[Cmd::Price1], cmd.price1);
+}
+
+// Decode command from the record at 'p'.
+inline void decode(const std::byte* p, Command& cmd) {
+  cmd.valid = true;
+  cmd.uid = static_cast<vluint32_t>(get(p, Cmd::F[Cmd::Uid]));
+  cmd.opcode = static_cast<vluint8_t>(get(p, Cmd::F[Cmd::Opcode]));
+  cmd.tif = static_cast<vluint8_t>(get(p, Cmd::F[Cmd::Tif]));
+  cmd.price = static_cast<vluint32_t>(get(p, Cmd::F[Cmd::Price]));
+  cmd.quantity = static_cast<vluint16_t>(get(p, Cmd::F[Cmd::Quantity]));
+  cmd.uid1 = static_cast<vluint32_t>(get(p, Cmd::F[Cmd::Uid1]));
+  cmd.price1 = static_cast<vluint32_t>(get(p, Cmd::F[Cmd::Price1]));
+}
+
+// Encode response to a command of 'opcode' into the (Rsp::BYTES) record at
+// 'p'. The result union is rendered from the member associated with the
+// opcode (or from the trade member for trades).
+inline void encode(const Response& rsp, vluint8_t opcode, std::byte* p) {
+  using R = Rsp;
+  for (std::size_t i = 0; i < R::BYTES; i++) p[i] = std::byte{0};
+  set(p, R::F[R::TsAccept], rsp.ts_accept);
+  set(p, R::F[R::TsEmit], rsp.ts_emit);
+  set(p, R::F[R::Uid], rsp.uid);
+  set(p, R::F[R::Status], rsp.status);
+  if (rsp.is_trade()) opcode = Opcode::Nop;
+  switch (opcode) {
+    case Opcode::QryBidAsk: {
+      set(p, R::QryBidAsk::F[R::QryBidAsk::Bid], rsp.result.qrybidask.bid);
+      set(p, R::QryBidAsk::F[R::QryBidAsk::Ask], rsp.result.qrybidask.ask);
+    } break;
+    case Opcode::PopTopBid:
+    case Opcode::PopTopAsk: {
+      set(p, R::PopTop::F[R::PopTop::Price], rsp.result.poptop.price);
+      set(p, R::PopTop::F[R::PopTop::Quantity], rsp.result.poptop.quantity);
+      set(p, R::PopTop::F[R::PopTop::Uid], rsp.result.poptop.uid);
+    } break;
+    case Opcode::QryTblAskLe:
+    case Opcode::QryTblBidGe: {
+      set(p, R::Qry::F[R::Qry::Accum], rsp.result.qry.accum);
+    } break;
+    case Opcode::MassCancel: {
+      if (rsp.status == Status::CancelHit) {
+        set(p, R::PopTop::F[R::PopTop::Price], rsp.result.poptop.price);
+        set(p, R::PopTop::F[R::PopTop::Quantity], rsp.result.poptop.quantity);
+        set(p, R::PopTop::F[R::PopTop::Uid], rsp.result.poptop.uid);
+      } else {
+        set(p, R::Qry::F[R::Qry::Accum], rsp.result.qry.accum);
+      }
+    } break;
+    case Opcode::QryDepthBid:
+    case Opcode::QryDepthAsk: {
+      set(p, R::Depth::F[R::Depth::Last], rsp.result.depth.last);
+      set(p, R::Depth::F[R::Depth::Level], rsp.result.depth.level);
+      set(p, R::Depth::F[R::Depth::Price], rsp.result.depth.price);
+      set(p, R::Depth::F[R::Depth::Accum], rsp.result.depth.accum);
+    } break;
+    case Opcode::QryStats: {
+      set(p, R::Stats::F[R::Stats::Last], rsp.result.stats.last);
+      set(p, R::Stats::F[R::Stats::Id], rsp.result.stats.id);
+      set(p, R::Stats::F[R::Stats::Value], rsp.result.stats.value);
+    } break;
+    case Opcode::QrySnapshot: {
+      const auto& e = rsp.result.snapshot;
+      set(p, R::Snapshot::F[R::Snapshot::Last], e.last);
+      set(p, R::Snapshot::F[R::Snapshot::Table], e.table);
+      set(p, R::Snapshot::F[R::Snapshot::Ext], e.ext);
+      set(p, R::Snapshot::F[R::Snapshot::Price], e.price);
+      set(p, R::Snapshot::F[R::Snapshot::Quantity], e.quantity);
+      set(p, R::Snapshot::F[R::Snapshot::Uid], e.uid);
+    } break;
+    default: {
+      set(p, R::Trade::F[R::Trade::BidUid], rsp.result.trade.bid_uid);
+      set(p, R::Trade::F[R::Trade::AskUid], rsp.result.trade.ask_uid);
+      set(p, R::Trade::F[R::Trade::Quantity], rsp.result.trade.quantity);
+    } break;
+  }
+}
+
+// Encode a response sampled from the UUT (by VSignals::get/get_trade, or
+// wire::decode) into the record at 'p', where the originating opcode is not
+// known. The members of the result union of such a response are consistent
+// projections of the same result, therefore each is rendered in turn; bits
+// covered only by the union padding are zero.
+inline void encode(const Response& rsp, std::byte* p) {
+  using R = Rsp;
+  if (rsp.is_trade()) {
+    encode(rsp, Opcode::Nop, p);
+    return;
+  }
+  encode(rsp, Opcode::PopTopBid, p);
+  set(p, R::QryBidAsk::F[R::QryBidAsk::Bid], rsp.result.qrybidask.bid);
+  set(p, R::QryBidAsk::F[R::QryBidAsk::Ask], rsp.result.qrybidask.ask);
+  set(p, R::Depth::F[R::Depth::Last], rsp.result.depth.last);
+  set(p, R::Depth::F[R::Depth::Level], rsp.result.depth.level);
+  set(p, R::Depth::F[R::Depth::Price], rsp.result.depth.price);
+  set(p, R::Depth::F[R::Depth::Accum], rsp.result.depth.accum);
+  set(p, R::Stats::F[R::Stats::Last], rsp.result.stats.last);
+  set(p, R::Stats::F[R::Stats::Id], rsp.result.stats.id);
+  set(p, R::Stats::F[R::Stats::Value], rsp.result.stats.value);
+  set(p, R::Snapshot::F[R::Snapshot::Last], rsp.result.snapshot.last);
+  set(p, R::Snapshot::F[R::Snapshot::Table], rsp.result.snapshot.table);
+  set(p, R::Snapshot::F[R::Snapshot::Ext], rsp.result.snapshot.ext);
+  set(p, R::Qry::F[R::Qry::Accum], rsp.result.qry.accum);
+}
+
+// Decode response from the record at 'p'; as with VSignals::get, every
+// member of the result union is decoded.
+inline void decode(const std::byte* p, Response& rsp) {
+  using R = Rsp;
+  auto get32 = [&](Field f) { return static_cast<vluint32_t>(get(p, f)); };
+  auto get16 = [&](Field f) { return static_cast<vluint16_t>(get(p, f)); };
+  rsp.valid = true;
+  rsp.ts_accept = get32(R::F[R::TsAccept]);
+  rsp.ts_emit = get32(R::F[R::TsEmit]);
+  rsp.uid = get32(R::F[R::Uid]);
+  rsp.status = static_cast<vluint8_t>(get(p, R::F[R::Status]));
+  rsp.result.trade.bid_uid = get32(R::Trade::F[R::Trade::BidUid]);
+  rsp.result.trade.ask_uid = get32(R::Trade::F[R::Trade::AskUid]);
+  rsp.result.trade.quantity = get16(R::Trade::F[R::Trade::Quantity]);
+  rsp.result.qrybidask.bid = get32(R::QryBidAsk::F[R::QryBidAsk::Bid]);
+  rsp.result.qrybidask.ask = get32(R::QryBidAsk::F[R::QryBidAsk::Ask]);
+  rsp.result.poptop.price = get32(R::PopTop::F[R::PopTop::Price]);
+  rsp.result.poptop.quantity = get16(R::PopTop::F[R::PopTop::Quantity]);
+  rsp.result.poptop.uid = get32(R::PopTop::F[R::PopTop::Uid]);
+  rsp.result.qry.accum = get32(R::Qry::F[R::Qry::Accum]);
+  rsp.result.depth.last = (get(p, R::Depth::F[R::Depth::Last]) != 0);
+  rsp.result.depth.level = get16(R::Depth::F[R::Depth::Level]);
+  rsp.result.depth.price = get32(R::Depth::F[R::Depth::Price]);
+  rsp.result.depth.accum = get32(R::Depth::F[R::Depth::Accum]);
+  rsp.result.stats.last = (get(p, R::Stats::F[R::Stats::Last]) != 0);
+  rsp.result.stats.id = get16(R::Stats::F[R::Stats::Id]);
+  rsp.result.stats.value = get32(R::Stats::F[R::Stats::Value]);
+  rsp.result.snapshot.last = (get(p, R::Snapshot::F[R::Snapshot::Last]) != 0);
+  rsp.result.snapshot.table =
+      static_cast<vluint8_t>(get(p, R::Snapshot::F[R::Snapshot::Table]));
+  rsp.result.snapshot.ext = (get(p, R::Snapshot::F[R::Snapshot::Ext]) != 0);
+  rsp.result.snapshot.price = get32(R::Snapshot::F[R::Snapshot::Price]);
+  rsp.result.snapshot.quantity =
+      get16(R::Snapshot::F[R::Snapshot::Quantity]);
+  rsp.result.snapshot.uid = get32(R::Snapshot::F[R::Snapshot::Uid]);
+}
+
+// Contiguous batch of records, of layout 'L', within a caller-owned buffer
+// (for example, a DMA region). Records are encoded/decoded in place; the
+// batch itself owns no storage.
+template<typename L>
+class Batch {
+ public:
+  Batch(std::byte* p, std::size_t capacity) : p_(p), capacity_(capacity) {}
+
+  // Buffer address.
+  std::byte* data() const { return p_; }
+
+  // Number of records in batch.
+  std::size_t size() const { return n_; }
+
+  // Number of records which may be held by the buffer.
+  std::size_t capacity() const { return capacity_; }
+
+  // Number of valid bytes in the buffer.
+  std::size_t bytes() const { return n_ * L::BYTES; }
+
+  bool empty() const { return n_ == 0; }
+  bool full() const { return n_ == capacity_; }
+
+  // Record 'i' of the batch.
+  std::byte* operator[](std::size_t i) const { return p_ + i * L::BYTES; }
+
+  // Append a record; returns the address of the record to be encoded, or
+  // nullptr if the batch is full.
+  std::byte* append() { return full() ? nullptr : (*this)[n_++]; }
+
+  // Adopt 'n' records already present in the buffer.
+  void resize(std::size_t n) { n_ = std::min(n, capacity_); }
+
+  void clear() { n_ = 0; }
+
+ private:
+  std::byte* p_;
+  std::size_t capacity_;
+  std::size_t n_ = 0;
+};
+
+using CmdBatch = Batch<Cmd>;
+using RspBatch = Batch<Rsp>;
+
+// Encode commands [first, last) into 'b'; returns the number encoded (which
+// is less than requested should the batch become full).
+template<typename FwdIt>
+std::size_t encode(FwdIt first, FwdIt last, CmdBatch& b) {
+  std::size_t n = 0;
+  for (; first != last; ++first, ++n) {
+    std::byte* p = b.append();
+    if (p == nullptr) break;
+    encode(*first, p);
+  }
+  return n;
+}
+
+// Push the commands of batch 'b' to 'tb', in order.
+inline void push_back(TB& tb, const CmdBatch& b) {
+  for (std::size_t i = 0; i < b.size(); i++) {
+    Command cmd;
+    decode(b[i], cmd);
+    tb.push_back(cmd);
+  }
+}
+
+} // namespace tb::wire
+
+#endif